@@ -1117,6 +1117,10 @@ macro(process_options)
       add_definitions(-DNS3_MPI)
       include_directories(${MPI_CXX_INCLUDE_DIRS})
       set(ENABLE_MPI TRUE)
+      # Let HybridSimulatorImpl run several threads per rank
+      if(${NS3_MPI_THREADS})
+        add_definitions(-DNS3_MPI_THREADS)
+      endif()
     endif()
   endif()
 
@@ -1417,6 +1421,11 @@ macro(process_options)
   if(${NS3_ASSERT} OR (${build_profile} STREQUAL "debug"))
     add_definitions(-DNS3_ASSERT_ENABLE)
   endif()
+  # Compile out the trace sources of the packet fast paths if requested,
+  # except in debug builds
+  if((NOT ${NS3_TRACE_SOURCES}) AND (NOT (${build_profile} STREQUAL "debug")))
+    add_definitions(-DNS3_TRACE_SOURCES_DISABLE)
+  endif()
 
   set(ENABLE_TAP OFF)
   if(${NS3_TAP})
@@ -28,6 +28,7 @@
 #include "ns3/netanim-module.h"
 #include "ns3/network-module.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/partition-helper.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/point-to-point-module.h"
 
@@ -58,8 +59,16 @@ class PointToPointFatTreeHelper
      * \param pointToPoint the PointToPointHelper which is used
      *                     to connect all of the nodes together
      *                     in the Fat tree
+     *
+     * \param partition if not null, assign the nodes to ranks with this
+     *                  partitioner instead of by stride
+     *
+     * \param linkDelay the delay of the links, used by the partitioner
      */
-    PointToPointFatTreeHelper(uint32_t numPods, PointToPointHelper pointToPoint);
+    PointToPointFatTreeHelper(uint32_t numPods,
+                              PointToPointHelper pointToPoint,
+                              PartitionHelper* partition = nullptr,
+                              Time linkDelay = Seconds(0));
 
     ~PointToPointFatTreeHelper();
 
@@ -253,6 +262,15 @@ class PointToPointFatTreeHelper
 
   private:
     void DistributedNodeCreateHelper(NodeContainer& con, uint32_t numNodes);
+    /**
+     * Connect the servers and switches, or only declare the links to the
+     * partitioner when it is given.
+     *
+     * \param p2pHelper the PointToPointHelper used to install the links
+     * \param partition the partitioner to declare the links to, or null
+     * \param linkDelay the delay of the links
+     */
+    void ConnectNodes(PointToPointHelper& p2pHelper, PartitionHelper* partition, Time linkDelay);
     uint32_t m_numPods; //!< Number of pods
     std::vector<NetDeviceContainer>
         m_edgeSwitchDevices; //!< Net Device container for edge switches and servers
@@ -275,7 +293,10 @@ class PointToPointFatTreeHelper
     uint32_t numServers;
 };
 
-PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t numPods, PointToPointHelper p2pHelper)
+PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t numPods,
+                                                     PointToPointHelper p2pHelper,
+                                                     PartitionHelper* partition,
+                                                     Time linkDelay)
     : m_numPods(numPods)
 {
     // Bounds check
@@ -306,13 +327,48 @@ PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t numPods, PointToPo
     uint32_t numAggregatesTotal = numAggregateSwitches * numPods;
     uint32_t numCoreSTotal = numCoreSwitches * numGroups;
 
-    DistributedNodeCreateHelper(m_servers, numServersTotal);
-    DistributedNodeCreateHelper(m_edgeSwitches, numEdgesTotal);
-    DistributedNodeCreateHelper(m_aggregateSwitches, numAggregatesTotal);
-    DistributedNodeCreateHelper(m_coreSwitches, numCoreSTotal);
+    if (partition)
+    {
+        // The system ids have to be assigned before the links are installed
+        m_servers.Create(numServersTotal);
+        m_edgeSwitches.Create(numEdgesTotal);
+        m_aggregateSwitches.Create(numAggregatesTotal);
+        m_coreSwitches.Create(numCoreSTotal);
+        ConnectNodes(p2pHelper, partition, linkDelay);
+        partition->Assign();
+    }
+    else
+    {
+        DistributedNodeCreateHelper(m_servers, numServersTotal);
+        DistributedNodeCreateHelper(m_edgeSwitches, numEdgesTotal);
+        DistributedNodeCreateHelper(m_aggregateSwitches, numAggregatesTotal);
+        DistributedNodeCreateHelper(m_coreSwitches, numCoreSTotal);
+    }
+
+    ConnectNodes(p2pHelper, nullptr, linkDelay);
+}
 
-    InternetStackHelper stack;
-    
+void
+PointToPointFatTreeHelper::ConnectNodes(PointToPointHelper& p2pHelper,
+                                        PartitionHelper* partition,
+                                        Time linkDelay)
+{
+    uint32_t numPods = m_numPods;
+    uint32_t numEdgeSwitches = numPods / 2;
+    uint32_t numAggregateSwitches = numPods / 2;
+    uint32_t numGroups = numPods / 2;
+    uint32_t numCoreSwitches = numPods / 2;
+
+    auto connect = [&](Ptr<Node> a, Ptr<Node> b, NetDeviceContainer& devices) {
+        if (partition)
+        {
+            partition->AddLink(a, b, linkDelay);
+            return;
+        }
+        NetDeviceContainer nd = p2pHelper.Install(a, b);
+        devices.Add(nd.Get(0));
+        devices.Add(nd.Get(1));
+    };
 
     // Connect servers to edge switches
     uint32_t hostId = 0;
@@ -320,9 +376,7 @@ PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t numPods, PointToPo
     {
         for (uint32_t j = 0; j < numEdgeSwitches; j++)
         {
-            NetDeviceContainer nd = p2pHelper.Install(m_servers.Get(hostId), m_edgeSwitches.Get(i));
-            m_edgeSwitchDevices[i].Add(nd.Get(0));
-            m_edgeSwitchDevices[i].Add(nd.Get(1));
+            connect(m_servers.Get(hostId), m_edgeSwitches.Get(i), m_edgeSwitchDevices[i]);
             hostId += 1;
         }
     }
@@ -334,11 +388,9 @@ PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t numPods, PointToPo
         {
             for (uint32_t k = 0; k < numEdgeSwitches; k++)
             {
-                NetDeviceContainer nd =
-                    p2pHelper.Install(m_edgeSwitches.Get(i * numEdgeSwitches + k),
-                                      m_aggregateSwitches.Get(i * numAggregateSwitches + j));
-                m_aggregateSwitchDevices[i * numAggregateSwitches + j].Add(nd.Get(0));
-                m_aggregateSwitchDevices[i * numAggregateSwitches + j].Add(nd.Get(1));
+                connect(m_edgeSwitches.Get(i * numEdgeSwitches + k),
+                        m_aggregateSwitches.Get(i * numAggregateSwitches + j),
+                        m_aggregateSwitchDevices[i * numAggregateSwitches + j]);
             }
         }
     }
@@ -350,11 +402,9 @@ PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t numPods, PointToPo
         {
             for (uint32_t k = 0; k < numPods; k++)
             {
-                NetDeviceContainer nd =
-                    p2pHelper.Install(m_aggregateSwitches.Get(k * numAggregateSwitches + i),
-                                      m_coreSwitches.Get(i * numCoreSwitches + j));
-                m_coreSwitchDevices[i * numCoreSwitches + j].Add(nd.Get(0));
-                m_coreSwitchDevices[i * numCoreSwitches + j].Add(nd.Get(1));
+                connect(m_aggregateSwitches.Get(k * numAggregateSwitches + i),
+                        m_coreSwitches.Get(i * numCoreSwitches + j),
+                        m_coreSwitchDevices[i * numCoreSwitches + j]);
             }
         }
     }
@@ -719,28 +769,62 @@ main(int argc, char* argv[])
     uint32_t nPods = 4;
     std::string animFile = "fat-tree-animation.xml"; // Name of file for animation output
     bool nullmsg = false;
+    bool aggregate = false;
+    bool neighbor = false;
+    bool partition = false;
+    bool ghost = false;
+    std::string profileFile;
+    std::string nodeCostFile;
+    std::string telemetryFile;
 
     CommandLine cmd;
     cmd.AddValue("nPods", "Number of pods", nPods);
     cmd.AddValue("animFile", "File Name for Animation Output", animFile);
     cmd.AddValue("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+    cmd.AddValue("aggregate", "Aggregate packets sent to a remote rank in each window", aggregate);
+    cmd.AddValue("neighbor", "Use the per rank lookahead to grant time windows", neighbor);
+    cmd.AddValue("partition", "Assign the nodes to ranks by partitioning the topology", partition);
+    cmd.AddValue("ghost", "Make the nodes of the other ranks lightweight ghost nodes", ghost);
+    cmd.AddValue("profile", "Write the cost of each node to this file", profileFile);
+    cmd.AddValue("nodeCosts", "Weight the partition by the node costs in this file", nodeCostFile);
+    cmd.AddValue("telemetry",
+                 "Write the synchronization counters to <telemetry>-<rank>.csv",
+                 telemetryFile);
     cmd.Parse(argc, argv);
 
+    if (!nodeCostFile.empty() && !partition)
+    {
+        NS_FATAL_ERROR("--nodeCosts only weights the partition; use it with --partition.");
+    }
+
     if (nullmsg)
     {
         GlobalValue::Bind("SimulatorImplementationType",
                           StringValue("ns3::NullMessageSimulatorImpl"));
+        Config::SetDefault("ns3::NullMessageSimulatorImpl::NodeCostFile",
+                           StringValue(profileFile));
+        Config::SetDefault("ns3::NullMessageSimulatorImpl::TelemetryFile",
+                           StringValue(telemetryFile));
     }
     else
     {
         GlobalValue::Bind("SimulatorImplementationType",
                           StringValue("ns3::DistributedSimulatorImpl"));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::AggregatePackets",
+                           BooleanValue(aggregate));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::NeighborLookahead",
+                           BooleanValue(neighbor));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::NodeCostFile",
+                           StringValue(profileFile));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::TelemetryFile",
+                           StringValue(telemetryFile));
     }
 
+    GlobalValue::Bind("GhostNodes", BooleanValue(ghost));
+
     MpiInterface::Enable(&argc, &argv);
 
     uint32_t systemId = MpiInterface::GetSystemId();
-    uint32_t systemCount = MpiInterface::GetSize();
 
     InternetStackHelper internet;
     Ipv4NixVectorHelper nixRouting;
@@ -750,13 +834,32 @@ main(int argc, char* argv[])
     list.Add(staticRouting, 0);
     list.Add(nixRouting, 10);
     internet.SetRoutingHelper(list);
+    if (ghost)
+    {
+        // The servers only use IPv4, and IPv6 would need the full stack on the ghost nodes
+        internet.SetIpv6StackInstall(false);
+    }
 
     // Create the point-to-point link helpers
     PointToPointHelper pointToPointRouter;
     pointToPointRouter.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
-    pointToPointRouter.SetChannelAttribute("Delay", StringValue("1ms"));
+    Time linkDelay = MilliSeconds(1);
+    pointToPointRouter.SetChannelAttribute("Delay", TimeValue(linkDelay));
 
-    PointToPointFatTreeHelper d(nPods, pointToPointRouter);
+    PartitionHelper partitionHelper;
+    if (!nodeCostFile.empty())
+    {
+        partitionHelper.LoadNodeCosts(nodeCostFile);
+    }
+    PointToPointFatTreeHelper d(nPods,
+                                pointToPointRouter,
+                                partition ? &partitionHelper : nullptr,
+                                linkDelay);
+    if (partition && systemId == 0)
+    {
+        std::cout << "Partition cut " << partitionHelper.GetCutSize() << " links, lookahead "
+                  << partitionHelper.GetLookAhead().As(Time::MS) << std::endl;
+    }
     // Install Stack
     d.InstallStack(internet);
 
@@ -765,34 +868,24 @@ main(int argc, char* argv[])
     uint32_t numServers = d.GetNumServers();
     NodeContainer servers = d.GetMServers();
 
-    uint32_t serversMpiStride = numServers / systemCount;
-
-    for (uint32_t potentialSystemId = 0; potentialSystemId < systemCount; potentialSystemId++)
+    // Each server saggregateEnds a packet to all other servers
+    UdpEchoServerHelper echoServer(9);
+    ApplicationContainer serverApps;
+    for (uint32_t serverIdx = 0; serverIdx < numServers; serverIdx++)
     {
-        // Each server saggregateEnds a packet to all other servers
-        if (potentialSystemId == systemId)
+        if (servers.Get(serverIdx)->GetSystemId() == systemId)
         {
-            UdpEchoServerHelper echoServer(9);
-            ApplicationContainer serverApps;
-
-            uint32_t start = systemId * serversMpiStride;
-            uint32_t serverEnd = start + serversMpiStride;
-            for (uint32_t serverIdx = start; serverIdx < serverEnd; serverIdx++)
-            {
-                serverApps.Add(echoServer.Install(servers.Get(serverIdx)));
-            }
-            serverApps.Start(Seconds(1.0));
-            serverApps.Stop(Seconds(10.0));
+            serverApps.Add(echoServer.Install(servers.Get(serverIdx)));
         }
     }
+    serverApps.Start(Seconds(1.0));
+    serverApps.Stop(Seconds(10.0));
 
     // std::cout << "numServers: " << numServers << std::endl;
     // uint32_t packetNumber = 0;
     for (uint32_t saggregateEnder = 0; saggregateEnder < numServers; saggregateEnder++)
     {
-        uint32_t lower = systemId * serversMpiStride;
-        uint32_t upper = lower + serversMpiStride;
-        if (saggregateEnder < lower || saggregateEnder >= upper)
+        if (servers.Get(saggregateEnder)->GetSystemId() != systemId)
             continue;
         for (uint32_t receiver = 0; receiver < numServers; receiver++)
         {
@@ -283,6 +283,33 @@ CalendarScheduler::Remove(const Event& ev)
     NS_ASSERT(false);
 }
 
+std::vector<Scheduler::Event>
+CalendarScheduler::DoCompact()
+{
+    NS_LOG_FUNCTION(this);
+    // Filter the buckets in place: draining them with RemoveNext would
+    // move the current bucket past the live events inserted again.
+    std::vector<Event> removed;
+    for (uint32_t bucket = 0; bucket < m_nBuckets; bucket++)
+    {
+        for (auto i = m_buckets[bucket].begin(); i != m_buckets[bucket].end();)
+        {
+            if (i->impl->IsCancelled())
+            {
+                removed.push_back(*i);
+                i = m_buckets[bucket].erase(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+    m_qSize -= removed.size();
+    ResizeDown();
+    return removed;
+}
+
 void
 CalendarScheduler::ResizeUp()
 {
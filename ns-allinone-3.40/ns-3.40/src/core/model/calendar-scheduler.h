@@ -112,6 +112,9 @@ class CalendarScheduler : public Scheduler
     void Remove(const Scheduler::Event& ev) override;
 
   private:
+    // Inherited
+    std::vector<Scheduler::Event> DoCompact() override;
+
     /** Double the number of buckets if necessary. */
     void ResizeUp();
     /** Halve the number of buckets if necessary. */
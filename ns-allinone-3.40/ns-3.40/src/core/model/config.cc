@@ -26,6 +26,7 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <map>
 #include <sstream>
 
 /**
@@ -214,8 +215,21 @@ class ArrayMatcher
      * \returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * Get the index if the Config Path specifies a single one.
+     *
+     * \param [out] index The index.
+     * \returns \c true if the Config Path specifies a single index.
+     */
+    bool GetIndex(std::size_t* index) const;
 
   private:
+    /**
+     * Test if the Config path specification is a range of indices.
+     *
+     * \returns \c true if the Config Path is a range.
+     */
+    bool IsRange() const;
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -265,12 +279,11 @@ ArrayMatcher::Matches(std::size_t i) const
         NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
         return false;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
-        dash < rightBracket)
+    if (IsRange())
     {
+        std::string::size_type leftBracket = m_element.find('[');
+        std::string::size_type rightBracket = m_element.find(']');
+        std::string::size_type dash = m_element.find('-');
         std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
         std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
         uint32_t min;
@@ -297,6 +310,31 @@ ArrayMatcher::Matches(std::size_t i) const
     return false;
 }
 
+bool
+ArrayMatcher::GetIndex(std::size_t* index) const
+{
+    NS_LOG_FUNCTION(this << index);
+    uint32_t value;
+    if (m_element == "*" || m_element.find('|') != std::string::npos || IsRange() ||
+        !StringToUint32(m_element, &value))
+    {
+        return false;
+    }
+    *index = value;
+    return true;
+}
+
+bool
+ArrayMatcher::IsRange() const
+{
+    NS_LOG_FUNCTION(this);
+    std::string::size_type leftBracket = m_element.find('[');
+    std::string::size_type rightBracket = m_element.find(']');
+    std::string::size_type dash = m_element.find('-');
+    return leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
+           dash < rightBracket;
+}
+
 bool
 ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 {
@@ -310,6 +348,9 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The paths are kept as a tree of their elements, so that the objects
+ * matching the elements several paths begin with are only looked up once.
  */
 class Resolver
 {
@@ -320,11 +361,17 @@ class Resolver
      * \param [in] path The Config path.
      */
     Resolver(std::string path);
+    /**
+     * Construct from several base Config paths.
+     *
+     * \param [in] paths The Config paths.
+     */
+    Resolver(const std::vector<std::string>& paths);
     /** Destructor. */
     virtual ~Resolver();
 
     /**
-     * Parse the stored Config path into an object reference,
+     * Parse the stored Config paths into object references,
      * beginning at the indicated root object.
      *
      * \param [in] root The object corresponding to the current position in
@@ -333,29 +380,60 @@ class Resolver
     void Resolve(Ptr<Object> root);
 
   private:
-    /** Ensure the Config path starts and ends with a '/'. */
-    void Canonicalize();
+    /** An element of the Config paths, and the elements following it. */
+    struct PathNode
+    {
+        /** The elements following this one, and their node. */
+        std::map<std::string, std::size_t> children;
+        /** The indices of the Config paths ending with this element. */
+        std::vector<std::size_t> ends;
+    };
+
+    /**
+     * Ensure the Config path starts and ends with a '/'.
+     *
+     * \param [in] path The Config path.
+     * \returns The canonical Config path.
+     */
+    std::string Canonicalize(std::string path) const;
     /**
-     * Parse the next element in the Config path.
+     * Add a Config path to the tree of the path elements.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] path The Config path.
+     * \param [in] i The index of the Config path.
+     */
+    void AddPath(std::string path, std::size_t i);
+    /**
+     * Parse the next elements of the Config paths.
+     *
+     * \param [in] node The last element parsed.
      * \param [in] root The object corresponding to the current position
-     *                  in the Config path.
+     *                  in the Config paths.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t node, Ptr<Object> root);
     /**
-     * Parse an index on the Config path.
+     * Parse an attribute element of the Config paths.
      *
-     * \param [in] path The remaining Config path.
-     * \param [in,out] vector The resulting list of matching objects.
+     * \param [in] item The attribute name, or "*".
+     * \param [in] node The attribute element.
+     * \param [in] root The object holding the attribute.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoAttributeResolve(const std::string& item, std::size_t node, Ptr<Object> root);
     /**
-     * Handle one object found on the path.
+     * Parse the indices following an object container on the Config paths.
      *
-     * \param [in] object The current object on the Config path.
+     * \param [in] node The element naming the container.
+     * \param [in] root The object holding the container.
+     * \param [in] name The name of the container attribute.
      */
-    void DoResolveOne(Ptr<Object> object);
+    void DoArrayResolve(std::size_t node, Ptr<Object> root, std::string name);
+    /**
+     * Handle one object found on the paths.
+     *
+     * \param [in] node The element of the Config paths matching the object.
+     * \param [in] object The current object on the Config paths.
+     */
+    void DoResolveOne(std::size_t node, Ptr<Object> object);
     /**
      * Get the current Config path.
      *
@@ -367,21 +445,32 @@ class Resolver
      *
      * \param [in] object The found object.
      * \param [in] path The matching Config path context.
+     * \param [in] i The index of the Config path matching the object.
      */
-    virtual void DoOne(Ptr<Object> object, std::string path) = 0;
+    virtual void DoOne(Ptr<Object> object, std::string path, std::size_t i) = 0;
 
     /** Current list of path tokens. */
     std::vector<std::string> m_workStack;
-    /** The Config path. */
-    std::string m_path;
+    /** The Config path elements, beginning with the root. */
+    std::vector<PathNode> m_nodes;
 
 }; // class Resolver
 
 Resolver::Resolver(std::string path)
-    : m_path(path)
+    : m_nodes(1)
 {
     NS_LOG_FUNCTION(this << path);
-    Canonicalize();
+    AddPath(path, 0);
+}
+
+Resolver::Resolver(const std::vector<std::string>& paths)
+    : m_nodes(1)
+{
+    NS_LOG_FUNCTION(this << paths.size());
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        AddPath(paths[i], i);
+    }
 }
 
 Resolver::~Resolver()
@@ -389,24 +478,50 @@ Resolver::~Resolver()
     NS_LOG_FUNCTION(this);
 }
 
-void
-Resolver::Canonicalize()
+std::string
+Resolver::Canonicalize(std::string path) const
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << path);
 
     // ensure that we start and end with a '/'
-    std::string::size_type tmp = m_path.find('/');
+    std::string::size_type tmp = path.find('/');
     if (tmp != 0)
     {
         // no slash at start
-        m_path = "/" + m_path;
+        path = "/" + path;
     }
-    tmp = m_path.find_last_of('/');
-    if (tmp != (m_path.size() - 1))
+    tmp = path.find_last_of('/');
+    if (tmp != (path.size() - 1))
     {
         // no slash at end
-        m_path = m_path + "/";
+        path = path + "/";
+    }
+    return path;
+}
+
+void
+Resolver::AddPath(std::string path, std::size_t i)
+{
+    NS_LOG_FUNCTION(this << path << i);
+
+    path = Canonicalize(path);
+    std::size_t node = 0;
+    std::string::size_type cur = 0;
+    std::string::size_type next = path.find('/', 1);
+    while (next != std::string::npos)
+    {
+        std::string item = path.substr(cur + 1, next - (cur + 1));
+        auto child = m_nodes[node].children.find(item);
+        if (child == m_nodes[node].children.end())
+        {
+            child = m_nodes[node].children.emplace(item, m_nodes.size()).first;
+            m_nodes.emplace_back();
+        }
+        node = child->second;
+        cur = next;
+        next = path.find('/', cur + 1);
     }
+    m_nodes[node].ends.push_back(i);
 }
 
 void
@@ -414,7 +529,7 @@ Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
@@ -431,22 +546,24 @@ Resolver::GetResolvedPath() const
 }
 
 void
-Resolver::DoResolveOne(Ptr<Object> object)
+Resolver::DoResolveOne(std::size_t node, Ptr<Object> object)
 {
-    NS_LOG_FUNCTION(this << object);
+    NS_LOG_FUNCTION(this << node << object);
 
-    NS_LOG_DEBUG("resolved=" << GetResolvedPath());
-    DoOne(object, GetResolvedPath());
+    std::string resolved = GetResolvedPath();
+    NS_LOG_DEBUG("resolved=" << resolved);
+    for (auto i : m_nodes[node].ends)
+    {
+        DoOne(object, resolved, i);
+    }
 }
 
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t node, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << node << root);
 
-    if (next == std::string::npos)
+    if (!m_nodes[node].ends.empty())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -458,177 +575,199 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         //
         if (root)
         {
-            DoResolveOne(root);
+            DoResolveOne(node, root);
         }
-        return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
 
-    //
-    // If root is zero, we're beginning to see if we can use the object name
-    // service to resolve this path.  In this case, we must see the name space
-    // "/Names" on the front of this path.  There is no object associated with
-    // the root of the "/Names" namespace, so we just ignore it and move on to
-    // the next segment.
-    //
-    if (!root)
+    for (const auto& [item, child] : m_nodes[node].children)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
+        //
+        // If root is zero, we're beginning to see if we can use the object name
+        // service to resolve this path.  In this case, we must see the name space
+        // "/Names" on the front of this path.  There is no object associated with
+        // the root of the "/Names" namespace, so we just ignore it and move on to
+        // the next segment.
+        //
+        if (!root && item.find("Names") == 0)
         {
             m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
+            DoResolve(child, root);
             m_workStack.pop_back();
-            return;
+            continue;
         }
-    }
 
-    //
-    // We have an item (possibly a segment of a namespace path.  Check to see if
-    // we can determine that this segment refers to a named object.  If root is
-    // zero, this means to look in the root of the "/Names" name space, otherwise
-    // it refers to a name space context (level).
-    //
-    Ptr<Object> namedObject = Names::Find<Object>(root, item);
-    if (namedObject)
-    {
-        NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
-        m_workStack.pop_back();
-        return;
-    }
+        //
+        // We have an item (possibly a segment of a namespace path.  Check to see if
+        // we can determine that this segment refers to a named object.  If root is
+        // zero, this means to look in the root of the "/Names" name space, otherwise
+        // it refers to a name space context (level).
+        //
+        Ptr<Object> namedObject = Names::Find<Object>(root, item);
+        if (namedObject)
+        {
+            NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
+            m_workStack.push_back(item);
+            DoResolve(child, namedObject);
+            m_workStack.pop_back();
+            continue;
+        }
 
-    //
-    // We're done with the object name service hooks, so proceed down the path
-    // of types and attributes; but only if root is nonzero.  If root is zero
-    // and we find ourselves here, we are trying to check in the namespace for
-    // a path that is not in the "/Names" namespace.  We will have previously
-    // found any matches, so we just bail out.
-    //
-    if (!root)
-    {
-        return;
-    }
-    std::string::size_type dollarPos = item.find('$');
-    if (dollarPos == 0)
-    {
-        // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
-        Ptr<Object> object = root->GetObject<Object>(tid);
-        if (!object)
+        //
+        // We're done with the object name service hooks, so proceed down the path
+        // of types and attributes; but only if root is nonzero.  If root is zero
+        // and we find ourselves here, we are trying to check in the namespace for
+        // a path that is not in the "/Names" namespace.  We will have previously
+        // found any matches, so we just bail out.
+        //
+        if (!root)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
-            return;
+            continue;
+        }
+        std::string::size_type dollarPos = item.find('$');
+        if (dollarPos == 0)
+        {
+            // This is a call to GetObject
+            std::string tidString = item.substr(1, item.size() - 1);
+            NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
+            TypeId tid = TypeId::LookupByName(tidString);
+            Ptr<Object> object = root->GetObject<Object>(tid);
+            if (!object)
+            {
+                NS_LOG_DEBUG("GetObject (" << tidString
+                                           << ") failed on path=" << GetResolvedPath());
+                continue;
+            }
+            m_workStack.push_back(item);
+            DoResolve(child, object);
+            m_workStack.pop_back();
+        }
+        else
+        {
+            DoAttributeResolve(item, child, root);
         }
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
-        m_workStack.pop_back();
     }
-    else
+}
+
+void
+Resolver::DoAttributeResolve(const std::string& item, std::size_t node, Ptr<Object> root)
+{
+    NS_LOG_FUNCTION(this << item << node << root);
+
+    // this is a normal attribute.
+    TypeId tid;
+    TypeId nextTid = root->GetInstanceTypeId();
+    bool foundMatch = false;
+
+    do
     {
-        // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
-        bool foundMatch = false;
+        tid = nextTid;
 
-        do
+        for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+            TypeId::AttributeInformation info;
+            info = tid.GetAttribute(i);
+            if (info.name != item && item != "*")
+            {
+                continue;
+            }
+            // attempt to cast to a pointer checker.
+            const auto pChecker = dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
+            if (pChecker != nullptr)
             {
-                TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                root->GetAttribute(info.name, pValue);
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
+                    NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
                     continue;
                 }
-                // attempt to cast to a pointer checker.
-                const auto pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const auto vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                foundMatch = true;
+                m_workStack.push_back(info.name);
+                DoResolve(node, object);
+                m_workStack.pop_back();
+            }
+            // attempt to cast to an object vector.
+            const auto vectorChecker =
+                dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
+            if (vectorChecker != nullptr)
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << info.name
+                                                     << " on path=" << GetResolvedPath());
+                foundMatch = true;
+                m_workStack.push_back(info.name);
+                DoArrayResolve(node, root, info.name);
+                m_workStack.pop_back();
             }
+            // this could be anything else and we don't know what to do with it.
+            // So, we just ignore it.
+        }
 
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
+        nextTid = tid.GetParent();
+    } while (nextTid != tid);
 
-        if (!foundMatch)
-        {
-            NS_LOG_DEBUG("Requested item=" << item
-                                           << " does not exist on path=" << GetResolvedPath());
-            return;
-        }
+    if (!foundMatch)
+    {
+        NS_LOG_DEBUG("Requested item=" << item << " does not exist on path=" << GetResolvedPath());
     }
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t node, Ptr<Object> root, std::string name)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << node << root << name);
+
+    // The accessor root->GetAttribute () would use
+    TypeId::AttributeInformation info;
+    root->GetInstanceTypeId().LookupAttributeByName(name, &info);
+    const ObjectPtrContainerAccessor* accessor = nullptr;
+    if (info.flags & TypeId::ATTR_GET)
     {
-        return;
+        accessor = dynamic_cast<const ObjectPtrContainerAccessor*>(PeekPointer(info.accessor));
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    ObjectPtrContainerValue container;
+    bool haveContainer = false;
 
-    ArrayMatcher matcher = ArrayMatcher(item);
-    ObjectPtrContainerValue::Iterator it;
-    for (it = container.Begin(); it != container.End(); ++it)
+    for (const auto& [item, child] : m_nodes[node].children)
     {
-        if (matcher.Matches((*it).first))
+        ArrayMatcher matcher = ArrayMatcher(item);
+        std::size_t index;
+        if (accessor != nullptr && matcher.GetIndex(&index))
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
-            m_workStack.pop_back();
+            // Only fetch the object with this index
+            Ptr<Object> object;
+            if (accessor->GetByIndex(PeekPointer(root), index, &object))
+            {
+                m_workStack.push_back(std::to_string(index));
+                DoResolve(child, object);
+                m_workStack.pop_back();
+            }
+            continue;
+        }
+        if (!haveContainer)
+        {
+            root->GetAttribute(name, container);
+            haveContainer = true;
+        }
+        for (auto it = container.Begin(); it != container.End(); ++it)
+        {
+            if (matcher.Matches((*it).first))
+            {
+                std::ostringstream oss;
+                oss << (*it).first;
+                m_workStack.push_back(oss.str());
+                DoResolve(child, (*it).second);
+                m_workStack.pop_back();
+            }
         }
     }
 }
 
+
 /**
  * \ingroup config-impl
  * Config system implementation class.
@@ -652,6 +791,14 @@ class ConfigImpl : public Singleton<ConfigImpl>
     void Disconnect(std::string path, const CallbackBase& cb);
     /** \copydoc ns3::Config::LookupMatches() */
     MatchContainer LookupMatches(std::string path);
+    /** \copydoc ns3::Config::LookupMatchesBatch() */
+    std::vector<MatchContainer> LookupMatchesBatch(const std::vector<std::string>& paths);
+    /** \copydoc ns3::Config::SetBatch() */
+    void SetBatch(const std::vector<std::string>& paths, const AttributeValue& value);
+    /** \copydoc ns3::Config::ConnectBatch() */
+    void ConnectBatch(const std::vector<std::string>& paths, const CallbackBase& cb);
+    /** \copydoc ns3::Config::ConnectWithoutContextBatch() */
+    void ConnectWithoutContextBatch(const std::vector<std::string>& paths, const CallbackBase& cb);
 
     /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
     void RegisterRootNamespaceObject(Ptr<Object> obj);
@@ -672,6 +819,15 @@ class ConfigImpl : public Singleton<ConfigImpl>
      * \param [in,out] leaf The trailing part of the \pname{path}.
      */
     void ParsePath(std::string path, std::string* root, std::string* leaf) const;
+    /**
+     * Break Config paths into the leading paths and the last leaf tokens,
+     * and match the leading paths.
+     * \param [in] paths The Config paths.
+     * \param [out] leaves The trailing parts of the \pname{paths}.
+     * \returns The objects matching the leading part of each path.
+     */
+    std::vector<MatchContainer> LookupRootMatches(const std::vector<std::string>& paths,
+                                                  std::vector<std::string>* leaves);
 
     /** Container type to hold the root Config path tokens. */
     typedef std::vector<Ptr<Object>> Roots;
@@ -782,23 +938,33 @@ ConfigImpl::LookupMatches(std::string path)
 {
     NS_LOG_FUNCTION(this << path);
 
+    return LookupMatchesBatch(std::vector<std::string>{path})[0];
+}
+
+std::vector<MatchContainer>
+ConfigImpl::LookupMatchesBatch(const std::vector<std::string>& paths)
+{
+    NS_LOG_FUNCTION(this << paths.size());
+
     class LookupMatchesResolver : public Resolver
     {
       public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
+        LookupMatchesResolver(const std::vector<std::string>& paths)
+            : Resolver(paths),
+              m_objects(paths.size()),
+              m_contexts(paths.size())
         {
         }
 
-        void DoOne(Ptr<Object> object, std::string path) override
+        void DoOne(Ptr<Object> object, std::string path, std::size_t i) override
         {
-            m_objects.push_back(object);
-            m_contexts.push_back(path);
+            m_objects[i].push_back(object);
+            m_contexts[i].push_back(path);
         }
 
-        std::vector<Ptr<Object>> m_objects;
-        std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+        std::vector<std::vector<Ptr<Object>>> m_objects;
+        std::vector<std::vector<std::string>> m_contexts;
+    } resolver = LookupMatchesResolver(paths);
 
     for (auto i = m_roots.begin(); i != m_roots.end(); i++)
     {
@@ -812,7 +978,74 @@ ConfigImpl::LookupMatches(std::string path)
     //
     resolver.Resolve(nullptr);
 
-    return MatchContainer(resolver.m_objects, resolver.m_contexts, path);
+    std::vector<MatchContainer> containers;
+    containers.reserve(paths.size());
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        containers.emplace_back(resolver.m_objects[i], resolver.m_contexts[i], paths[i]);
+    }
+    return containers;
+}
+
+std::vector<MatchContainer>
+ConfigImpl::LookupRootMatches(const std::vector<std::string>& paths,
+                              std::vector<std::string>* leaves)
+{
+    NS_LOG_FUNCTION(this << paths.size() << leaves);
+
+    std::vector<std::string> roots(paths.size());
+    leaves->resize(paths.size());
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        ParsePath(paths[i], &roots[i], &(*leaves)[i]);
+    }
+    return LookupMatchesBatch(roots);
+}
+
+void
+ConfigImpl::SetBatch(const std::vector<std::string>& paths, const AttributeValue& value)
+{
+    NS_LOG_FUNCTION(this << paths.size() << &value);
+
+    std::vector<std::string> leaves;
+    std::vector<MatchContainer> containers = LookupRootMatches(paths, &leaves);
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        containers[i].Set(leaves[i], value);
+    }
+}
+
+void
+ConfigImpl::ConnectBatch(const std::vector<std::string>& paths, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(this << paths.size() << &cb);
+
+    std::vector<std::string> leaves;
+    std::vector<MatchContainer> containers = LookupRootMatches(paths, &leaves);
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        if (!containers[i].ConnectFailSafe(leaves[i], cb))
+        {
+            NS_FATAL_ERROR("Could not connect callback to " << paths[i]);
+        }
+    }
+}
+
+void
+ConfigImpl::ConnectWithoutContextBatch(const std::vector<std::string>& paths,
+                                       const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(this << paths.size() << &cb);
+
+    std::vector<std::string> leaves;
+    std::vector<MatchContainer> containers = LookupRootMatches(paths, &leaves);
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        if (!containers[i].ConnectWithoutContextFailSafe(leaves[i], cb))
+        {
+            NS_FATAL_ERROR("Could not connect callback to " << paths[i]);
+        }
+    }
 }
 
 void
@@ -1001,6 +1234,34 @@ LookupMatches(std::string path)
     return ConfigImpl::Get()->LookupMatches(path);
 }
 
+std::vector<MatchContainer>
+LookupMatchesBatch(const std::vector<std::string>& paths)
+{
+    NS_LOG_FUNCTION(paths.size());
+    return ConfigImpl::Get()->LookupMatchesBatch(paths);
+}
+
+void
+SetBatch(const std::vector<std::string>& paths, const AttributeValue& value)
+{
+    NS_LOG_FUNCTION(paths.size() << &value);
+    ConfigImpl::Get()->SetBatch(paths, value);
+}
+
+void
+ConnectBatch(const std::vector<std::string>& paths, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(paths.size() << &cb);
+    ConfigImpl::Get()->ConnectBatch(paths, cb);
+}
+
+void
+ConnectWithoutContextBatch(const std::vector<std::string>& paths, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(paths.size() << &cb);
+    ConfigImpl::Get()->ConnectWithoutContextBatch(paths, cb);
+}
+
 void
 RegisterRootNamespaceObject(Ptr<Object> obj)
 {
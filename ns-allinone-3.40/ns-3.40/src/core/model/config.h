@@ -358,9 +358,52 @@ class MatchContainer
  * \param [in] path The path to perform a match against
  * \returns A container which contains all the objects which match the input
  *          path.
+ *
+ * The container can be kept to Set or Connect the matched objects
+ * repeatedly without resolving the path again.
  */
 MatchContainer LookupMatches(std::string path);
 
+/**
+ * \ingroup config
+ * \param [in] paths The paths to perform a match against
+ * \returns A container for each path, with all the objects which match it.
+ *
+ * The paths are resolved in a single traversal of the object graph:
+ * the elements they begin with are only walked once.
+ */
+std::vector<MatchContainer> LookupMatchesBatch(const std::vector<std::string>& paths);
+
+/**
+ * \ingroup config
+ * \param [in] paths The full paths of the attributes to set.
+ * \param [in] value The value to set in all matching attributes.
+ *
+ * Same as Set for each path, but the paths are resolved in a single
+ * traversal of the object graph.
+ */
+void SetBatch(const std::vector<std::string>& paths, const AttributeValue& value);
+
+/**
+ * \ingroup config
+ * \param [in] paths The paths to match trace sources.
+ * \param [in] cb The sink to connect to the matching trace sources.
+ *
+ * Same as Connect for each path, but the paths are resolved in a single
+ * traversal of the object graph.
+ */
+void ConnectBatch(const std::vector<std::string>& paths, const CallbackBase& cb);
+
+/**
+ * \ingroup config
+ * \param [in] paths The paths to match trace sources.
+ * \param [in] cb The sink to connect to the matching trace sources.
+ *
+ * Same as ConnectWithoutContext for each path, but the paths are resolved
+ * in a single traversal of the object graph.
+ */
+void ConnectWithoutContextBatch(const std::vector<std::string>& paths, const CallbackBase& cb);
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
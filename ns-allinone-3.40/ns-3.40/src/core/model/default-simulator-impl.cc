@@ -114,6 +114,10 @@ DefaultSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
         {
             Scheduler::Event next = m_events->RemoveNext();
             scheduler->Insert(next);
+            if (next.impl->IsCancelled())
+            {
+                scheduler->NotifyCancel();
+            }
         }
     }
     m_events = scheduler;
@@ -141,6 +145,10 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
+    if (next.impl->IsCancelled())
+    {
+        m_events->NotifyCancelledRemoved();
+    }
     next.impl->Invoke();
     next.impl->Unref();
 
@@ -352,6 +360,10 @@ DefaultSimulatorImpl::Cancel(const EventId& id)
     if (!IsExpired(id))
     {
         id.PeekEventImpl()->Cancel();
+        if (id.GetUid() != EventId::UID::DESTROY)
+        {
+            m_unscheduledEvents -= NotifyCancel(m_events, m_unscheduledEvents);
+        }
     }
 }
 
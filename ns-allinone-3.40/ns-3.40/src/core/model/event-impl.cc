@@ -32,6 +32,116 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+/** Size of the event size classes. */
+static const std::size_t EVENT_POOL_GRANULE = 16;
+
+/** Number of event size classes; larger events are not pooled. */
+static const std::size_t EVENT_POOL_CLASSES = 8;
+
+/** A released event memory block. */
+struct EventPoolBlock
+{
+    EventPoolBlock* m_next; //!< Next block of the free list.
+};
+
+/** The event free lists of one thread. */
+struct EventPool
+{
+    /** Release the memory of the pooled events. */
+    ~EventPool();
+
+    EventPoolBlock* m_free[EVENT_POOL_CLASSES]{}; //!< Free lists, by size class.
+    uint64_t m_allocated{0};                      //!< Events allocated from the system.
+    uint64_t m_recycled{0};                       //!< Events allocated from the free lists.
+};
+
+#ifdef __SANITIZE_ADDRESS__
+/** Whether released events are reused; off so sanitizers see every event. */
+static bool g_eventPoolEnabled = false;
+#else
+/** Whether released events are reused. */
+static bool g_eventPoolEnabled = true;
+#endif
+
+/** The event pool of this thread. */
+static thread_local EventPool g_eventPool;
+
+/** Whether the event pool of this thread has been destroyed, at thread exit. */
+static thread_local bool g_eventPoolDestroyed = false;
+
+EventPool::~EventPool()
+{
+    for (auto& block : m_free)
+    {
+        while (block != nullptr)
+        {
+            EventPoolBlock* next = block->m_next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+    g_eventPoolDestroyed = true;
+}
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    std::size_t sizeClass = (size - 1) / EVENT_POOL_GRANULE;
+    if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+        return ::operator new(size);
+    }
+    if (g_eventPoolDestroyed)
+    {
+        return ::operator new((sizeClass + 1) * EVENT_POOL_GRANULE);
+    }
+    EventPool& pool = g_eventPool;
+    EventPoolBlock* block = pool.m_free[sizeClass];
+    if (block != nullptr)
+    {
+        pool.m_free[sizeClass] = block->m_next;
+        pool.m_recycled++;
+        return block;
+    }
+    pool.m_allocated++;
+    // Always the full size class, so the block can be pooled when released
+    return ::operator new((sizeClass + 1) * EVENT_POOL_GRANULE);
+}
+
+void
+EventImpl::operator delete(void* ptr, std::size_t size)
+{
+    std::size_t sizeClass = (size - 1) / EVENT_POOL_GRANULE;
+    if (!g_eventPoolEnabled || sizeClass >= EVENT_POOL_CLASSES || g_eventPoolDestroyed)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    EventPool& pool = g_eventPool;
+    auto block = static_cast<EventPoolBlock*>(ptr);
+    block->m_next = pool.m_free[sizeClass];
+    pool.m_free[sizeClass] = block;
+}
+
+void
+EventImpl::EnablePool(bool enable)
+{
+    NS_LOG_FUNCTION(enable);
+    g_eventPoolEnabled = enable;
+}
+
+uint64_t
+EventImpl::GetAllocatedCount()
+{
+    return g_eventPool.m_allocated;
+}
+
+uint64_t
+EventImpl::GetRecycledCount()
+{
+    return g_eventPool.m_recycled;
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -41,6 +42,11 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated from per-thread free lists, one for each size
+ * class of 16 bytes up to 128 bytes, so the memory of an event deleted
+ * by its last EventId is reused by the next event of the same size
+ * without going through the system allocator.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -67,6 +73,46 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate the memory of an event, reusing a block of its size class
+     * released by an earlier event of this thread if there is one.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory block.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the memory of an event to the free list of its size class.
+     *
+     * \param [in] ptr The memory block.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* ptr, std::size_t size);
+    /**
+     * Enable or disable the reuse of event memory.
+     *
+     * Disabling it releases all memory to the system allocator, which
+     * is useful to compare the two or to check for memory errors.
+     * Reuse is disabled by default in builds with the address sanitizer.
+     *
+     * \param [in] enable Whether to reuse released events.
+     */
+    static void EnablePool(bool enable);
+    /**
+     * Get the number of events this thread allocated from the system
+     * allocator.
+     *
+     * \returns The number of events allocated.
+     */
+    static uint64_t GetAllocatedCount();
+    /**
+     * Get the number of events this thread allocated by reusing the
+     * memory of a released event.
+     *
+     * \returns The number of events recycled.
+     */
+    static uint64_t GetRecycledCount();
+
   protected:
     /**
      * Implementation for Invoke().
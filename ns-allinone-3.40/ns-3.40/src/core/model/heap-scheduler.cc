@@ -243,4 +243,30 @@ HeapScheduler::Remove(const Event& ev)
     NS_ASSERT(false);
 }
 
+std::vector<Scheduler::Event>
+HeapScheduler::DoCompact()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Event> removed;
+    std::size_t live = Root();
+    for (std::size_t i = Root(); i < m_heap.size(); i++)
+    {
+        if (m_heap[i].impl->IsCancelled())
+        {
+            removed.push_back(m_heap[i]);
+        }
+        else
+        {
+            m_heap[live++] = m_heap[i];
+        }
+    }
+    m_heap.resize(live);
+    // Rebuild the heap from the last parent up
+    for (std::size_t i = Last() / 2; i >= Root(); i--)
+    {
+        TopDown(i);
+    }
+    return removed;
+}
+
 } // namespace ns3
@@ -92,6 +92,9 @@ class HeapScheduler : public Scheduler
     void Remove(const Scheduler::Event& ev) override;
 
   private:
+    // Inherited
+    std::vector<Scheduler::Event> DoCompact() override;
+
     /** Event list type:  vector of Events, managed as a heap. */
     typedef std::vector<Scheduler::Event> BinaryHeap;
 
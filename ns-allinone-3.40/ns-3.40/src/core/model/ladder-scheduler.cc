@@ -0,0 +1,322 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+/** Buckets with more events than this are split into a new rung. */
+static const std::size_t LADDER_THRESHOLD = 50;
+
+/** Maximum number of rungs. */
+static const std::size_t LADDER_MAX_RUNGS = 8;
+
+/**
+ * Order events in decreasing order, so the earliest is at the end.
+ *
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \c a is later than \c b.
+ */
+static bool
+IsLater(const Scheduler::Event& a, const Scheduler::Event& b)
+{
+    return a.key > b.key;
+}
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topStart(0),
+      m_topMin(std::numeric_limits<uint64_t>::max()),
+      m_topMax(0),
+      m_rungs(LADDER_MAX_RUNGS),
+      m_nRungs(0),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::size_t
+LadderScheduler::FindRung(uint64_t ts) const
+{
+    for (std::size_t i = 0; i < m_nRungs; ++i)
+    {
+        const Rung& rung = m_rungs[i];
+        if (ts >= rung.m_start + rung.m_current * rung.m_width)
+        {
+            return i;
+        }
+    }
+    return m_nRungs;
+}
+
+void
+LadderScheduler::AddRung(Bucket& events, uint64_t start, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << events.size() << start << end);
+    NS_ASSERT(m_nRungs < m_rungs.size());
+    NS_ASSERT(!events.empty() && start < end);
+
+    // About one event per bucket
+    Rung& rung = m_rungs[m_nRungs];
+    uint64_t span = end - start;
+    uint64_t n = events.size();
+    rung.m_width = std::max<uint64_t>(1, (span + n - 1) / n);
+    rung.m_start = start;
+    rung.m_current = 0;
+    rung.m_count = events.size();
+    // The buckets of a rung no longer in use are all empty
+    rung.m_buckets.resize((span + rung.m_width - 1) / rung.m_width);
+    for (const auto& ev : events)
+    {
+        rung.m_buckets[(ev.key.m_ts - start) / rung.m_width].push_back(ev);
+    }
+    events.clear();
+    m_nRungs++;
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (m_bottom.empty())
+    {
+        if (m_nRungs == 0)
+        {
+            NS_ASSERT(!m_top.empty());
+            m_topStart = m_topMax + 1;
+            AddRung(m_top, m_topMin, m_topStart);
+            m_topMin = std::numeric_limits<uint64_t>::max();
+            m_topMax = 0;
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.m_count == 0)
+        {
+            m_nRungs--;
+            continue;
+        }
+        while (rung.m_buckets[rung.m_current].empty())
+        {
+            rung.m_current++;
+        }
+        Bucket& bucket = rung.m_buckets[rung.m_current];
+        uint64_t bucketStart = rung.m_start + rung.m_current * rung.m_width;
+        rung.m_current++;
+        rung.m_count -= bucket.size();
+
+        if (bucket.size() > LADDER_THRESHOLD && rung.m_width > 1 && m_nRungs < m_rungs.size())
+        {
+            AddRung(bucket, bucketStart, bucketStart + rung.m_width);
+            continue;
+        }
+        // Keep the allocation of the bucket for Bottom
+        m_bottom.swap(bucket);
+        std::sort(m_bottom.begin(), m_bottom.end(), IsLater);
+    }
+}
+
+void
+LadderScheduler::InsertBottom(const Scheduler::Event& ev)
+{
+    auto position = std::lower_bound(m_bottom.begin(), m_bottom.end(), ev, IsLater);
+    m_bottom.insert(position, ev);
+}
+
+void
+LadderScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+
+    m_size++;
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+    }
+    else
+    {
+        std::size_t i = FindRung(ts);
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            rung.m_buckets[(ts - rung.m_start) / rung.m_width].push_back(ev);
+            rung.m_count++;
+        }
+        else
+        {
+            InsertBottom(ev);
+        }
+    }
+
+    if (m_bottom.empty())
+    {
+        Refill();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+
+    return m_bottom.back();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+
+    Scheduler::Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    m_size--;
+    if (m_bottom.empty() && m_size > 0)
+    {
+        Refill();
+    }
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+
+    uint64_t ts = ev.key.m_ts;
+    Bucket* bucket = &m_bottom;
+    std::size_t i = m_nRungs;
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else
+    {
+        i = FindRung(ts);
+        if (i < m_nRungs)
+        {
+            Rung& rung = m_rungs[i];
+            bucket = &rung.m_buckets[(ts - rung.m_start) / rung.m_width];
+        }
+    }
+
+    if (bucket == &m_bottom)
+    {
+        auto position = std::lower_bound(m_bottom.begin(), m_bottom.end(), ev, IsLater);
+        NS_ASSERT(position != m_bottom.end() && position->key == ev.key);
+        m_bottom.erase(position);
+    }
+    else
+    {
+        auto position = std::find(bucket->begin(), bucket->end(), ev);
+        NS_ASSERT(position != bucket->end());
+        NS_ASSERT(position->impl == ev.impl);
+        // Top and the buckets are not sorted
+        *position = bucket->back();
+        bucket->pop_back();
+        if (i < m_nRungs)
+        {
+            m_rungs[i].m_count--;
+        }
+    }
+    m_size--;
+
+    if (m_bottom.empty() && m_size > 0)
+    {
+        Refill();
+    }
+}
+
+std::vector<Scheduler::Event>
+LadderScheduler::DoCompact()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Event> removed;
+    auto filter = [&removed](Bucket& bucket) {
+        // Keeps the order of the remaining events, as Bottom is sorted
+        auto end = std::stable_partition(bucket.begin(),
+                                         bucket.end(),
+                                         [](const Event& ev) { return !ev.impl->IsCancelled(); });
+        std::size_t count = bucket.end() - end;
+        removed.insert(removed.end(), end, bucket.end());
+        bucket.erase(end, bucket.end());
+        return count;
+    };
+
+    filter(m_top);
+    for (std::size_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        for (std::size_t j = rung.m_current; j < rung.m_buckets.size(); ++j)
+        {
+            rung.m_count -= filter(rung.m_buckets[j]);
+        }
+    }
+    filter(m_bottom);
+
+    m_size -= removed.size();
+    if (m_bottom.empty() && m_size > 0)
+    {
+        Refill();
+    }
+    return removed;
+}
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Tang, Goh and Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers, all stored in `std::vector`s:
+ *  - Top: an unsorted vector of the events at or after the end of the
+ *    ladder, which is where most newly scheduled events go.
+ *  - Ladder: rungs of buckets, each bucket an unsorted vector covering
+ *    a uniform time span.  The first rung is created from Top, and a
+ *    bucket with too many events is split into a finer rung below.
+ *  - Bottom: a short vector of the earliest events, sorted in decreasing
+ *    order so the next event is removed from its end.
+ *
+ * Events are only sorted once they reach Bottom, so the cost per event
+ * does not depend on the number of pending events.  Events with the
+ * same timestamp are ordered by their uid, as with the other schedulers.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to Top or to a bucket
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Bottom kept sorted and non-empty
+ * Remove()     | ~Constant       | Search within Top, bucket or Bottom
+ * RemoveNext() | ~Constant       | Sort the next bucket into Bottom
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 3 x `sizeof (*)` per bucket      | `std::vector`
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    // Inherited
+    std::vector<Scheduler::Event> DoCompact() override;
+
+    /** Events in one time span, in no particular order. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder: buckets of uniform width. */
+    struct Rung
+    {
+        uint64_t m_start;              //!< Timestamp of the start of the first bucket.
+        uint64_t m_width;              //!< Time span of each bucket.
+        std::size_t m_current;         //!< First bucket not yet moved down.
+        std::size_t m_count;           //!< Events in the buckets.
+        std::vector<Bucket> m_buckets; //!< The buckets.
+    };
+
+    /**
+     * Find the rung covering a timestamp.
+     *
+     * \param [in] ts The timestamp, before the start of Top.
+     * \returns The index of the rung, or the number of rungs if the
+     *          timestamp belongs to Bottom.
+     */
+    std::size_t FindRung(uint64_t ts) const;
+    /**
+     * Add a rung below the others holding events of a time span.
+     *
+     * \param [in,out] events The events, which are moved to the rung.
+     * \param [in] start The start of the span.
+     * \param [in] end The end of the span; all events are before it.
+     */
+    void AddRung(Bucket& events, uint64_t start, uint64_t end);
+    /** Move the next events down the ladder into Bottom. */
+    void Refill();
+    /** Insert an event into Bottom, keeping it sorted. */
+    void InsertBottom(const Scheduler::Event& ev);
+
+    /** Events at or after m_topStart. */
+    Bucket m_top;
+    /** Start of the span of Top. */
+    uint64_t m_topStart;
+    /** Smallest timestamp in Top. */
+    uint64_t m_topMin;
+    /** Largest timestamp in Top. */
+    uint64_t m_topMax;
+    /** The rungs, from the coarsest to the finest, with unused ones at the end. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    std::size_t m_nRungs;
+    /** The earliest events, sorted in decreasing order. */
+    Bucket m_bottom;
+    /** Number of events in queue. */
+    std::size_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
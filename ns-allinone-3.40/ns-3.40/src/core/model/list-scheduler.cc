@@ -112,4 +112,24 @@ ListScheduler::Remove(const Event& ev)
     NS_ASSERT(false);
 }
 
+std::vector<Scheduler::Event>
+ListScheduler::DoCompact()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Event> removed;
+    for (auto i = m_events.begin(); i != m_events.end();)
+    {
+        if (i->impl->IsCancelled())
+        {
+            removed.push_back(*i);
+            i = m_events.erase(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return removed;
+}
+
 } // namespace ns3
@@ -84,6 +84,9 @@ class ListScheduler : public Scheduler
     void Remove(const Scheduler::Event& ev) override;
 
   private:
+    // Inherited
+    std::vector<Scheduler::Event> DoCompact() override;
+
     /** Event list type: a simple list of Events. */
     typedef std::list<Scheduler::Event> Events;
     /** Events iterator. */
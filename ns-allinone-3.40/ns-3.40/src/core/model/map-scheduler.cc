@@ -112,4 +112,24 @@ MapScheduler::Remove(const Event& ev)
     m_list.erase(i);
 }
 
+std::vector<Scheduler::Event>
+MapScheduler::DoCompact()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Event> removed;
+    for (auto i = m_list.begin(); i != m_list.end();)
+    {
+        if (i->second->IsCancelled())
+        {
+            removed.push_back(Event{i->second, i->first});
+            i = m_list.erase(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return removed;
+}
+
 } // namespace ns3
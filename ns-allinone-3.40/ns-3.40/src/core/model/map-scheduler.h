@@ -82,6 +82,9 @@ class MapScheduler : public Scheduler
     void Remove(const Scheduler::Event& ev) override;
 
   private:
+    // Inherited
+    std::vector<Scheduler::Event> DoCompact() override;
+
     /** Event list type: a Map from EventKey to EventImpl. */
     typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
     /** EventMap iterator. */
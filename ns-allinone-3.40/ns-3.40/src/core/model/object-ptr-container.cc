@@ -136,6 +136,40 @@ ObjectPtrContainerAccessor::Get(const ObjectBase* object, AttributeValue& value)
     return true;
 }
 
+bool
+ObjectPtrContainerAccessor::GetByIndex(const ObjectBase* object,
+                                       std::size_t index,
+                                       Ptr<Object>* item) const
+{
+    NS_LOG_FUNCTION(this << object << index << item);
+    std::size_t n;
+    if (!DoGetN(object, &n))
+    {
+        return false;
+    }
+    std::size_t k;
+    if (index < n)
+    {
+        Ptr<Object> o = DoGet(object, index, &k);
+        if (k == index)
+        {
+            *item = o;
+            return true;
+        }
+    }
+    // The indices are not the positions in the container: look for it.
+    for (std::size_t i = 0; i < n; i++)
+    {
+        Ptr<Object> o = DoGet(object, i, &k);
+        if (k == index)
+        {
+            *item = o;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool
 ObjectPtrContainerAccessor::HasGetter() const
 {
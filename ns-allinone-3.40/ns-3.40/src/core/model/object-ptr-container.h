@@ -233,6 +233,19 @@ class ObjectPtrContainerAccessor : public AttributeAccessor
     bool HasGetter() const override;
     bool HasSetter() const override;
 
+    /**
+     * Get the instance of the container with the given index.
+     *
+     * Unlike Get(), the other instances are not fetched when the index
+     * of the instance is also its position in the container.
+     *
+     * \param [in] object The container object.
+     * \param [in] index The index of the requested instance.
+     * \param [out] item The instance.
+     * \returns true if the container holds an instance with this index.
+     */
+    bool GetByIndex(const ObjectBase* object, std::size_t index, Ptr<Object>* item) const;
+
   private:
     /**
      * Get the number of instances in the container.
@@ -24,6 +24,8 @@
 #include "object.h"
 #include "ptr.h"
 
+#include <iterator>
+
 /**
  * \file
  * \ingroup attribute_ObjectVector
@@ -93,20 +95,10 @@ MakeObjectVectorAccessor(U T::*memberVector)
                           std::size_t* index) const override
         {
             const T* obj = static_cast<const T*>(object);
-            auto begin = (obj->*m_memberVector).begin();
-            auto end = (obj->*m_memberVector).end();
-            std::size_t k = 0;
-            for (auto j = begin; j != end; j++, k++)
-            {
-                if (k == i)
-                {
-                    *index = k;
-                    return *j;
-                }
-            }
-            NS_ASSERT(false);
-            // quiet compiler.
-            return nullptr;
+            NS_ASSERT(i < (obj->*m_memberVector).size());
+            *index = i;
+            // constant time if the container has random access iterators.
+            return *std::next((obj->*m_memberVector).begin(), i);
         }
 
         U T::*m_memberVector;
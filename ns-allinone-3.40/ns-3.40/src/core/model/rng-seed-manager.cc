@@ -24,6 +24,10 @@
 #include "log.h"
 #include "uinteger.h"
 
+#ifdef NS3_MPI_THREADS
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup randomvariable
@@ -40,7 +44,11 @@ NS_LOG_COMPONENT_DEFINE("RngSeedManager");
  * The next random number generator stream number to use
  * for automatic assignment.
  */
+#ifdef NS3_MPI_THREADS
+static std::atomic<uint64_t> g_nextStreamIndex{0};
+#else
 static uint64_t g_nextStreamIndex = 0;
+#endif
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -107,9 +115,7 @@ uint64_t
 RngSeedManager::GetNextStreamIndex()
 {
     NS_LOG_FUNCTION_NOARGS();
-    uint64_t next = g_nextStreamIndex;
-    g_nextStreamIndex++;
-    return next;
+    return g_nextStreamIndex++;
 }
 
 } // namespace ns3
@@ -20,6 +20,8 @@
 #include "scheduler.h"
 
 #include "assert.h"
+#include "double.h"
+#include "event-impl.h"
 #include "log.h"
 
 /**
@@ -35,6 +37,12 @@ NS_LOG_COMPONENT_DEFINE("Scheduler");
 
 NS_OBJECT_ENSURE_REGISTERED(Scheduler);
 
+/**
+ * Smallest number of cancelled events worth a compaction, so small
+ * event lists are left alone.
+ */
+static const uint64_t COMPACTION_MIN_CANCELLED = 64;
+
 Scheduler::~Scheduler()
 {
     NS_LOG_FUNCTION(this);
@@ -43,8 +51,93 @@ Scheduler::~Scheduler()
 TypeId
 Scheduler::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::Scheduler").SetParent<Object>().SetGroupName("Core");
+    static TypeId tid =
+        TypeId("ns3::Scheduler")
+            .SetParent<Object>()
+            .SetGroupName("Core")
+            .AddAttribute("CompactionThreshold",
+                          "Remove the cancelled events from the event list when they are "
+                          "more than this fraction of it; 0 leaves them until they reach "
+                          "the head of the list.",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&Scheduler::m_compactionThreshold),
+                          MakeDoubleChecker<double>(0, 1));
     return tid;
 }
 
+Scheduler::Scheduler()
+    : m_cancelled(0),
+      m_compactionThreshold(0.5)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+Scheduler::NotifyCancel()
+{
+    m_cancelled++;
+}
+
+void
+Scheduler::NotifyCancelledRemoved()
+{
+    // Events cancelled directly through EventImpl::Cancel() are not counted
+    if (m_cancelled > 0)
+    {
+        m_cancelled--;
+    }
+}
+
+uint64_t
+Scheduler::GetCancelledCount() const
+{
+    return m_cancelled;
+}
+
+bool
+Scheduler::IsCompactionDue(uint64_t count) const
+{
+    return m_compactionThreshold > 0 && m_cancelled >= COMPACTION_MIN_CANCELLED &&
+           m_cancelled > m_compactionThreshold * count;
+}
+
+uint64_t
+Scheduler::Compact()
+{
+    NS_LOG_FUNCTION(this << m_cancelled);
+    std::vector<Event> removed = DoCompact();
+    for (const auto& ev : removed)
+    {
+        ev.impl->Unref();
+    }
+    m_cancelled = 0;
+    NS_LOG_INFO("removed " << removed.size() << " cancelled events");
+    return removed.size();
+}
+
+std::vector<Scheduler::Event>
+Scheduler::DoCompact()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Event> live;
+    std::vector<Event> removed;
+    while (!IsEmpty())
+    {
+        Event ev = RemoveNext();
+        if (ev.impl->IsCancelled())
+        {
+            removed.push_back(ev);
+        }
+        else
+        {
+            live.push_back(ev);
+        }
+    }
+    for (const auto& ev : live)
+    {
+        Insert(ev);
+    }
+    return removed;
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "object.h"
 
 #include <stdint.h>
+#include <vector>
 
 /**
  * \file
@@ -111,6 +112,14 @@ class EventImpl;
  *      <td class="markdownTableBodyLeft"> 0 </td>
  * </tr>
  * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> LadderScheduler </td>
+ *      <td class="markdownTableBodyLeft"> Ladder queue on `std::vector` </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> 24 bytes </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
+ * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> ListScheduler </td>
  *      <td class="markdownTableBodyLeft"> `std::list` </td>
  *      <td class="markdownTableBodyLeft"> Linear </td>
@@ -152,6 +161,14 @@ class EventImpl;
  * calling EventId::Ref and SimpleRefCount::Unref at the right time.
  * Typically, EventId::Ref is called before Insert and SimpleRefCount::Unref is called
  * after a call to one of the Remove methods.
+ *
+ * Cancelled events stay in the event list until they reach its head,
+ * where the simulator drops them.  Models which cancel and reschedule
+ * timers constantly can fill the event list with such dead events, so
+ * the simulator reports each cancellation with NotifyCancel() and calls
+ * Compact() to remove them all once they exceed the CompactionThreshold
+ * fraction of the event list.  Compact() releases the reference of the
+ * event list to the events it removes.
  */
 class Scheduler : public Object
 {
@@ -186,6 +203,8 @@ class Scheduler : public Object
         EventKey key;    /**< Key for sorting and ordering Events. */
     };
 
+    /** Constructor. */
+    Scheduler();
     /** Destructor. */
     ~Scheduler() override = 0;
 
@@ -226,6 +245,54 @@ class Scheduler : public Object
      * \param [in] ev The event to remove
      */
     virtual void Remove(const Event& ev) = 0;
+
+    /**
+     * Record that an event of the event list has been cancelled.
+     */
+    void NotifyCancel();
+    /**
+     * Record that a cancelled event has left the event list.
+     */
+    void NotifyCancelledRemoved();
+    /**
+     * Get the number of cancelled events in the event list.
+     *
+     * \returns The number of cancelled events.
+     */
+    uint64_t GetCancelledCount() const;
+    /**
+     * Test if the cancelled events exceed the CompactionThreshold
+     * fraction of the event list.
+     *
+     * \param [in] count The number of events in the event list.
+     * \returns \c true if Compact() should be called.
+     */
+    bool IsCompactionDue(uint64_t count) const;
+    /**
+     * Remove all the cancelled events from the event list, and release
+     * the reference the event list holds to them.
+     *
+     * \returns The number of events removed.
+     */
+    uint64_t Compact();
+
+  protected:
+    /**
+     * Remove the cancelled events from the event list.
+     *
+     * The default implementation removes all the events and inserts
+     * the live ones again; schedulers which can filter their
+     * structure in place override it.
+     *
+     * \returns The removed events.
+     */
+    virtual std::vector<Event> DoCompact();
+
+  private:
+    /** Number of cancelled events in the event list. */
+    uint64_t m_cancelled;
+    /** Fraction of cancelled events which triggers a compaction. */
+    double m_compactionThreshold;
 };
 
 /**
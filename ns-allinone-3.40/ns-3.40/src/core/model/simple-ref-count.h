@@ -27,6 +27,10 @@
 #include <limits>
 #include <stdint.h>
 
+#ifdef NS3_MPI_THREADS
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup ptr
@@ -75,6 +79,10 @@ class Empty
  *      to the object it manages exist anymore.
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
+ *
+ * When ns-3 is built with NS3_MPI_THREADS, the reference count is atomic,
+ * so that the threads of HybridSimulatorImpl can hold references to the
+ * same objects.
  */
 template <typename T, typename PARENT = Empty, typename DELETER = DefaultDeleter<T>>
 class SimpleRefCount : public PARENT
@@ -125,8 +133,7 @@ class SimpleRefCount : public PARENT
      */
     inline void Unref() const
     {
-        m_count--;
-        if (m_count == 0)
+        if (--m_count == 0)
         {
             DELETER::Delete(static_cast<T*>(const_cast<SimpleRefCount*>(this)));
         }
@@ -151,7 +158,11 @@ class SimpleRefCount : public PARENT
      * Note we make this mutable so that the const methods can still
      * change it.
      */
+#ifdef NS3_MPI_THREADS
+    mutable std::atomic<uint32_t> m_count;
+#else
     mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
@@ -19,6 +19,8 @@
 #include "simulator-impl.h"
 
 #include "log.h"
+#include "scheduler.h"
+#include "trace-source-accessor.h"
 
 /**
  * \file
@@ -36,8 +38,30 @@ NS_OBJECT_ENSURE_REGISTERED(SimulatorImpl);
 TypeId
 SimulatorImpl::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::SimulatorImpl").SetParent<Object>().SetGroupName("Core");
+    static TypeId tid =
+        TypeId("ns3::SimulatorImpl")
+            .SetParent<Object>()
+            .SetGroupName("Core")
+            .AddTraceSource("Compaction",
+                            "The cancelled events have been removed from the event list, "
+                            "giving the number of live events and of removed events.",
+                            MakeTraceSourceAccessor(&SimulatorImpl::m_compactionTrace),
+                            "ns3::SimulatorImpl::CompactionTracedCallback");
     return tid;
 }
 
+uint64_t
+SimulatorImpl::NotifyCancel(Ptr<Scheduler> events, uint64_t count)
+{
+    events->NotifyCancel();
+    if (!events->IsCompactionDue(count))
+    {
+        return 0;
+    }
+    uint64_t dead = events->Compact();
+    NS_LOG_INFO("compacted event list: " << count - dead << " live, " << dead << " dead");
+    m_compactionTrace(count - dead, dead);
+    return dead;
+}
+
 } // namespace ns3
@@ -26,6 +26,7 @@
 #include "object-factory.h"
 #include "object.h"
 #include "ptr.h"
+#include "traced-callback.h"
 
 /**
  * \file
@@ -107,6 +108,30 @@ class SimulatorImpl : public Object
      * \param [in] id The event about to be processed.
      */
     virtual void PreEventHook(const EventId& id){};
+
+    /**
+     * TracedCallback signature for event list compactions.
+     *
+     * \param [in] live The number of events left in the event list.
+     * \param [in] dead The number of cancelled events removed.
+     */
+    typedef void (*CompactionTracedCallback)(uint64_t live, uint64_t dead);
+
+  protected:
+    /**
+     * Record the cancellation of an event of an event list, and remove
+     * the cancelled events from the list when they exceed its
+     * Scheduler::CompactionThreshold.
+     *
+     * \param [in] events The event list.
+     * \param [in] count The number of events in the event list.
+     * \returns The number of cancelled events removed.
+     */
+    uint64_t NotifyCancel(Ptr<Scheduler> events, uint64_t count);
+
+  private:
+    /** Trace of the event list compactions. */
+    TracedCallback<uint64_t, uint64_t> m_compactionTrace;
 };
 
 } // namespace ns3
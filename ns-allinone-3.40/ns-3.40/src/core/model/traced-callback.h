@@ -27,9 +27,46 @@
 /**
  * \file
  * \ingroup tracing
- * ns3::TracedCallback declaration and template implementation.
+ * ns3::TracedCallback declaration and template implementation,
+ * and the NS_TRACE macro.
  */
 
+#ifndef NS3_TRACE_SOURCES_DISABLE
+
+/**
+ * \ingroup tracing
+ * \brief Fire a trace source on a hot path.
+ *
+ * Calls \c traceSource(...) if a Callback is connected to it, so that
+ * the arguments are not converted nor copied for nothing. When ns-3 is
+ * configured with \c NS3_TRACE_SOURCES=OFF (optimized builds only), it
+ * does nothing: the Callbacks connected to the trace source are never
+ * called.
+ *
+ * \param [in] traceSource The TracedCallback to fire.
+ */
+#define NS_TRACE(traceSource, ...)                                                                 \
+    do                                                                                             \
+    {                                                                                              \
+        if (!(traceSource).IsEmpty())                                                              \
+        {                                                                                          \
+            traceSource(__VA_ARGS__);                                                              \
+        }                                                                                          \
+    } while (false)
+
+#else /* NS3_TRACE_SOURCES_DISABLE */
+
+#define NS_TRACE(traceSource, ...)                                                                 \
+    do                                                                                             \
+    {                                                                                              \
+        if (false)                                                                                 \
+        {                                                                                          \
+            traceSource(__VA_ARGS__);                                                              \
+        }                                                                                          \
+    } while (false)
+
+#endif /* NS3_TRACE_SOURCES_DISABLE */
+
 namespace ns3
 {
 
@@ -47,6 +84,9 @@ namespace ns3
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * On hot paths, fire it with NS_TRACE, which checks IsEmpty() before
+ * converting the arguments.
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template <typename... Ts>
@@ -864,6 +864,138 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the ability to resolve several paths at once.
+ */
+class BatchConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    BatchConfigTestCase();
+
+    /** Destructor. */
+    ~BatchConfigTestCase() override
+    {
+    }
+
+    /**
+     * Trace callback with context path.
+     * \param path The context path.
+     * \param old The old value.
+     * \param newValue The new value.
+     */
+    void TraceWithPath(std::string path, int16_t old [[maybe_unused]], int16_t newValue)
+    {
+        m_newValue = newValue;
+        m_path = path;
+    }
+
+  private:
+    void DoRun() override;
+
+    int16_t m_newValue; //!< Flag to detect tracing result.
+    std::string m_path; //!< The context path.
+};
+
+BatchConfigTestCase::BatchConfigTestCase()
+    : TestCase("Check that paths resolved at once match the same objects as one by one")
+{
+}
+
+void
+BatchConfigTestCase::DoRun()
+{
+    IntegerValue iv;
+
+    //
+    // Reach the objects through a name rather than a root namespace object,
+    // so that the objects of the other test cases do not match
+    //
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Names::Add("BatchRoot", root);
+    Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject>();
+    root->SetNodeA(a);
+    Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject>();
+    a->SetNodeB(b);
+    std::vector<Ptr<ConfigTestObject>> objs;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objs.push_back(CreateObject<ConfigTestObject>());
+        b->AddNodeB(objs.back());
+    }
+
+    std::vector<std::string> paths = {"/Names/BatchRoot/NodeA/NodeB/NodesB/1",
+                                      "/Names/BatchRoot/NodeA/NodeB/NodesB/*",
+                                      "/Names/BatchRoot/NodeA/NodeB/NodesB/[2-3]|0",
+                                      "/Names/BatchRoot/NodeA/NodeB/NodesB/02",
+                                      "/Names/BatchRoot/NodeA/NodeB/NodesB/4",
+                                      "/Names/BatchRoot/NodeA/NodeB",
+                                      "/Names/BatchRoot/NodeA/NodeB/NodesB",
+                                      "/Names/BatchRoot/NodeA/NodeB/NodesB/1"};
+    std::vector<Config::MatchContainer> batch = Config::LookupMatchesBatch(paths);
+    NS_TEST_ASSERT_MSG_EQ(batch.size(), paths.size(), "One container per path expected");
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        Config::MatchContainer one = Config::LookupMatches(paths[i]);
+        NS_TEST_ASSERT_MSG_EQ(batch[i].GetPath(), paths[i], "Unexpected path");
+        NS_TEST_ASSERT_MSG_EQ(batch[i].GetN(), one.GetN(), "Unexpected matches for " << paths[i]);
+        for (std::size_t j = 0; j < one.GetN(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(batch[i].Get(j), one.Get(j), "Unexpected match");
+            NS_TEST_ASSERT_MSG_EQ(batch[i].GetMatchedPath(j),
+                                  one.GetMatchedPath(j),
+                                  "Unexpected context");
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(batch[0].GetN(), 1, "Index 1 should match one object");
+    NS_TEST_ASSERT_MSG_EQ(batch[0].Get(0), objs[1], "Index 1 should match the second object");
+    NS_TEST_ASSERT_MSG_EQ(batch[1].GetN(), 4, "* should match all the objects");
+    NS_TEST_ASSERT_MSG_EQ(batch[2].GetN(), 3, "[2-3]|0 should match three objects");
+    NS_TEST_ASSERT_MSG_EQ(batch[3].GetMatchedPath(0),
+                          "/Names/BatchRoot/NodeA/NodeB/NodesB/2/",
+                          "The context should hold the index, not the path element");
+    NS_TEST_ASSERT_MSG_EQ(batch[4].GetN(), 0, "Index 4 should match no object");
+    NS_TEST_ASSERT_MSG_EQ(batch[5].Get(0), b, "The path should match the object it ends at");
+    NS_TEST_ASSERT_MSG_EQ(batch[6].GetN(), 0, "A path ending at a vector should match nothing");
+    NS_TEST_ASSERT_MSG_EQ(batch[7].Get(0), objs[1], "A repeated path should match too");
+
+    //
+    // Set Attributes of several paths at once
+    //
+    Config::SetBatch({"/Names/BatchRoot/NodeA/NodeB/NodesB/0/A",
+                      "/Names/BatchRoot/NodeA/NodeB/NodesB/2/A",
+                      "/Names/BatchRoot/NodeA/NodeB/NodesB/[1-3]/B"},
+                     IntegerValue(-20));
+    int64_t expectedA[] = {-20, 10, -20, 10};
+    int64_t expectedB[] = {9, -20, -20, -20};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objs[i]->GetAttribute("A", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), expectedA[i], "Unexpected Attribute \"A\" of " << i);
+        objs[i]->GetAttribute("B", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), expectedB[i], "Unexpected Attribute \"B\" of " << i);
+    }
+
+    //
+    // Connect to the trace sources of several paths at once
+    //
+    Config::ConnectBatch({"/Names/BatchRoot/NodeA/NodeB/NodesB/1/Source",
+                          "/Names/BatchRoot/NodeA/NodeB/NodesB/3/Source"},
+                         MakeCallback(&BatchConfigTestCase::TraceWithPath, this));
+    m_newValue = 0;
+    objs[3]->SetAttribute("Source", IntegerValue(-3));
+    NS_TEST_ASSERT_MSG_EQ(m_newValue, -3, "Trace should have been called");
+    NS_TEST_ASSERT_MSG_EQ(m_path,
+                          "/Names/BatchRoot/NodeA/NodeB/NodesB/3/Source",
+                          "Trace path should be the one of the fourth object");
+    m_newValue = 0;
+    objs[2]->SetAttribute("Source", IntegerValue(-2));
+    NS_TEST_ASSERT_MSG_EQ(m_newValue, 0, "Trace should not have been called");
+
+    Names::Clear();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +1014,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new BatchConfigTestCase);
 }
 
 /**
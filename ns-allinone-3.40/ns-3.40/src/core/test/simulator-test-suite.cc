@@ -17,10 +17,15 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/calendar-scheduler.h"
+#include "ns3/event-impl.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/make-event.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
@@ -211,6 +216,103 @@ SimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_destroy, true, "Event should have run");
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that cancelled events are removed from the event list
+ * once they are too many, without disturbing the other events.
+ */
+class SimulatorCompactionTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SimulatorCompactionTestCase(ObjectFactory schedulerFactory);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Test Event.
+     * \param value Event parameter.
+     */
+    void Event(int value);
+    /**
+     * Compaction trace sink.
+     * \param live Live events left.
+     * \param dead Cancelled events removed.
+     */
+    void Compaction(uint64_t live, uint64_t dead);
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+    int m_last;                       //!< Value of the last event executed.
+    int m_executed;                   //!< Number of events executed.
+    int m_compactions;                //!< Number of compactions.
+    uint64_t m_dead;                  //!< Cancelled events removed.
+};
+
+SimulatorCompactionTestCase::SimulatorCompactionTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check that cancelled events are compacted with " +
+               schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SimulatorCompactionTestCase::Event(int value)
+{
+    NS_TEST_EXPECT_MSG_EQ(value % 5, 0, "Cancelled event executed");
+    NS_TEST_EXPECT_MSG_GT(value, m_last, "Event executed out of order");
+    m_last = value;
+    m_executed++;
+}
+
+void
+SimulatorCompactionTestCase::Compaction(uint64_t /* live */, uint64_t dead)
+{
+    m_compactions++;
+    m_dead += dead;
+}
+
+void
+SimulatorCompactionTestCase::DoRun()
+{
+    m_last = -1;
+    m_executed = 0;
+    m_compactions = 0;
+    m_dead = 0;
+
+    Simulator::SetScheduler(m_schedulerFactory);
+    Simulator::GetImplementation()->TraceConnectWithoutContext(
+        "Compaction",
+        MakeCallback(&SimulatorCompactionTestCase::Compaction, this));
+
+    std::vector<EventId> ids;
+    for (int i = 0; i < 1000; i++)
+    {
+        ids.push_back(Simulator::Schedule(MicroSeconds(1000 - i),
+                                          &SimulatorCompactionTestCase::Event,
+                                          this,
+                                          999 - i));
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        if ((999 - i) % 5 != 0)
+        {
+            Simulator::Cancel(ids[i]);
+            NS_TEST_EXPECT_MSG_EQ(ids[i].IsExpired(), true, "Cancelled event not expired");
+        }
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_executed, 200, "Live events lost");
+    NS_TEST_EXPECT_MSG_GT(m_compactions, 0, "Event list not compacted");
+    NS_TEST_EXPECT_MSG_GT(m_dead, 500, "Cancelled events not removed");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -707,6 +809,180 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the memory of executed events is reused.
+ */
+class EventPoolTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    EventPoolTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Schedule the next event of the chain. */
+    void Next();
+
+    uint32_t m_count; //!< Events executed so far.
+};
+
+EventPoolTestCase::EventPoolTestCase()
+    : TestCase("Event memory reuse"),
+      m_count(0)
+{
+}
+
+void
+EventPoolTestCase::Next()
+{
+    if (++m_count < 1000)
+    {
+        Simulator::Schedule(NanoSeconds(1), &EventPoolTestCase::Next, this);
+    }
+}
+
+void
+EventPoolTestCase::DoRun()
+{
+    uint64_t allocated = EventImpl::GetAllocatedCount();
+    uint64_t recycled = EventImpl::GetRecycledCount();
+
+    Simulator::Schedule(NanoSeconds(1), &EventPoolTestCase::Next, this);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    allocated = EventImpl::GetAllocatedCount() - allocated;
+    recycled = EventImpl::GetRecycledCount() - recycled;
+    NS_TEST_EXPECT_MSG_EQ(m_count, 1000, "Not all events executed");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(allocated + recycled, 1000, "Events not counted");
+#ifndef __SANITIZE_ADDRESS__
+    // Each event is released before the event it scheduled is executed
+    NS_TEST_EXPECT_MSG_LT(allocated, 10, "Executed events not reused");
+#endif
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the LadderScheduler returns the events in the same order
+ * as the MapScheduler.
+ *
+ * The events are inserted, removed and removed in order at random.  Most
+ * of them are clustered in short spans, with many at the same timestamp,
+ * so that the buckets hold more events than a rung can keep and are split
+ * into new rungs, and events are removed from these rungs.
+ */
+class LadderSchedulerTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    LadderSchedulerTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Event function, never invoked. */
+    static void Nothing();
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase()
+    : TestCase("LadderScheduler against MapScheduler")
+{
+}
+
+void
+LadderSchedulerTestCase::Nothing()
+{
+}
+
+void
+LadderSchedulerTestCase::DoRun()
+{
+    Ptr<Scheduler> ladder = CreateObject<LadderScheduler>();
+    Ptr<Scheduler> map = CreateObject<MapScheduler>();
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    random->SetStream(1);
+
+    // The events queued, in no particular order
+    std::vector<Scheduler::Event> events;
+    std::vector<Ptr<EventImpl>> impls;
+    uint64_t now = 0;
+    uint32_t uid = 0;
+    uint32_t removed = 0;
+    uint32_t removedNext = 0;
+
+    for (uint32_t i = 0; i < 40000; ++i)
+    {
+        // Fill the schedulers first, then keep them at about the same size
+        double choice = random->GetValue();
+        if (events.empty() || (i < 5000 && choice < 0.9) || choice < 0.5)
+        {
+            Ptr<EventImpl> impl = Ptr<EventImpl>(MakeEvent(&Nothing), false);
+            impls.push_back(impl);
+            Scheduler::Event ev;
+            ev.impl = PeekPointer(impl);
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            double spread = random->GetValue();
+            if (spread < 0.3)
+            {
+                // A few timestamps shared by many events
+                ev.key.m_ts = now + random->GetInteger(0, 4) * 1000;
+            }
+            else if (spread < 0.8)
+            {
+                // Many events in a short span
+                ev.key.m_ts = now + random->GetInteger(0, 300);
+            }
+            else
+            {
+                ev.key.m_ts = now + random->GetInteger(0, 10000000);
+            }
+            ladder->Insert(ev);
+            map->Insert(ev);
+            events.push_back(ev);
+        }
+        else if (choice < 0.65)
+        {
+            uint32_t index = random->GetInteger(0, events.size() - 1);
+            Scheduler::Event ev = events[index];
+            events[index] = events.back();
+            events.pop_back();
+            ladder->Remove(ev);
+            map->Remove(ev);
+            removed++;
+        }
+        else
+        {
+            Scheduler::Event next = map->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(ladder->PeekNext().key.m_uid,
+                                  next.key.m_uid,
+                                  "Different next event after " << i << " operations");
+            NS_TEST_ASSERT_MSG_EQ(ladder->RemoveNext().key.m_uid,
+                                  next.key.m_uid,
+                                  "Different event removed after " << i << " operations");
+            now = next.key.m_ts;
+            events.erase(std::find(events.begin(), events.end(), next));
+            removedNext++;
+        }
+        NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), map->IsEmpty(), "Different sizes");
+    }
+    NS_TEST_EXPECT_MSG_GT(removed, 1000, "Too few events removed");
+    NS_TEST_EXPECT_MSG_GT(removedNext, 1000, "Too few events removed in order");
+
+    while (!map->IsEmpty())
+    {
+        Scheduler::Event next = map->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ(ladder->RemoveNext().key.m_uid,
+                              next.key.m_uid,
+                              "Different event removed while draining");
+    }
+    NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), true, "Events left in the LadderScheduler");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -722,14 +998,24 @@ class SimulatorTestSuite : public TestSuite
         factory.SetTypeId(ListScheduler::GetTypeId());
 
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorCompactionTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(MapScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorCompactionTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(HeapScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorCompactionTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(CalendarScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorCompactionTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorCompactionTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SimulatorCompactionTestCase(factory), TestCase::QUICK);
+        AddTestCase(new LadderSchedulerTestCase, TestCase::QUICK);
+        AddTestCase(new EventPoolTestCase, TestCase::QUICK);
     }
 };
 
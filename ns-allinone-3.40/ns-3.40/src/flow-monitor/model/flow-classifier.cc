@@ -19,11 +19,15 @@
 
 #include "flow-classifier.h"
 
+#include "ns3/assert.h"
+
 namespace ns3
 {
 
 FlowClassifier::FlowClassifier()
-    : m_lastNewFlowId(0)
+    : m_lastNewFlowId(0),
+      m_systemId(0),
+      m_systemCount(1)
 {
 }
 
@@ -31,10 +35,29 @@ FlowClassifier::~FlowClassifier()
 {
 }
 
+void
+FlowClassifier::SetSystemId(uint32_t systemId, uint32_t systemCount)
+{
+    NS_ASSERT_MSG(m_lastNewFlowId == 0, "Flows were classified before the rank was set");
+    NS_ASSERT(systemId < systemCount);
+    m_systemId = systemId;
+    m_systemCount = systemCount;
+}
+
 FlowId
 FlowClassifier::GetNewFlowId()
 {
-    return ++m_lastNewFlowId;
+    return m_lastNewFlowId++ * m_systemCount + m_systemId + 1;
+}
+
+void
+FlowClassifier::SerializeFlows(std::vector<uint64_t>& words) const
+{
+}
+
+void
+FlowClassifier::DeserializeFlows(const uint64_t* begin, const uint64_t* end)
+{
 }
 
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/simple-ref-count.h"
 
 #include <ostream>
+#include <vector>
 
 namespace ns3
 {
@@ -53,7 +54,9 @@ typedef uint32_t FlowPacketId;
 class FlowClassifier : public SimpleRefCount<FlowClassifier>
 {
   private:
-    FlowId m_lastNewFlowId; //!< Last known Flow ID
+    FlowId m_lastNewFlowId; //!< Number of flows classified
+    uint32_t m_systemId;    //!< Rank of this classifier
+    uint32_t m_systemCount; //!< Number of ranks
 
   public:
     FlowClassifier();
@@ -68,6 +71,25 @@ class FlowClassifier : public SimpleRefCount<FlowClassifier>
     /// \param indent number of spaces to use as base indentation level
     virtual void SerializeToXmlStream(std::ostream& os, uint16_t indent) const = 0;
 
+    /// Interleaves the flow identifiers with those of the classifiers of
+    /// the other ranks of a distributed simulation, so that a flow has
+    /// the same identifier on all the ranks.  With a single rank, the
+    /// identifiers are 1, 2, 3 and so on.
+    /// \param systemId the rank of this classifier
+    /// \param systemCount the number of ranks
+    void SetSystemId(uint32_t systemId, uint32_t systemCount);
+
+    /// Appends the flows of this classifier to a buffer, so that they can be
+    /// added to the classifier of another rank with DeserializeFlows().
+    /// The default implementation appends nothing.
+    /// \param words the buffer
+    virtual void SerializeFlows(std::vector<uint64_t>& words) const;
+
+    /// Adds the flows appended to a buffer by SerializeFlows() on another rank
+    /// \param begin the first word of the flows
+    /// \param end one past the last word of the flows
+    virtual void DeserializeFlows(const uint64_t* begin, const uint64_t* end);
+
   protected:
     /// Returns a new, unique Flow Identifier
     /// \returns a new FlowId
@@ -19,10 +19,17 @@
 
 #include "flow-monitor.h"
 
+#include "ns3/abort.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+
+#include <mpi.h>
+#endif
+
 #include <fstream>
 #include <sstream>
 
@@ -35,6 +42,65 @@ NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
+/**
+ * \ingroup flow-monitor
+ * Get the key of a tracked packet
+ * \param flowId the flow identification
+ * \param packetId the packet identification
+ * \returns the key
+ */
+static inline uint64_t
+GetPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (uint64_t(flowId) << 32) | packetId;
+}
+
+/**
+ * \ingroup flow-monitor
+ * Append a histogram to a buffer
+ * \param words the buffer
+ * \param histogram the histogram
+ */
+static void
+SerializeHistogram(std::vector<uint64_t>& words, const Histogram& histogram)
+{
+    words.push_back(histogram.GetNBins());
+    for (uint32_t index = 0; index < histogram.GetNBins(); index++)
+    {
+        words.push_back(histogram.GetBinCount(index));
+    }
+}
+
+/**
+ * \ingroup flow-monitor
+ * Add a histogram appended to a buffer by SerializeHistogram() to another one
+ * \param words the buffer, advanced past the histogram
+ * \param histogram the histogram to add to
+ */
+static void
+DeserializeHistogram(const uint64_t*& words, Histogram& histogram)
+{
+    for (uint32_t index = 0, bins = *words++; index < bins; index++)
+    {
+        histogram.AddBinCount(index, *words++);
+    }
+}
+
+/**
+ * \ingroup flow-monitor
+ * Add a histogram to another one
+ * \param histogram the histogram to add to
+ * \param other the histogram to add
+ */
+static void
+AddHistogram(Histogram& histogram, const Histogram& other)
+{
+    for (uint32_t index = 0; index < other.GetNBins(); index++)
+    {
+        histogram.AddBinCount(index, other.GetBinCount(index));
+    }
+}
+
 TypeId
 FlowMonitor::GetTypeId()
 {
@@ -91,9 +157,18 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_enabled(false),
+      m_systemId(0),
+      m_systemCount(1)
 {
     NS_LOG_FUNCTION(this);
+#ifdef NS3_MPI
+    if (MpiInterface::IsEnabled())
+    {
+        m_systemId = MpiInterface::GetSystemId();
+        m_systemCount = MpiInterface::GetSize();
+    }
+#endif
 }
 
 void
@@ -118,10 +193,11 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    auto iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    auto iter = m_flowStatsIndex.find(flowId);
+    if (iter == m_flowStatsIndex.end())
     {
         FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+        m_flowStatsIndex[flowId] = &ref;
         ref.delaySum = Seconds(0);
         ref.jitterSum = Seconds(0);
         ref.lastDelay = Seconds(0);
@@ -139,7 +215,7 @@ FlowMonitor::GetStatsForFlow(FlowId flowId)
     }
     else
     {
-        return iter->second;
+        return *iter->second;
     }
 }
 
@@ -156,7 +232,7 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    TrackedPacket& tracked = m_trackedPackets[GetPacketKey(flowId, packetId)];
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
@@ -187,8 +263,7 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    auto tracked = m_trackedPackets.find(key);
+    auto tracked = m_trackedPackets.find(GetPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet forward report (flowId="
@@ -215,7 +290,7 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    auto tracked = m_trackedPackets.find(GetPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet last-tx report (flowId="
@@ -268,6 +343,12 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                   << packetId << ").");
 
+    if (m_systemCount > 1)
+    {
+        // the packet may have been forwarded on other ranks, even if it was
+        // first transmitted on this one
+        m_completedPackets[tracked->first] = true;
+    }
     m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
 }
 
@@ -299,7 +380,11 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    if (m_systemCount > 1)
+    {
+        m_completedPackets[GetPacketKey(flowId, packetId)] = false;
+    }
+    auto tracked = m_trackedPackets.find(GetPacketKey(flowId, packetId));
     if (tracked != m_trackedPackets.end())
     {
         // we don't need to track this packet anymore
@@ -310,6 +395,25 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     }
 }
 
+void
+FlowMonitor::ReportRemoteTx(FlowId flowId, FlowPacketId packetId, const Time& txTime)
+{
+    if (!m_enabled || m_systemCount == 1)
+    {
+        return;
+    }
+    auto insert = m_trackedPackets.emplace(GetPacketKey(flowId, packetId), TrackedPacket());
+    if (insert.second)
+    {
+        NS_LOG_DEBUG("ReportRemoteTx: adding tracked packet (flowId=" << flowId << ", packetId="
+                                                                      << packetId << ").");
+        TrackedPacket& tracked = insert.first->second;
+        tracked.firstSeenTime = txTime;
+        tracked.lastSeenTime = Simulator::Now();
+        tracked.timesForwarded = 0;
+    }
+}
+
 const FlowMonitor::FlowStatsContainer&
 FlowMonitor::GetFlowStats() const
 {
@@ -326,10 +430,19 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
     {
         if (now - iter->second.lastSeenTime >= maxDelay)
         {
-            // packet is considered lost, add it to the loss statistics
-            auto flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
+            if (m_systemCount > 1)
+            {
+                // the packet may have been received or dropped on another rank,
+                // GatherStats () decides whether it is lost
+                m_expiredPackets[iter->first] += iter->second.timesForwarded;
+            }
+            else
+            {
+                // packet is considered lost, add it to the loss statistics
+                auto flow = m_flowStats.find(FlowId(iter->first >> 32));
+                NS_ASSERT(flow != m_flowStats.end());
+                flow->second.lostPackets++;
+            }
 
             // we won't track it anymore
             m_trackedPackets.erase(iter++);
@@ -424,6 +537,7 @@ FlowMonitor::StopRightNow()
 void
 FlowMonitor::AddFlowClassifier(Ptr<FlowClassifier> classifier)
 {
+    classifier->SetSystemId(m_systemId, m_systemCount);
     m_classifiers.push_back(classifier);
 }
 
@@ -553,6 +667,308 @@ FlowMonitor::ResetAllStats()
         flowStat.packetSizeHistogram.Clear();
         flowStat.flowInterruptionsHistogram.Clear();
     }
+    m_expiredPackets.clear();
+    m_completedPackets.clear();
+}
+
+void
+FlowMonitor::SerializeStats(std::vector<uint64_t>& words) const
+{
+    NS_LOG_FUNCTION(this);
+
+    words.push_back(m_flowStats.size());
+    for (const auto& flow : m_flowStats)
+    {
+        const FlowStats& stats = flow.second;
+        words.push_back(flow.first);
+        words.push_back(stats.timeFirstTxPacket.GetTimeStep());
+        words.push_back(stats.timeFirstRxPacket.GetTimeStep());
+        words.push_back(stats.timeLastTxPacket.GetTimeStep());
+        words.push_back(stats.timeLastRxPacket.GetTimeStep());
+        words.push_back(stats.delaySum.GetTimeStep());
+        words.push_back(stats.jitterSum.GetTimeStep());
+        words.push_back(stats.lastDelay.GetTimeStep());
+        words.push_back(stats.txBytes);
+        words.push_back(stats.rxBytes);
+        words.push_back(stats.txPackets);
+        words.push_back(stats.rxPackets);
+        words.push_back(stats.lostPackets);
+        words.push_back(stats.timesForwarded);
+        words.push_back(stats.packetsDropped.size());
+        for (uint32_t reasonCode = 0; reasonCode < stats.packetsDropped.size(); reasonCode++)
+        {
+            words.push_back(stats.packetsDropped[reasonCode]);
+            words.push_back(stats.bytesDropped[reasonCode]);
+        }
+        SerializeHistogram(words, stats.delayHistogram);
+        SerializeHistogram(words, stats.jitterHistogram);
+        SerializeHistogram(words, stats.packetSizeHistogram);
+        SerializeHistogram(words, stats.flowInterruptionsHistogram);
+    }
+
+    words.push_back(m_classifiers.size());
+    for (const auto& classifier : m_classifiers)
+    {
+        size_t start = words.size();
+        words.push_back(0);
+        classifier->SerializeFlows(words);
+        words[start] = words.size() - start - 1;
+    }
+
+    words.push_back(m_flowProbes.size());
+    for (const auto& probe : m_flowProbes)
+    {
+        FlowProbe::Stats probeStats = probe->GetStats();
+        words.push_back(probeStats.size());
+        for (const auto& flow : probeStats)
+        {
+            const FlowProbe::FlowStats& stats = flow.second;
+            words.push_back(flow.first);
+            words.push_back(stats.delayFromFirstProbeSum.GetTimeStep());
+            words.push_back(stats.bytes);
+            words.push_back(stats.packets);
+            words.push_back(stats.packetsDropped.size());
+            for (uint32_t reasonCode = 0; reasonCode < stats.packetsDropped.size(); reasonCode++)
+            {
+                words.push_back(stats.packetsDropped[reasonCode]);
+                words.push_back(stats.bytesDropped[reasonCode]);
+            }
+        }
+    }
+
+    // the packets this rank did not see to completion, and the packets it
+    // completed, with 0 for expired, 1 for tracked, 2 for received and
+    // 3 for dropped
+    words.push_back(m_expiredPackets.size() + m_trackedPackets.size() +
+                    m_completedPackets.size());
+    for (const auto& packet : m_expiredPackets)
+    {
+        words.push_back(packet.first);
+        words.push_back(packet.second);
+        words.push_back(0);
+    }
+    for (const auto& packet : m_trackedPackets)
+    {
+        words.push_back(packet.first);
+        words.push_back(packet.second.timesForwarded);
+        words.push_back(1);
+    }
+    for (const auto& packet : m_completedPackets)
+    {
+        words.push_back(packet.first);
+        words.push_back(0);
+        words.push_back(packet.second ? 2 : 3);
+    }
+}
+
+void
+FlowMonitor::DeserializeStats(const uint64_t*& words,
+                              bool merge,
+                              std::unordered_map<uint64_t, RemotePacket>& packets)
+{
+    NS_LOG_FUNCTION(this << merge);
+
+    for (uint64_t flows = *words++; flows > 0; flows--)
+    {
+        FlowId flowId = *words++;
+        FlowStats stats;
+        stats.timeFirstTxPacket = TimeStep(*words++);
+        stats.timeFirstRxPacket = TimeStep(*words++);
+        stats.timeLastTxPacket = TimeStep(*words++);
+        stats.timeLastRxPacket = TimeStep(*words++);
+        stats.delaySum = TimeStep(*words++);
+        stats.jitterSum = TimeStep(*words++);
+        stats.lastDelay = TimeStep(*words++);
+        stats.txBytes = *words++;
+        stats.rxBytes = *words++;
+        stats.txPackets = *words++;
+        stats.rxPackets = *words++;
+        stats.lostPackets = *words++;
+        stats.timesForwarded = *words++;
+        for (uint64_t reasons = *words++; reasons > 0; reasons--)
+        {
+            stats.packetsDropped.push_back(*words++);
+            stats.bytesDropped.push_back(*words++);
+        }
+        DeserializeHistogram(words, stats.delayHistogram);
+        DeserializeHistogram(words, stats.jitterHistogram);
+        DeserializeHistogram(words, stats.packetSizeHistogram);
+        DeserializeHistogram(words, stats.flowInterruptionsHistogram);
+        if (!merge)
+        {
+            continue;
+        }
+
+        FlowStats& flow = GetStatsForFlow(flowId);
+        if (stats.txPackets > 0)
+        {
+            if (flow.txPackets == 0 || stats.timeFirstTxPacket < flow.timeFirstTxPacket)
+            {
+                flow.timeFirstTxPacket = stats.timeFirstTxPacket;
+            }
+            if (flow.txPackets == 0 || stats.timeLastTxPacket > flow.timeLastTxPacket)
+            {
+                flow.timeLastTxPacket = stats.timeLastTxPacket;
+            }
+        }
+        if (stats.rxPackets > 0)
+        {
+            if (flow.rxPackets == 0 || stats.timeFirstRxPacket < flow.timeFirstRxPacket)
+            {
+                flow.timeFirstRxPacket = stats.timeFirstRxPacket;
+            }
+            if (flow.rxPackets == 0 || stats.timeLastRxPacket > flow.timeLastRxPacket)
+            {
+                flow.timeLastRxPacket = stats.timeLastRxPacket;
+                flow.lastDelay = stats.lastDelay;
+            }
+        }
+        flow.delaySum += stats.delaySum;
+        flow.jitterSum += stats.jitterSum;
+        flow.txBytes += stats.txBytes;
+        flow.rxBytes += stats.rxBytes;
+        flow.txPackets += stats.txPackets;
+        flow.rxPackets += stats.rxPackets;
+        flow.lostPackets += stats.lostPackets;
+        flow.timesForwarded += stats.timesForwarded;
+        if (flow.packetsDropped.size() < stats.packetsDropped.size())
+        {
+            flow.packetsDropped.resize(stats.packetsDropped.size(), 0);
+            flow.bytesDropped.resize(stats.packetsDropped.size(), 0);
+        }
+        for (uint32_t reasonCode = 0; reasonCode < stats.packetsDropped.size(); reasonCode++)
+        {
+            flow.packetsDropped[reasonCode] += stats.packetsDropped[reasonCode];
+            flow.bytesDropped[reasonCode] += stats.bytesDropped[reasonCode];
+        }
+        AddHistogram(flow.delayHistogram, stats.delayHistogram);
+        AddHistogram(flow.jitterHistogram, stats.jitterHistogram);
+        AddHistogram(flow.packetSizeHistogram, stats.packetSizeHistogram);
+        AddHistogram(flow.flowInterruptionsHistogram, stats.flowInterruptionsHistogram);
+    }
+
+    NS_ABORT_MSG_UNLESS(*words == m_classifiers.size(),
+                        "The ranks do not have the same flow classifiers");
+    words++;
+    for (const auto& classifier : m_classifiers)
+    {
+        uint64_t size = *words++;
+        if (merge)
+        {
+            classifier->DeserializeFlows(words, words + size);
+        }
+        words += size;
+    }
+
+    NS_ABORT_MSG_UNLESS(*words == m_flowProbes.size(),
+                        "The ranks do not have the same flow probes");
+    words++;
+    for (const auto& probe : m_flowProbes)
+    {
+        for (uint64_t flows = *words++; flows > 0; flows--)
+        {
+            FlowId flowId = *words++;
+            FlowProbe::FlowStats stats;
+            stats.delayFromFirstProbeSum = TimeStep(*words++);
+            stats.bytes = *words++;
+            stats.packets = *words++;
+            for (uint64_t reasons = *words++; reasons > 0; reasons--)
+            {
+                stats.packetsDropped.push_back(*words++);
+                stats.bytesDropped.push_back(*words++);
+            }
+            if (merge)
+            {
+                probe->AddFlowStats(flowId, stats);
+            }
+        }
+    }
+
+    for (uint64_t count = *words++; count > 0; count--, words += 3)
+    {
+        auto insert = packets.emplace(words[0], RemotePacket());
+        RemotePacket& packet = insert.first->second;
+        if (insert.second)
+        {
+            packet.timesForwarded = 0;
+            packet.expired = packet.tracked = packet.received = packet.dropped = false;
+        }
+        packet.timesForwarded += words[1];
+        packet.expired |= (words[2] == 0);
+        packet.tracked |= (words[2] == 1);
+        packet.received |= (words[2] == 2);
+        packet.dropped |= (words[2] == 3);
+    }
+}
+
+void
+FlowMonitor::GatherStats()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_systemCount == 1)
+    {
+        return;
+    }
+
+#ifdef NS3_MPI
+    CheckForLostPackets();
+    std::vector<uint64_t> words;
+    SerializeStats(words);
+    m_expiredPackets.clear();
+    m_completedPackets.clear();
+
+    MPI_Comm communicator = MpiInterface::GetCommunicator();
+    int size = words.size();
+    std::vector<int> sizes(m_systemCount, 0);
+    MPI_Gather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, communicator);
+    std::vector<int> offsets(m_systemCount, 0);
+    std::vector<uint64_t> all;
+    if (m_systemId == 0)
+    {
+        for (uint32_t rank = 1; rank < m_systemCount; rank++)
+        {
+            offsets[rank] = offsets[rank - 1] + sizes[rank - 1];
+        }
+        all.resize(offsets.back() + sizes.back());
+    }
+    MPI_Gatherv(words.data(),
+                size,
+                MPI_UINT64_T,
+                all.data(),
+                sizes.data(),
+                offsets.data(),
+                MPI_UINT64_T,
+                0,
+                communicator);
+    if (m_systemId != 0)
+    {
+        return;
+    }
+
+    // this rank already has its own statistics, but the packets of all the
+    // ranks are needed to tell which ones are lost
+    std::unordered_map<uint64_t, RemotePacket> packets;
+    for (uint32_t rank = 0; rank < m_systemCount; rank++)
+    {
+        const uint64_t* cursor = all.data() + offsets[rank];
+        DeserializeStats(cursor, rank != 0, packets);
+        NS_ASSERT(cursor == all.data() + offsets[rank] + sizes[rank]);
+    }
+
+    for (const auto& packet : packets)
+    {
+        const RemotePacket& state = packet.second;
+        if (state.received)
+        {
+            // count the hops on the ranks the packet went through before
+            GetStatsForFlow(FlowId(packet.first >> 32)).timesForwarded += state.timesForwarded;
+        }
+        else if (state.expired && !state.tracked && !state.dropped)
+        {
+            GetStatsForFlow(FlowId(packet.first >> 32)).lostPackets++;
+        }
+    }
+#endif
 }
 
 } // namespace ns3
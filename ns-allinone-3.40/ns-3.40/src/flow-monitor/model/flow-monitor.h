@@ -30,6 +30,7 @@
 #include "ns3/ptr.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -215,6 +216,15 @@ class FlowMonitor : public Object
                     FlowPacketId packetId,
                     uint32_t packetSize,
                     uint32_t reasonCode);
+    /// FlowProbe implementations are supposed to call this method, before
+    /// reporting that a known packet is being forwarded, received or
+    /// dropped, with the time when the packet was first transmitted.  In a
+    /// distributed simulation the packet may have been transmitted by a
+    /// node of another rank, and it is then tracked from that time on.
+    /// \param flowId flow identification
+    /// \param packetId Packet ID
+    /// \param txTime the time when the packet was first transmitted
+    void ReportRemoteTx(FlowId flowId, FlowPacketId packetId, const Time& txTime);
 
     /// Check right now for packets that appear to be lost
     void CheckForLostPackets();
@@ -277,6 +287,14 @@ class FlowMonitor : public Object
     /// Reset all the statistics
     void ResetAllStats();
 
+    /// Gather the statistics of all the ranks of a distributed simulation
+    /// in the FlowMonitor of rank 0, which can then serialize them.  The
+    /// flows crossing ranks are merged, and the packets that stopped being
+    /// tracked on a rank are only counted as lost if no other rank received
+    /// or dropped them.  This method must be called once by all the ranks,
+    /// after the simulation has run; it does nothing without MPI.
+    void GatherStats();
+
   protected:
     void NotifyConstructionCompleted() override;
     void DoDispose() override;
@@ -292,9 +310,11 @@ class FlowMonitor : public Object
 
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
+    /// FlowId --> FlowStats in m_flowStats, for the lookups of each packet
+    std::unordered_map<FlowId, FlowStats*> m_flowStatsIndex;
 
     /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
@@ -311,6 +331,17 @@ class FlowMonitor : public Object
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
 
+    uint32_t m_systemId;    //!< Rank of this FlowMonitor
+    uint32_t m_systemCount; //!< Number of ranks
+    /// (FlowId,PacketId) --> times forwarded on this rank, for the packets
+    /// that stopped being tracked in a distributed simulation; they may
+    /// have been received or dropped on another rank
+    std::unordered_map<uint64_t, uint32_t> m_expiredPackets;
+    /// (FlowId,PacketId) --> received (true) or dropped (false), for the
+    /// packets received or dropped on this rank in a distributed simulation;
+    /// they may have been forwarded on other ranks before
+    std::unordered_map<uint64_t, bool> m_completedPackets;
+
     /// Get the stats for a given flow
     /// \param flowId the Flow identification
     /// \returns the stats of the flow
@@ -318,6 +349,30 @@ class FlowMonitor : public Object
 
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
+
+    /// Append the statistics of this rank to a buffer, for GatherStats()
+    /// \param words the buffer
+    void SerializeStats(std::vector<uint64_t>& words) const;
+
+    /// State of a packet seen by several ranks of a distributed simulation
+    struct RemotePacket
+    {
+        uint32_t timesForwarded; //!< times forwarded on the ranks that did not complete it
+        bool expired;            //!< the packet stopped being tracked on a rank
+        bool tracked;            //!< the packet is still tracked on a rank
+        bool received;           //!< the packet was received on a rank
+        bool dropped;            //!< the packet was dropped on a rank
+    };
+
+    /// Add the statistics appended to a buffer by SerializeStats() on
+    /// another rank, and collect the state of its packets
+    /// \param words the buffer, advanced past the statistics
+    /// \param merge whether to add the statistics, or only to collect the
+    /// state of the packets
+    /// \param packets (FlowId,PacketId) --> RemotePacket
+    void DeserializeStats(const uint64_t*& words,
+                          bool merge,
+                          std::unordered_map<uint64_t, RemotePacket>& packets);
 };
 
 } // namespace ns3
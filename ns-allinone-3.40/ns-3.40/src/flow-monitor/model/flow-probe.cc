@@ -75,6 +75,26 @@ FlowProbe::AddPacketDropStats(FlowId flowId, uint32_t packetSize, uint32_t reaso
     flow.bytesDropped[reasonCode] += packetSize;
 }
 
+void
+FlowProbe::AddFlowStats(FlowId flowId, const FlowStats& stats)
+{
+    FlowStats& flow = m_stats[flowId];
+
+    if (flow.packetsDropped.size() < stats.packetsDropped.size())
+    {
+        flow.packetsDropped.resize(stats.packetsDropped.size(), 0);
+        flow.bytesDropped.resize(stats.packetsDropped.size(), 0);
+    }
+    for (uint32_t reasonCode = 0; reasonCode < stats.packetsDropped.size(); reasonCode++)
+    {
+        flow.packetsDropped[reasonCode] += stats.packetsDropped[reasonCode];
+        flow.bytesDropped[reasonCode] += stats.bytesDropped[reasonCode];
+    }
+    flow.delayFromFirstProbeSum += stats.delayFromFirstProbeSum;
+    flow.bytes += stats.bytes;
+    flow.packets += stats.packets;
+}
+
 FlowProbe::Stats
 FlowProbe::GetStats() const
 {
@@ -92,6 +92,11 @@ class FlowProbe : public Object
     /// \param packetSize the packet size
     /// \param reasonCode reason code for the drop
     void AddPacketDropStats(FlowId flowId, uint32_t packetSize, uint32_t reasonCode);
+    /// Add the flow stats collected by the same probe on another rank of
+    /// a distributed simulation
+    /// \param flowId the flow Identifier
+    /// \param stats the flow stats to add
+    void AddFlowStats(FlowId flowId, const FlowStats& stats);
 
     /// Get the partial flow statistics stored in this probe.  With this
     /// information you can, for example, find out what is the delay
@@ -19,6 +19,7 @@
 
 #include "ipv4-flow-classifier.h"
 
+#include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-header.h"
@@ -91,6 +92,16 @@ operator==(const Ipv4FlowClassifier::FiveTuple& t1, const Ipv4FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+size_t
+Ipv4FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t addresses = tuple.sourceAddress.Get();
+    addresses = (addresses << 32) | tuple.destinationAddress.Get();
+    uint64_t ports = tuple.protocol;
+    ports = (ports << 32) | (uint32_t(tuple.sourcePort) << 16) | tuple.destinationPort;
+    return std::hash<uint64_t>()(addresses ^ (ports * 0x9e3779b97f4a7c15ULL));
+}
+
 Ipv4FlowClassifier::Ipv4FlowClassifier()
 {
 }
@@ -148,31 +159,25 @@ Ipv4FlowClassifier::Classify(const Ipv4Header& ipHeader,
     auto insert = m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
+    FlowPacketId* packetId;
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
         insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        packetId = &m_flowPktIdMap[newFlowId];
+        *packetId = 0;
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        packetId = &m_flowPktIdMap[insert.first->second];
+        (*packetId)++;
     }
 
     // increment the counter of packets with the same DSCP value
-    Ipv4Header::DscpType dscp = ipHeader.GetDscp();
-    auto dscpInserter = m_flowDscpMap[insert.first->second].insert(
-        std::pair<Ipv4Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
-    {
-        m_flowDscpMap[insert.first->second][dscp]++;
-    }
+    m_flowDscpMap[insert.first->second][ipHeader.GetDscp()]++;
 
     *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_packetId = *packetId;
 
     return true;
 }
@@ -221,8 +226,11 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv4FlowClassifier>\n";
 
+    // sort the flows by tuple, so that the output does not depend on the hash table
+    std::map<FiveTuple, FlowId> flows(m_flowMap.begin(), m_flowMap.end());
+
     indent += 2;
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    for (auto iter = flows.begin(); iter != flows.end(); iter++)
     {
         Indent(os, indent);
         os << "<Flow flowId=\"" << iter->second << "\""
@@ -255,4 +263,56 @@ Ipv4FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "</Ipv4FlowClassifier>\n";
 }
 
+void
+Ipv4FlowClassifier::SerializeFlows(std::vector<uint64_t>& words) const
+{
+    for (const auto& flow : m_flowMap)
+    {
+        const FiveTuple& tuple = flow.first;
+        uint64_t ports = tuple.protocol;
+        ports = (ports << 32) | (uint32_t(tuple.sourcePort) << 16) | tuple.destinationPort;
+        auto dscps = m_flowDscpMap.find(flow.second);
+        words.push_back(flow.second);
+        words.push_back(tuple.sourceAddress.Get());
+        words.push_back(tuple.destinationAddress.Get());
+        words.push_back(ports);
+        words.push_back(m_flowPktIdMap.at(flow.second));
+        words.push_back(dscps == m_flowDscpMap.end() ? 0 : dscps->second.size());
+        if (dscps != m_flowDscpMap.end())
+        {
+            for (const auto& dscp : dscps->second)
+            {
+                words.push_back(dscp.first);
+                words.push_back(dscp.second);
+            }
+        }
+    }
+}
+
+void
+Ipv4FlowClassifier::DeserializeFlows(const uint64_t* begin, const uint64_t* end)
+{
+    while (begin < end)
+    {
+        FlowId flowId = *begin++;
+        FiveTuple tuple;
+        tuple.sourceAddress = Ipv4Address(uint32_t(*begin++));
+        tuple.destinationAddress = Ipv4Address(uint32_t(*begin++));
+        uint64_t ports = *begin++;
+        tuple.protocol = uint8_t(ports >> 32);
+        tuple.sourcePort = uint16_t(ports >> 16);
+        tuple.destinationPort = uint16_t(ports);
+        FlowPacketId packetId = *begin++;
+        m_flowMap.emplace(tuple, flowId);
+        FlowPacketId& lastPacketId = m_flowPktIdMap[flowId];
+        lastPacketId = std::max(lastPacketId, packetId);
+        std::map<Ipv4Header::DscpType, uint32_t>& dscps = m_flowDscpMap[flowId];
+        for (uint64_t n = *begin++; n > 0; n--, begin += 2)
+        {
+            dscps[Ipv4Header::DscpType(begin[0])] += uint32_t(begin[1]);
+        }
+    }
+    NS_ASSERT(begin == end);
+}
+
 } // namespace ns3
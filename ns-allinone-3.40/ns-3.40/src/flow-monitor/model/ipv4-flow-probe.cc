@@ -28,6 +28,7 @@
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/simulator.h"
 
 namespace ns3
 {
@@ -68,12 +69,14 @@ class Ipv4FlowProbeTag : public Tag
      * \param packetSize the packet size
      * \param src packet source address
      * \param dst packet destination address
+     * \param txTime the time when the packet was first transmitted
      */
     Ipv4FlowProbeTag(uint32_t flowId,
                      uint32_t packetId,
                      uint32_t packetSize,
                      Ipv4Address src,
-                     Ipv4Address dst);
+                     Ipv4Address dst,
+                     Time txTime);
     /**
      * \brief Set the flow identifier
      * \param flowId the flow identifier
@@ -104,6 +107,11 @@ class Ipv4FlowProbeTag : public Tag
      * \returns the packet size
      */
     uint32_t GetPacketSize() const;
+    /**
+     * \brief Get the time when the packet was first transmitted
+     * \returns the time when the packet was first transmitted
+     */
+    Time GetTxTime() const;
     /**
      * \brief Checks if the addresses stored in tag are matching
      * the arguments.
@@ -120,10 +128,13 @@ class Ipv4FlowProbeTag : public Tag
     uint32_t m_flowId;     //!< flow identifier
     uint32_t m_packetId;   //!< packet identifier
     uint32_t m_packetSize; //!< packet size
+    Time m_txTime;         //!< time when the packet was first transmitted
     Ipv4Address m_src;     //!< IP source
     Ipv4Address m_dst;     //!< IP destination
 };
 
+NS_OBJECT_ENSURE_REGISTERED(Ipv4FlowProbeTag);
+
 TypeId
 Ipv4FlowProbeTag::GetTypeId()
 {
@@ -143,7 +154,7 @@ Ipv4FlowProbeTag::GetInstanceTypeId() const
 uint32_t
 Ipv4FlowProbeTag::GetSerializedSize() const
 {
-    return 4 + 4 + 4 + 8;
+    return 4 + 4 + 4 + 8 + 8;
 }
 
 void
@@ -158,6 +169,7 @@ Ipv4FlowProbeTag::Serialize(TagBuffer buf) const
     buf.Write(tBuf, 4);
     m_dst.Serialize(tBuf);
     buf.Write(tBuf, 4);
+    buf.WriteU64(m_txTime.GetTimeStep());
 }
 
 void
@@ -172,6 +184,7 @@ Ipv4FlowProbeTag::Deserialize(TagBuffer buf)
     m_src = Ipv4Address::Deserialize(tBuf);
     buf.Read(tBuf, 4);
     m_dst = Ipv4Address::Deserialize(tBuf);
+    m_txTime = TimeStep(buf.ReadU64());
 }
 
 void
@@ -191,11 +204,13 @@ Ipv4FlowProbeTag::Ipv4FlowProbeTag(uint32_t flowId,
                                    uint32_t packetId,
                                    uint32_t packetSize,
                                    Ipv4Address src,
-                                   Ipv4Address dst)
+                                   Ipv4Address dst,
+                                   Time txTime)
     : Tag(),
       m_flowId(flowId),
       m_packetId(packetId),
       m_packetSize(packetSize),
+      m_txTime(txTime),
       m_src(src),
       m_dst(dst)
 {
@@ -237,6 +252,12 @@ Ipv4FlowProbeTag::GetPacketSize() const
     return m_packetSize;
 }
 
+Time
+Ipv4FlowProbeTag::GetTxTime() const
+{
+    return m_txTime;
+}
+
 bool
 Ipv4FlowProbeTag::IsSrcDstValid(Ipv4Address src, Ipv4Address dst) const
 {
@@ -355,7 +376,8 @@ Ipv4FlowProbe::SendOutgoingLogger(const Ipv4Header& ipHeader,
                               packetId,
                               size,
                               ipHeader.GetSource(),
-                              ipHeader.GetDestination());
+                              ipHeader.GetDestination(),
+                              Simulator::Now());
         ipPayload->AddByteTag(fTag);
     }
 }
@@ -387,6 +409,7 @@ Ipv4FlowProbe::ForwardLogger(const Ipv4Header& ipHeader,
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportForwarding (" << this << ", " << flowId << ", " << packetId << ", "
                                           << size << ");");
+        m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
         m_flowMonitor->ReportForwarding(this, flowId, packetId, size);
     }
 }
@@ -413,6 +436,7 @@ Ipv4FlowProbe::ForwardUpLogger(const Ipv4Header& ipHeader,
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportLastRx (" << this << ", " << flowId << ", " << packetId << ", " << size
                                       << "); " << ipHeader << *ipPayload);
+        m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
         m_flowMonitor->ReportLastRx(this, flowId, packetId, size);
     }
 }
@@ -489,6 +513,7 @@ Ipv4FlowProbe::DropLogger(const Ipv4Header& ipHeader,
             NS_FATAL_ERROR("Unexpected drop reason code " << reason);
         }
 
+        m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
         m_flowMonitor->ReportDrop(this, flowId, packetId, size, myReason);
     }
 }
@@ -511,6 +536,7 @@ Ipv4FlowProbe::QueueDropLogger(Ptr<const Packet> ipPayload)
     NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
                           << DROP_QUEUE << "); ");
 
+    m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
     m_flowMonitor->ReportDrop(this, flowId, packetId, size, DROP_QUEUE);
 }
 
@@ -532,6 +558,7 @@ Ipv4FlowProbe::QueueDiscDropLogger(Ptr<const QueueDiscItem> item)
     NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
                           << DROP_QUEUE_DISC << "); ");
 
+    m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
     m_flowMonitor->ReportDrop(this, flowId, packetId, size, DROP_QUEUE_DISC);
 }
 
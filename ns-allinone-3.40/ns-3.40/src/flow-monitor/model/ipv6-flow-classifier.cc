@@ -20,6 +20,7 @@
 
 #include "ipv6-flow-classifier.h"
 
+#include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-header.h"
@@ -92,6 +93,17 @@ operator==(const Ipv6FlowClassifier::FiveTuple& t1, const Ipv6FlowClassifier::Fi
             t1.sourcePort == t2.sourcePort && t1.destinationPort == t2.destinationPort);
 }
 
+size_t
+Ipv6FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    Ipv6AddressHash addressHash;
+    uint64_t ports = tuple.protocol;
+    ports = (ports << 32) | (uint32_t(tuple.sourcePort) << 16) | tuple.destinationPort;
+    uint64_t hash = addressHash(tuple.sourceAddress);
+    hash = hash * 31 + addressHash(tuple.destinationAddress);
+    return std::hash<uint64_t>()(hash ^ (ports * 0x9e3779b97f4a7c15ULL));
+}
+
 Ipv6FlowClassifier::Ipv6FlowClassifier()
 {
 }
@@ -149,31 +161,25 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
     auto insert = m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
+    FlowPacketId* packetId;
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
         insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        packetId = &m_flowPktIdMap[newFlowId];
+        *packetId = 0;
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        packetId = &m_flowPktIdMap[insert.first->second];
+        (*packetId)++;
     }
 
     // increment the counter of packets with the same DSCP value
-    Ipv6Header::DscpType dscp = ipHeader.GetDscp();
-    auto dscpInserter = m_flowDscpMap[insert.first->second].insert(
-        std::pair<Ipv6Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
-    {
-        m_flowDscpMap[insert.first->second][dscp]++;
-    }
+    m_flowDscpMap[insert.first->second][ipHeader.GetDscp()]++;
 
     *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_packetId = *packetId;
 
     return true;
 }
@@ -222,8 +228,11 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     Indent(os, indent);
     os << "<Ipv6FlowClassifier>\n";
 
+    // sort the flows by tuple, so that the output does not depend on the hash table
+    std::map<FiveTuple, FlowId> flows(m_flowMap.begin(), m_flowMap.end());
+
     indent += 2;
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    for (auto iter = flows.begin(); iter != flows.end(); iter++)
     {
         Indent(os, indent);
         os << "<Flow flowId=\"" << iter->second << "\""
@@ -256,4 +265,99 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "</Ipv6FlowClassifier>\n";
 }
 
+/**
+ * Append an IPv6 address to a buffer as two words
+ *
+ * \param words the buffer
+ * \param address the address
+ */
+static void
+SerializeAddress(std::vector<uint64_t>& words, const Ipv6Address& address)
+{
+    uint8_t bytes[16];
+    address.GetBytes(bytes);
+    for (uint32_t i = 0; i < 16; i += 8)
+    {
+        uint64_t word = 0;
+        for (uint32_t j = 0; j < 8; j++)
+        {
+            word = (word << 8) | bytes[i + j];
+        }
+        words.push_back(word);
+    }
+}
+
+/**
+ * Read an IPv6 address appended to a buffer by SerializeAddress()
+ *
+ * \param words the buffer, advanced past the address
+ * \returns the address
+ */
+static Ipv6Address
+DeserializeAddress(const uint64_t*& words)
+{
+    uint8_t bytes[16];
+    for (uint32_t i = 0; i < 16; i += 8)
+    {
+        uint64_t word = *words++;
+        for (uint32_t j = 0; j < 8; j++)
+        {
+            bytes[i + j] = uint8_t(word >> (56 - 8 * j));
+        }
+    }
+    return Ipv6Address(bytes);
+}
+
+void
+Ipv6FlowClassifier::SerializeFlows(std::vector<uint64_t>& words) const
+{
+    for (const auto& flow : m_flowMap)
+    {
+        const FiveTuple& tuple = flow.first;
+        uint64_t ports = tuple.protocol;
+        ports = (ports << 32) | (uint32_t(tuple.sourcePort) << 16) | tuple.destinationPort;
+        auto dscps = m_flowDscpMap.find(flow.second);
+        words.push_back(flow.second);
+        SerializeAddress(words, tuple.sourceAddress);
+        SerializeAddress(words, tuple.destinationAddress);
+        words.push_back(ports);
+        words.push_back(m_flowPktIdMap.at(flow.second));
+        words.push_back(dscps == m_flowDscpMap.end() ? 0 : dscps->second.size());
+        if (dscps != m_flowDscpMap.end())
+        {
+            for (const auto& dscp : dscps->second)
+            {
+                words.push_back(dscp.first);
+                words.push_back(dscp.second);
+            }
+        }
+    }
+}
+
+void
+Ipv6FlowClassifier::DeserializeFlows(const uint64_t* begin, const uint64_t* end)
+{
+    while (begin < end)
+    {
+        FlowId flowId = *begin++;
+        FiveTuple tuple;
+        tuple.sourceAddress = DeserializeAddress(begin);
+        tuple.destinationAddress = DeserializeAddress(begin);
+        uint64_t ports = *begin++;
+        tuple.protocol = uint8_t(ports >> 32);
+        tuple.sourcePort = uint16_t(ports >> 16);
+        tuple.destinationPort = uint16_t(ports);
+        FlowPacketId packetId = *begin++;
+        m_flowMap.emplace(tuple, flowId);
+        FlowPacketId& lastPacketId = m_flowPktIdMap[flowId];
+        lastPacketId = std::max(lastPacketId, packetId);
+        std::map<Ipv6Header::DscpType, uint32_t>& dscps = m_flowDscpMap[flowId];
+        for (uint64_t n = *begin++; n > 0; n--, begin += 2)
+        {
+            dscps[Ipv6Header::DscpType(begin[0])] += uint32_t(begin[1]);
+        }
+    }
+    NS_ASSERT(begin == end);
+}
+
 } // namespace ns3
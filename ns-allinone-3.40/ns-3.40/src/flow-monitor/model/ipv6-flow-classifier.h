@@ -27,6 +27,7 @@
 
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -50,6 +51,14 @@ class Ipv6FlowClassifier : public FlowClassifier
         uint16_t destinationPort;       //!< Destination port
     };
 
+    /// Hash function of a FiveTuple
+    struct FiveTupleHash
+    {
+        /// \param tuple the FiveTuple
+        /// \returns the hash of the tuple
+        size_t operator()(const FiveTuple& tuple) const;
+    };
+
     Ipv6FlowClassifier();
 
     /// \brief try to classify the packet into flow-id and packet-id
@@ -92,14 +101,16 @@ class Ipv6FlowClassifier : public FlowClassifier
     std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> GetDscpCounts(FlowId flowId) const;
 
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
+    void SerializeFlows(std::vector<uint64_t>& words) const override;
+    void DeserializeFlows(const uint64_t* begin, const uint64_t* end) override;
 
   private:
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
     /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+    std::unordered_map<FlowId, FlowPacketId> m_flowPktIdMap;
     /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
+    std::unordered_map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
 };
 
 /**
@@ -29,6 +29,7 @@
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/simulator.h"
 
 namespace ns3
 {
@@ -67,8 +68,9 @@ class Ipv6FlowProbeTag : public Tag
      * \param flowId the flow identifier
      * \param packetId the packet identifier
      * \param packetSize the packet size
+     * \param txTime the time when the packet was first transmitted
      */
-    Ipv6FlowProbeTag(uint32_t flowId, uint32_t packetId, uint32_t packetSize);
+    Ipv6FlowProbeTag(uint32_t flowId, uint32_t packetId, uint32_t packetSize, Time txTime);
     /**
      * \brief Set the flow identifier
      * \param flowId the flow identifier
@@ -99,13 +101,21 @@ class Ipv6FlowProbeTag : public Tag
      * \returns the packet size
      */
     uint32_t GetPacketSize() const;
+    /**
+     * \brief Get the time when the packet was first transmitted
+     * \returns the time when the packet was first transmitted
+     */
+    Time GetTxTime() const;
 
   private:
     uint32_t m_flowId;     //!< flow identifier
     uint32_t m_packetId;   //!< packet identifier
     uint32_t m_packetSize; //!< packet size
+    Time m_txTime;         //!< time when the packet was first transmitted
 };
 
+NS_OBJECT_ENSURE_REGISTERED(Ipv6FlowProbeTag);
+
 TypeId
 Ipv6FlowProbeTag::GetTypeId()
 {
@@ -125,7 +135,7 @@ Ipv6FlowProbeTag::GetInstanceTypeId() const
 uint32_t
 Ipv6FlowProbeTag::GetSerializedSize() const
 {
-    return 4 + 4 + 4;
+    return 4 + 4 + 4 + 8;
 }
 
 void
@@ -134,6 +144,7 @@ Ipv6FlowProbeTag::Serialize(TagBuffer buf) const
     buf.WriteU32(m_flowId);
     buf.WriteU32(m_packetId);
     buf.WriteU32(m_packetSize);
+    buf.WriteU64(m_txTime.GetTimeStep());
 }
 
 void
@@ -142,6 +153,7 @@ Ipv6FlowProbeTag::Deserialize(TagBuffer buf)
     m_flowId = buf.ReadU32();
     m_packetId = buf.ReadU32();
     m_packetSize = buf.ReadU32();
+    m_txTime = TimeStep(buf.ReadU64());
 }
 
 void
@@ -157,11 +169,15 @@ Ipv6FlowProbeTag::Ipv6FlowProbeTag()
 {
 }
 
-Ipv6FlowProbeTag::Ipv6FlowProbeTag(uint32_t flowId, uint32_t packetId, uint32_t packetSize)
+Ipv6FlowProbeTag::Ipv6FlowProbeTag(uint32_t flowId,
+                                   uint32_t packetId,
+                                   uint32_t packetSize,
+                                   Time txTime)
     : Tag(),
       m_flowId(flowId),
       m_packetId(packetId),
-      m_packetSize(packetSize)
+      m_packetSize(packetSize),
+      m_txTime(txTime)
 {
 }
 
@@ -201,6 +217,12 @@ Ipv6FlowProbeTag::GetPacketSize() const
     return m_packetSize;
 }
 
+Time
+Ipv6FlowProbeTag::GetTxTime() const
+{
+    return m_txTime;
+}
+
 ////////////////////////////////////////
 // Ipv6FlowProbe class implementation //
 ////////////////////////////////////////
@@ -294,7 +316,7 @@ Ipv6FlowProbe::SendOutgoingLogger(const Ipv6Header& ipHeader,
 
         // tag the packet with the flow id and packet id, so that the packet can be identified even
         // when Ipv6Header is not accessible at some non-IPv6 protocol layer
-        Ipv6FlowProbeTag fTag(flowId, packetId, size);
+        Ipv6FlowProbeTag fTag(flowId, packetId, size, Simulator::Now());
         ipPayload->AddByteTag(fTag);
     }
 }
@@ -315,6 +337,7 @@ Ipv6FlowProbe::ForwardLogger(const Ipv6Header& ipHeader,
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportForwarding (" << this << ", " << flowId << ", " << packetId << ", "
                                           << size << ");");
+        m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
         m_flowMonitor->ReportForwarding(this, flowId, packetId, size);
     }
 }
@@ -335,6 +358,7 @@ Ipv6FlowProbe::ForwardUpLogger(const Ipv6Header& ipHeader,
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportLastRx (" << this << ", " << flowId << ", " << packetId << ", " << size
                                       << ");");
+        m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
         m_flowMonitor->ReportLastRx(this, flowId, packetId, size);
     }
 }
@@ -418,6 +442,7 @@ Ipv6FlowProbe::DropLogger(const Ipv6Header& ipHeader,
             NS_FATAL_ERROR("Unexpected drop reason code " << reason);
         }
 
+        m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
         m_flowMonitor->ReportDrop(this, flowId, packetId, size, myReason);
     }
 }
@@ -440,6 +465,7 @@ Ipv6FlowProbe::QueueDropLogger(Ptr<const Packet> ipPayload)
     NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
                           << DROP_QUEUE << "); ");
 
+    m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
     m_flowMonitor->ReportDrop(this, flowId, packetId, size, DROP_QUEUE);
 }
 
@@ -461,6 +487,7 @@ Ipv6FlowProbe::QueueDiscDropLogger(Ptr<const QueueDiscItem> item)
     NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
                           << DROP_QUEUE_DISC << "); ");
 
+    m_flowMonitor->ReportRemoteTx(flowId, packetId, fTag.GetTxTime());
     m_flowMonitor->ReportDrop(this, flowId, packetId, size, DROP_QUEUE_DISC);
 }
 
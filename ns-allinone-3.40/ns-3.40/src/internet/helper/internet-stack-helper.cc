@@ -297,13 +297,22 @@ InternetStackHelper::CreateAndAggregateObjectFromTypeId(Ptr<Node> node, const st
 void
 InternetStackHelper::Install(Ptr<Node> node) const
 {
+    // A ghost node only needs its addresses and its routing protocol
+    bool ghost = node->IsGhost();
+
     if (m_ipv4Enabled)
     {
         /* IPv4 stack */
-        CreateAndAggregateObjectFromTypeId(node, "ns3::ArpL3Protocol");
+        if (!ghost)
+        {
+            CreateAndAggregateObjectFromTypeId(node, "ns3::ArpL3Protocol");
+        }
         CreateAndAggregateObjectFromTypeId(node, "ns3::Ipv4L3Protocol");
-        CreateAndAggregateObjectFromTypeId(node, "ns3::Icmpv4L4Protocol");
-        if (!m_ipv4ArpJitterEnabled)
+        if (!ghost)
+        {
+            CreateAndAggregateObjectFromTypeId(node, "ns3::Icmpv4L4Protocol");
+        }
+        if (!m_ipv4ArpJitterEnabled && !ghost)
         {
             Ptr<ArpL3Protocol> arp = node->GetObject<ArpL3Protocol>();
             NS_ASSERT(arp);
@@ -344,6 +353,16 @@ InternetStackHelper::Install(Ptr<Node> node) const
         ipv6->RegisterOptions();
     }
 
+    if (ghost)
+    {
+        // IPv6 can not work without the traffic control layer
+        if (m_ipv6Enabled)
+        {
+            CreateAndAggregateObjectFromTypeId(node, "ns3::TrafficControlLayer");
+        }
+        return;
+    }
+
     if (m_ipv4Enabled || m_ipv6Enabled)
     {
         CreateAndAggregateObjectFromTypeId(node, "ns3::TrafficControlLayer");
@@ -617,7 +636,7 @@ Ipv4L3ProtocolDropSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
 
     Ptr<Packet> p = packet->Copy();
     p->AddHeader(header);
-    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << '\n';
 }
 
 /**
@@ -640,7 +659,7 @@ Ipv4L3ProtocolTxSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
         NS_LOG_INFO("Ignoring packet to/from interface " << interface);
         return;
     }
-    *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << *packet << std::endl;
+    *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << *packet << '\n';
 }
 
 /**
@@ -663,7 +682,7 @@ Ipv4L3ProtocolRxSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
         return;
     }
 
-    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *packet << std::endl;
+    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *packet << '\n';
 }
 
 /**
@@ -702,10 +721,10 @@ Ipv4L3ProtocolDropSinkWithContext(Ptr<OutputStreamWrapper> stream,
     p->AddHeader(header);
 #ifdef INTERFACE_CONTEXT
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << "("
-                         << interface << ") " << *p << std::endl;
+                         << interface << ") " << *p << '\n';
 #else
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+                         << '\n';
 #endif
 }
 
@@ -733,10 +752,10 @@ Ipv4L3ProtocolTxSinkWithContext(Ptr<OutputStreamWrapper> stream,
 
 #ifdef INTERFACE_CONTEXT
     *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << context << "("
-                         << interface << ") " << *packet << std::endl;
+                         << interface << ") " << *packet << '\n';
 #else
     *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << context << " "
-                         << *packet << std::endl;
+                         << *packet << '\n';
 #endif
 }
 
@@ -764,10 +783,10 @@ Ipv4L3ProtocolRxSinkWithContext(Ptr<OutputStreamWrapper> stream,
 
 #ifdef INTERFACE_CONTEXT
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << "("
-                         << interface << ") " << *packet << std::endl;
+                         << interface << ") " << *packet << '\n';
 #else
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << " "
-                         << *packet << std::endl;
+                         << *packet << '\n';
 #endif
 }
 
@@ -961,7 +980,7 @@ Ipv6L3ProtocolDropSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
 
     Ptr<Packet> p = packet->Copy();
     p->AddHeader(header);
-    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << '\n';
 }
 
 /**
@@ -984,7 +1003,7 @@ Ipv6L3ProtocolTxSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
         return;
     }
 
-    *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << *packet << std::endl;
+    *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << *packet << '\n';
 }
 
 /**
@@ -1007,7 +1026,7 @@ Ipv6L3ProtocolRxSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
         return;
     }
 
-    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *packet << std::endl;
+    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *packet << '\n';
 }
 
 /**
@@ -1046,10 +1065,10 @@ Ipv6L3ProtocolDropSinkWithContext(Ptr<OutputStreamWrapper> stream,
     p->AddHeader(header);
 #ifdef INTERFACE_CONTEXT
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << "("
-                         << interface << ") " << *p << std::endl;
+                         << interface << ") " << *p << '\n';
 #else
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+                         << '\n';
 #endif
 }
 
@@ -1077,10 +1096,10 @@ Ipv6L3ProtocolTxSinkWithContext(Ptr<OutputStreamWrapper> stream,
 
 #ifdef INTERFACE_CONTEXT
     *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << context << "("
-                         << interface << ") " << *packet << std::endl;
+                         << interface << ") " << *packet << '\n';
 #else
     *stream->GetStream() << "t " << Simulator::Now().GetSeconds() << " " << context << " "
-                         << *packet << std::endl;
+                         << *packet << '\n';
 #endif
 }
 
@@ -1108,10 +1127,10 @@ Ipv6L3ProtocolRxSinkWithContext(Ptr<OutputStreamWrapper> stream,
 
 #ifdef INTERFACE_CONTEXT
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << "("
-                         << interface << ") " << *packet << std::endl;
+                         << interface << ") " << *packet << '\n';
 #else
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << " "
-                         << *packet << std::endl;
+                         << *packet << '\n';
 #endif
 }
 
@@ -58,20 +58,22 @@ operator<<(std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream&
 operator<<(std::ostream& os, const CandidateQueue& q)
 {
-    const CandidateQueue::CandidateList_t& list = q.m_candidates;
+    CandidateQueue::CandidateList_t list = q.m_candidates;
+    std::sort(list.begin(), list.end(), &CandidateQueue::CompareCandidate);
 
     os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
     for (auto iter = list.begin(); iter != list.end(); iter++)
     {
-        os << "<" << (*iter)->GetVertexId() << ", " << (*iter)->GetDistanceFromRoot() << ", "
-           << (*iter)->GetVertexType() << ">" << std::endl;
+        os << "<" << iter->vertex->GetVertexId() << ", " << iter->vertex->GetDistanceFromRoot()
+           << ", " << iter->vertex->GetVertexType() << ">" << std::endl;
     }
     os << "*** CandidateQueue End ***";
     return os;
 }
 
 CandidateQueue::CandidateQueue()
-    : m_candidates()
+    : m_candidates(),
+      m_order(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -99,11 +101,10 @@ CandidateQueue::Push(SPFVertex* vNew)
 {
     NS_LOG_FUNCTION(this << vNew);
 
-    auto i = std::upper_bound(m_candidates.begin(),
-                              m_candidates.end(),
-                              vNew,
-                              &CandidateQueue::CompareSPFVertex);
-    m_candidates.insert(i, vNew);
+    m_candidates.push_back({vNew, m_order++});
+    m_positions[vNew] = m_candidates.size() - 1;
+    m_ids.emplace(vNew->GetVertexId(), vNew);
+    SiftUp(m_candidates.size() - 1);
 }
 
 SPFVertex*
@@ -115,8 +116,25 @@ CandidateQueue::Pop()
         return nullptr;
     }
 
-    SPFVertex* v = m_candidates.front();
-    m_candidates.pop_front();
+    SPFVertex* v = m_candidates.front().vertex;
+    m_positions.erase(v);
+    auto range = m_ids.equal_range(v->GetVertexId());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == v)
+        {
+            m_ids.erase(i);
+            break;
+        }
+    }
+
+    Candidate last = m_candidates.back();
+    m_candidates.pop_back();
+    if (!m_candidates.empty())
+    {
+        Place(0, last);
+        SiftDown(0);
+    }
     return v;
 }
 
@@ -129,7 +147,7 @@ CandidateQueue::Top() const
         return nullptr;
     }
 
-    return m_candidates.front();
+    return m_candidates.front().vertex;
 }
 
 bool
@@ -150,18 +168,20 @@ SPFVertex*
 CandidateQueue::Find(const Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this);
-    auto i = m_candidates.begin();
 
-    for (; i != m_candidates.end(); i++)
+    // Return the first one to be popped, should several vertices share the id
+    const Candidate* found = nullptr;
+    auto range = m_ids.equal_range(addr);
+    for (auto i = range.first; i != range.second; i++)
     {
-        SPFVertex* v = *i;
-        if (v->GetVertexId() == addr)
+        const Candidate& c = m_candidates[m_positions.at(i->second)];
+        if (!found || CompareCandidate(c, *found))
         {
-            return v;
+            found = &c;
         }
     }
 
-    return nullptr;
+    return found ? found->vertex : nullptr;
 }
 
 void
@@ -169,11 +189,78 @@ CandidateQueue::Reorder()
 {
     NS_LOG_FUNCTION(this);
 
-    m_candidates.sort(&CandidateQueue::CompareSPFVertex);
+    for (uint32_t i = m_candidates.size() / 2; i-- > 0;)
+    {
+        SiftDown(i);
+    }
+    NS_LOG_LOGIC("After reordering the CandidateQueue");
+    NS_LOG_LOGIC(*this);
+}
+
+void
+CandidateQueue::Reorder(SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+
+    auto position = m_positions.find(v);
+    NS_ASSERT_MSG(position != m_positions.end(), "Vertex " << v << " is not a candidate");
+    uint32_t i = position->second;
+    m_candidates[i].order = m_order++;
+    SiftUp(i);
     NS_LOG_LOGIC("After reordering the CandidateQueue");
     NS_LOG_LOGIC(*this);
 }
 
+void
+CandidateQueue::SiftUp(uint32_t i)
+{
+    Candidate c = m_candidates[i];
+    while (i > 0)
+    {
+        uint32_t parent = (i - 1) / 2;
+        if (!CompareCandidate(c, m_candidates[parent]))
+        {
+            break;
+        }
+        Place(i, m_candidates[parent]);
+        i = parent;
+    }
+    Place(i, c);
+}
+
+void
+CandidateQueue::SiftDown(uint32_t i)
+{
+    Candidate c = m_candidates[i];
+    uint32_t size = m_candidates.size();
+    for (;;)
+    {
+        uint32_t child = 2 * i + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && CompareCandidate(m_candidates[child + 1], m_candidates[child]))
+        {
+            child++;
+        }
+        if (!CompareCandidate(m_candidates[child], c))
+        {
+            break;
+        }
+        Place(i, m_candidates[child]);
+        i = child;
+    }
+    Place(i, c);
+}
+
+void
+CandidateQueue::Place(uint32_t i, const Candidate& c)
+{
+    m_candidates[i] = c;
+    m_positions[c.vertex] = i;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -202,4 +289,18 @@ CandidateQueue::CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2)
     return result;
 }
 
+bool
+CandidateQueue::CompareCandidate(const Candidate& c1, const Candidate& c2)
+{
+    if (CompareSPFVertex(c1.vertex, c2.vertex))
+    {
+        return true;
+    }
+    if (CompareSPFVertex(c2.vertex, c1.vertex))
+    {
+        return false;
+    }
+    return c1.order < c2.order;
+}
+
 } // namespace ns3
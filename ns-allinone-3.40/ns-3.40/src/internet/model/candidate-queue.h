@@ -22,8 +22,9 @@
 
 #include "ns3/ipv4-address.h"
 
-#include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -48,6 +49,11 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple
  * enhanced priority queue.
+ *
+ * The candidates are kept in a binary heap, indexed by vertex and by
+ * vertex id, so that Push (), Pop () and Reorder (v) take a logarithmic
+ * time and Find () a constant one.  Vertices ranked equally are popped in
+ * the order they were pushed, or last reordered, in.
  */
 class CandidateQueue
 {
@@ -159,6 +165,18 @@ class CandidateQueue
      */
     void Reorder();
 
+    /**
+     * @brief Reorders the Candidate Queue after the value of
+     * m_distanceFromRoot of one of its vertices decreased.
+     *
+     * The vertex is then popped after the vertices of the same rank
+     * already in the queue.
+     *
+     * @see SPFVertex
+     * @param v The Shortest Path First Vertex whose distance decreased.
+     */
+    void Reorder(SPFVertex* v);
+
   private:
     /**
      * \brief return true if v1 < v2
@@ -173,8 +191,46 @@ class CandidateQueue
      */
     static bool CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2);
 
-    typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-    CandidateList_t m_candidates;                  //!< SPFVertex candidates
+    /// A candidate in the heap
+    struct Candidate
+    {
+        SPFVertex* vertex; //!< The vertex
+        uint64_t order;    //!< Push order, breaking the ties of CompareSPFVertex
+    };
+
+    /**
+     * \param c1 first operand
+     * \param c2 second operand
+     * \return True if c1 should be popped before c2; false otherwise
+     */
+    static bool CompareCandidate(const Candidate& c1, const Candidate& c2);
+
+    /**
+     * \brief Move a candidate towards the top of the heap.
+     * \param i The position of the candidate.
+     */
+    void SiftUp(uint32_t i);
+
+    /**
+     * \brief Move a candidate towards the bottom of the heap.
+     * \param i The position of the candidate.
+     */
+    void SiftDown(uint32_t i);
+
+    /**
+     * \brief Store a candidate at a position of the heap.
+     * \param i The position.
+     * \param c The candidate.
+     */
+    void Place(uint32_t i, const Candidate& c);
+
+    typedef std::vector<Candidate> CandidateList_t; //!< heap of SPFVertex candidates
+    CandidateList_t m_candidates;                   //!< SPFVertex candidates
+    /// Position of each candidate in m_candidates
+    std::unordered_map<const SPFVertex*, uint32_t> m_positions;
+    /// Candidates of each vertex id
+    std::unordered_multimap<Ipv4Address, SPFVertex*, Ipv4AddressHash> m_ids;
+    uint64_t m_order; //!< Order of the next candidate pushed
 
     /**
      * \brief Stream insertion operator.
@@ -30,13 +30,18 @@
 
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -45,6 +50,16 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * Number of threads computing the routes, 0 for one per hardware thread.
+ */
+static GlobalValue g_globalRoutingThreads(
+    "GlobalRoutingThreads",
+    "The number of threads computing the global routes, 0 for one per hardware thread",
+    UintegerValue(1),
+    MakeUintegerChecker<uint32_t>());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -471,7 +486,26 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     }
     else
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        auto inserted = m_database.insert(LSDBPair_t(addr, lsa));
+        if (!inserted.second)
+        {
+            return;
+        }
+        // Index the transit links; GetLSAByLinkData () returns the first LSA
+        // of the database, in address order, with a matching link
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            auto indexed = m_linkDataIndex.emplace(lr->GetLinkData(), inserted.first);
+            if (!indexed.second && addr < indexed.first->second->first)
+            {
+                indexed.first->second = inserted.first;
+            }
+        }
     }
 }
 
@@ -496,12 +530,10 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_database.find(addr);
+    if (i != m_database.end())
     {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
+        return i->second;
     }
     return nullptr;
 }
@@ -511,25 +543,36 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the LinkData of one of its TransitNetwork link records.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_linkDataIndex.find(addr);
+    if (i != m_linkDataIndex.end())
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
-        {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
-        }
+        return i->second->second;
     }
     return nullptr;
 }
 
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Copy() const
+{
+    NS_LOG_FUNCTION(this);
+    auto lsdb = new GlobalRouteManagerLSDB();
+    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    {
+        auto lsa = new GlobalRoutingLSA();
+        *lsa = *i->second;
+        lsdb->Insert(i->first, lsa);
+    }
+    for (uint32_t j = 0; j < m_extdatabase.size(); j++)
+    {
+        auto lsa = new GlobalRoutingLSA();
+        *lsa = *m_extdatabase.at(j);
+        lsdb->Insert(lsa->GetLinkStateId(), lsa);
+    }
+    return lsdb;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
@@ -696,6 +739,8 @@ GlobalRouteManagerImpl::InitializeRoutes()
     // Walk the list of nodes in the system.
     //
     NS_LOG_INFO("About to start SPF calculation");
+    std::vector<Ptr<GlobalRouter>> routers;
+    uint32_t systemId = Simulator::GetSystemId();
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
         Ptr<Node> node = *i;
@@ -705,7 +750,6 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
 
-        uint32_t systemId = Simulator::GetSystemId();
         // Ignore nodes that are not assigned to our systemId (distributed sim)
         if (node->GetSystemId() != systemId)
         {
@@ -718,7 +762,57 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            routers.push_back(rtr);
+        }
+    }
+
+    UintegerValue threadsValue;
+    g_globalRoutingThreads.GetValue(threadsValue);
+    std::size_t threads = threadsValue.Get();
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    threads = std::min(threads, routers.size());
+
+    if (threads <= 1)
+    {
+        for (const auto& rtr : routers)
+        {
+            SPFCalculate(rtr->GetRouterId(), rtr);
+        }
+    }
+    else
+    {
+        //
+        // Each root is computed by one thread, which only touches the objects
+        // of the root node.  The LSAs are marked during the computation, so
+        // each thread works on its own copy of the LSDB.
+        //
+        NS_LOG_INFO("Computing " << routers.size() << " routers on " << threads << " threads");
+        std::vector<std::unique_ptr<GlobalRouteManagerImpl>> workers;
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            workers.emplace_back(new GlobalRouteManagerImpl());
+            delete workers.back()->m_lsdb;
+            workers.back()->m_lsdb = m_lsdb->Copy();
+        }
+
+        std::atomic<std::size_t> next(0);
+        std::vector<std::thread> pool;
+        for (const auto& worker : workers)
+        {
+            GlobalRouteManagerImpl* impl = worker.get();
+            pool.emplace_back([impl, &routers, &next]() {
+                for (std::size_t i = next++; i < routers.size(); i = next++)
+                {
+                    impl->SPFCalculate(routers[i]->GetRouterId(), routers[i]);
+                }
+            });
+        }
+        for (auto& thread : pool)
+        {
+            thread.join();
         }
     }
     NS_LOG_INFO("Finished SPF calculation");
@@ -952,7 +1046,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                     // If we've changed the cost to get to the vertex represented by <w>, we
                     // must reorder the priority queue keyed to that cost.
                     //
-                    candidate.Reorder();
+                    candidate.Reorder(cw);
                 }
             } // new lower cost path found
         }     // end W is already on the candidate list
@@ -1307,9 +1401,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
+                    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
                     NS_ASSERT(gr);
                     gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
                                           Ipv4Mask("0.0.0.0"),
@@ -1333,6 +1425,40 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
 
+    Ptr<GlobalRouter> router;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
+        {
+            router = rtr;
+            break;
+        }
+    }
+    SPFCalculate(root, router);
+}
+
+void
+GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root, const Ptr<GlobalRouter>& router)
+{
+    NS_LOG_FUNCTION(this << root << router);
+
+    //
+    // Look up the objects of the root node once; the routes found below are
+    // all added to its routing protocol.
+    //
+    m_spfrootIpv4 = nullptr;
+    m_spfrootRouting = nullptr;
+    if (router)
+    {
+        m_spfrootIpv4 = router->GetObject<Ipv4>();
+        NS_ASSERT_MSG(m_spfrootIpv4,
+                      "GlobalRouteManagerImpl::SPFCalculate (): "
+                      "GetObject for <Ipv4> interface failed");
+        m_spfrootRouting = router->GetRoutingProtocol();
+        NS_ASSERT(m_spfrootRouting);
+    }
+
     SPFVertex* v;
     //
     // Initialize the Link State Database.
@@ -1367,10 +1493,11 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (router && CheckForStubNode(root))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
         delete m_spfroot;
+        m_spfroot = nullptr;
         return;
     }
 
@@ -1492,6 +1619,8 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     //
     delete m_spfroot;
     m_spfroot = nullptr;
+    m_spfrootIpv4 = nullptr;
+    m_spfrootRouting = nullptr;
 }
 
 void
@@ -1548,103 +1677,65 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routing information is written to the node of the root vertex, whose
+    // routing protocol was looked up by SPFCalculate ().
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootRouting)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        NS_LOG_LOGIC("No GlobalRouter interface for router " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
+    //
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
+    //
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
 
-        if (!rtr)
+    //
+    // Here's why we did all of that work.  We're going to add a host route to the
+    // host address found in the m_linkData field of the point-to-point link
+    // record.  In the case of a point-to-point link, this is the local IP address
+    // of the node connected to the link.  Each of these point-to-point links
+    // will correspond to a local interface that has an IP address to which
+    // the node at the root of the SPF tree can send packets.  The vertex <v>
+    // (corresponding to the node that has these links and interfaces) has
+    // an m_nextHop address precalculated for us that is the address to which the
+    // root node should send packets to be forwarded to these IP addresses.
+    // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+    // which the packets should be send for forwarding.
+    //
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " add external network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
@@ -1712,103 +1803,65 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routing information is written to the node of the root vertex, whose
+    // routing protocol was looked up by SPFCalculate ().
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootRouting)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        NS_LOG_LOGIC("No GlobalRouter interface for router " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
+    //
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
+    //
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
+    //
+    // Here's why we did all of that work.  We're going to add a host route to the
+    // host address found in the m_linkData field of the point-to-point link
+    // record.  In the case of a point-to-point link, this is the local IP address
+    // of the node connected to the link.  Each of these point-to-point links
+    // will correspond to a local interface that has an IP address to which
+    // the node at the root of the SPF tree can send packets.  The vertex <v>
+    // (corresponding to the node that has these links and interfaces) has
+    // an m_nextHop address precalculated for us that is the address to which the
+    // root node should send packets to be forwarded to these IP addresses.
+    // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+    // which the packets should be send for forwarding.
+    //
 
-        if (!rtr)
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
@@ -1832,58 +1885,32 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
     //
     Ipv4Address routerId = m_spfroot->GetVertexId();
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
+    // The Ipv4 interface of the node at the root of the SPF tree was looked up
+    // by SPFCalculate ().
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootIpv4)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
         //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
+        // Couldn't find it.
         //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
-        }
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
+        return -1;
     }
     //
-    // Couldn't find it.
+    // Look through the interfaces on this node for one that has the IP address
+    // we're looking for.  If we find one, return the corresponding interface
+    // index, or -1 if not found.
     //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
-    return -1;
+    int32_t interface = m_spfrootIpv4->GetInterfaceForPrefix(a, amask);
+
+#if 0
+  if (interface < 0)
+    {
+      NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
+                      "Expected an interface associated with address a:" << a);
+    }
+#endif
+    return interface;
 }
 
 //
@@ -1919,128 +1946,87 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routing information is written to the node of the root vertex, whose
+    // routing protocol was looked up by SPFCalculate ().
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("No GlobalRouter interface for router " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
+    //
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
+    //
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
+    //
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
+    //
+    NS_LOG_LOGIC(" Router " << routerId << " found " << nLinkRecords
+                            << " link records in LSA " << lsa << "with LinkStateId "
+                            << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // Here's why we did all of that work.  We're going to add a host route to the
+        // host address found in the m_linkData field of the point-to-point link
+        // record.  In the case of a point-to-point link, this is the local IP address
+        // of the node connected to the link.  Each of these point-to-point links
+        // will correspond to a local interface that has an IP address to which
+        // the node at the root of the SPF tree can send packets.  The vertex <v>
+        // (corresponding to the node that has these links and interfaces) has
+        // an m_nextHop address precalculated for us that is the address to which the
+        // root node should send packets to be forwarded to these IP addresses.
+        // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+        // which the packets should be send for forwarding.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+        // walk through all available exit directions due to ECMP,
+        // and add host route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+            Ipv4Address nextHop = exit.first;
+            int32_t outIf = exit.second;
+            if (outIf >= 0)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
+                NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                       << " adding host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " and outgoing interface " << outIf);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+            else
+            {
+                NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                       << " NOT able to add host route to "
+                                       << lr->GetLinkData() << " using next hop " << nextHop
+                                       << " since outgoing interface id is negative "
+                                       << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 
@@ -2061,89 +2047,52 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routing information is written to the node of the root vertex, whose
+    // routing protocol was looked up by SPFCalculate ().
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootRouting)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        NS_LOG_LOGIC("No GlobalRouter interface for router " << routerId);
+        return;
+    }
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
+    //
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
+    //
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    // walk through all available exit directions due to ECMP,
+    // and add host route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
 
-        if (!rtr)
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
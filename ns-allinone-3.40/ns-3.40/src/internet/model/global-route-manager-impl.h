@@ -31,6 +31,7 @@
 #include <map>
 #include <queue>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -39,6 +40,7 @@ namespace ns3
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -672,6 +674,18 @@ class GlobalRouteManagerLSDB
      */
     uint32_t GetNumExtLSAs() const;
 
+    /**
+     * @brief Copy the database.
+     *
+     * The SPF computation marks the Link State Advertisements it explores,
+     * so computations running concurrently each need a copy of the
+     * database.  The caller is given the responsibility for releasing the
+     * copy.
+     *
+     * @returns A copy of the database and of its Link State Advertisements.
+     */
+    GlobalRouteManagerLSDB* Copy() const;
+
   private:
     typedef std::map<Ipv4Address, GlobalRoutingLSA*>
         LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -681,6 +695,8 @@ class GlobalRouteManagerLSDB
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
+    /// LSAs by the LinkData field of their TransitNetwork link records
+    std::unordered_map<Ipv4Address, LSDBMap_t::iterator, Ipv4AddressHash> m_linkDataIndex;
 };
 
 /**
@@ -722,6 +738,11 @@ class GlobalRouteManagerImpl
     /**
      * @brief Compute routes using a Dijkstra SPF computation and populate
      * per-node forwarding tables
+     *
+     * The computations rooted at each router are spread over the number of
+     * threads set by the "GlobalRoutingThreads" GlobalValue.  In a
+     * distributed simulation, only the routers of the local system are
+     * computed.
      */
     virtual void InitializeRoutes();
 
@@ -741,6 +762,9 @@ class GlobalRouteManagerImpl
     SPFVertex* m_spfroot;           //!< the root node
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+    Ptr<Ipv4> m_spfrootIpv4;                 //!< the Ipv4 of the root node
+    Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< the routing protocol of the root node
+
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
      *
@@ -761,6 +785,18 @@ class GlobalRouteManagerImpl
      */
     void SPFCalculate(Ipv4Address root);
 
+    /**
+     * \brief Calculate the shortest path first (SPF) tree of a router
+     * whose node is known.
+     *
+     * This does not walk the node list, and may run concurrently for the
+     * routers of different nodes, each in its own GlobalRouteManagerImpl.
+     *
+     * \param root the root node
+     * \param router the GlobalRouter of the root node, or null if none
+     */
+    void SPFCalculate(Ipv4Address root, const Ptr<GlobalRouter>& router);
+
     /**
      * \brief Process Stub nodes
      *
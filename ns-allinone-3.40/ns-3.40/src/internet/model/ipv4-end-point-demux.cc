@@ -46,29 +46,30 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux()
         delete endPoint;
     }
     m_endPoints.clear();
+    m_localPorts.clear();
+    m_connections.clear();
+    m_endPointConnections.clear();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_localPorts.find(port) != m_localPorts.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto localPort = m_localPorts.find(port);
+    if (localPort == m_localPorts.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
+        return false;
+    }
+    for (auto i = localPort->second.begin(); i != localPort->second.end(); i++)
+    {
+        if ((*i)->GetLocalAddress() == addr &&
             (*i)->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
@@ -88,7 +89,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -104,7 +105,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -127,7 +128,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -140,19 +141,23 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto port = m_localPorts.find(localPort);
+    if (port != m_localPorts.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (auto i = port->second.begin(); i != port->second.end(); i++)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if ((*i)->GetLocalAddress() == localAddress && (*i)->GetPeerPort() == peerPort &&
+                (*i)->GetPeerAddress() == peerAddress &&
+                ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    AddEndPoint(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -163,12 +168,32 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto localPort = m_localPorts.find(endPoint->GetLocalPort());
+    if (localPort == m_localPorts.end())
+    {
+        return;
+    }
+    for (auto i = localPort->second.begin(); i != localPort->second.end(); i++)
     {
         if (*i == endPoint)
         {
+            localPort->second.erase(i);
+            if (localPort->second.empty())
+            {
+                m_localPorts.erase(localPort);
+            }
+            m_endPoints.remove(endPoint);
+            auto connections = m_endPointConnections.equal_range(endPoint);
+            for (auto j = connections.first; j != connections.second; j++)
+            {
+                auto connection = m_connections.find(j->second);
+                if (connection != m_connections.end() && connection->second == endPoint)
+                {
+                    m_connections.erase(connection);
+                }
+            }
+            m_endPointConnections.erase(connections.first, connections.second);
             delete endPoint;
-            m_endPoints.erase(i);
             break;
         }
     }
@@ -211,7 +236,31 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     EndPoints retval4; // Exact match on all 4
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    Connection connection{daddr, dport, saddr, sport};
+    auto connected = m_connections.find(connection);
+    if (connected != m_connections.end())
+    {
+        // The end point found last time, if it still fully matches.  There can
+        // be another one only if two sockets were connected to the same peer
+        // from the same address and port, which the scan below aborts on.
+        Ipv4EndPoint* endP = connected->second;
+        if (endP->IsRxEnabled() && endP->GetLocalAddress() == daddr &&
+            endP->GetPeerAddress() == saddr && endP->GetPeerPort() == sport &&
+            (!endP->GetBoundNetDevice() ||
+             endP->GetBoundNetDevice() == incomingInterface->GetDevice()))
+        {
+            NS_LOG_LOGIC("Found connected endpoint " << endP);
+            return EndPoints(1, endP);
+        }
+    }
+
+    auto localPort = m_localPorts.find(dport);
+    if (localPort == m_localPorts.end())
+    {
+        NS_LOG_LOGIC("No endpoint on port " << dport);
+        return EndPoints();
+    }
+    for (auto i = localPort->second.begin(); i != localPort->second.end(); i++)
     {
         Ipv4EndPoint* endP = *i;
 
@@ -361,6 +410,10 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     NS_ABORT_MSG_IF(retval.size() > 1,
                     "Too many endpoints - perhaps you created too many sockets without binding "
                     "them to different NetDevices.");
+    if (!retval4.empty())
+    {
+        AddConnection(connection, retval4.front());
+    }
     return retval; // might be empty if no matches
 }
 
@@ -376,7 +429,12 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
     // function.
     uint32_t genericity = 3;
     Ipv4EndPoint* generic = nullptr;
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto localPort = m_localPorts.find(dport);
+    if (localPort == m_localPorts.end())
+    {
+        return nullptr;
+    }
+    for (auto i = localPort->second.begin(); i != localPort->second.end(); i++)
     {
         if ((*i)->GetLocalPort() != dport)
         {
@@ -406,6 +464,47 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
     return generic;
 }
 
+void
+Ipv4EndPointDemux::AddEndPoint(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_endPoints.push_back(endPoint);
+    m_localPorts[endPoint->GetLocalPort()].push_back(endPoint);
+}
+
+void
+Ipv4EndPointDemux::AddConnection(const Connection& connection, Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto inserted = m_connections.emplace(connection, endPoint);
+    if (!inserted.second)
+    {
+        if (inserted.first->second == endPoint)
+        {
+            return;
+        }
+        inserted.first->second = endPoint;
+    }
+    m_endPointConnections.emplace(endPoint, connection);
+}
+
+bool
+Ipv4EndPointDemux::Connection::operator==(const Connection& other) const
+{
+    return localAddress == other.localAddress && localPort == other.localPort &&
+           peerAddress == other.peerAddress && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::ConnectionHash::operator()(const Connection& connection) const
+{
+    Ipv4AddressHash addressHash;
+    uint32_t ports = (static_cast<uint32_t>(connection.localPort) << 16) | connection.peerPort;
+    size_t hash = addressHash(connection.localAddress);
+    hash = hash * 31 + addressHash(connection.peerAddress);
+    return hash * 31 + ports;
+}
+
 uint16_t
 Ipv4EndPointDemux::AllocateEphemeralPort()
 {
@@ -30,7 +30,10 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <iterator>
+#include <numeric>
 #include <vector>
 
 namespace ns3
@@ -58,13 +61,22 @@ Ipv4GlobalRouting::GetTypeId()
                           "Interface notification events (up/down, or add/remove address)",
                           BooleanValue(false),
                           MakeBooleanAccessor(&Ipv4GlobalRouting::m_respondToInterfaceEvents),
+                          MakeBooleanChecker())
+            .AddAttribute("CompiledLookup",
+                          "Set to true to look the routes up in tables compiled from the routing "
+                          "table, or to false to scan the routing table for each packet",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&Ipv4GlobalRouting::m_compiledLookup),
                           MakeBooleanChecker());
     return tid;
 }
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_compiledLookup(true),
+      m_lookupTablesValid(false),
+      m_lookupTablesUsable(false)
 {
     NS_LOG_FUNCTION(this);
 
@@ -83,6 +95,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    m_lookupTablesValid = false;
 }
 
 void
@@ -92,6 +105,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    m_lookupTablesValid = false;
 }
 
 void
@@ -104,6 +118,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    m_lookupTablesValid = false;
 }
 
 void
@@ -113,6 +128,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    m_lookupTablesValid = false;
 }
 
 void
@@ -125,6 +141,7 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_ASexternalRoutes.push_back(route);
+    m_lookupTablesValid = false;
 }
 
 Ptr<Ipv4Route>
@@ -132,11 +149,23 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << oif);
     NS_LOG_LOGIC("Looking for route for destination " << dest);
-    Ptr<Ipv4Route> rtentry = nullptr;
     // store all available routes that bring packets to their destination
     typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
     RouteVec_t allRoutes;
 
+    if (!oif && m_compiledLookup)
+    {
+        if (!m_lookupTablesValid)
+        {
+            BuildLookupTables();
+        }
+        if (m_lookupTablesUsable)
+        {
+            const RouteVec_t* routes = FindRoutes(dest);
+            return routes ? SelectRoute(*routes) : nullptr;
+        }
+    }
+
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
     for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
     {
@@ -199,37 +228,172 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
             }
         }
     }
-    if (!allRoutes.empty()) // if route(s) is found
+    return SelectRoute(allRoutes);
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::SelectRoute(const std::vector<Ipv4RoutingTableEntry*>& routes)
+{
+    if (routes.empty())
+    {
+        return nullptr;
+    }
+    // pick up one of the routes uniformly at random if random
+    // ECMP routing is enabled, or always select the first route
+    // consistently if random ECMP routing is disabled
+    uint32_t selectIndex;
+    if (m_randomEcmpRouting)
+    {
+        selectIndex = m_rand->GetInteger(0, routes.size() - 1);
+    }
+    else
+    {
+        selectIndex = 0;
+    }
+    Ipv4RoutingTableEntry* route = routes.at(selectIndex);
+    // create a Ipv4Route object from the selected routing table entry
+    Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
+    rtentry->SetDestination(route->GetDest());
+    /// \todo handle multi-address case
+    rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
+    rtentry->SetGateway(route->GetGateway());
+    uint32_t interfaceIdx = route->GetInterface();
+    rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+    return rtentry;
+}
+
+/**
+ * Compile the routes to networks in a trie and, for each prefix of the trie,
+ * the list of the routes whose prefix contains it.
+ *
+ * \param routes the routes
+ * \param trie the trie
+ * \param table the routes matching each prefix, in the order of the routes
+ * \param firstOnly whether to keep only the first route matching each prefix
+ */
+static void
+BuildPrefixTable(const std::list<Ipv4RoutingTableEntry*>& routes,
+                 Ipv4PrefixTrie& trie,
+                 std::vector<std::vector<Ipv4RoutingTableEntry*>>& table,
+                 bool firstOnly)
+{
+    // The routes of a prefix, with their position in the routing table
+    typedef std::vector<std::pair<uint32_t, Ipv4RoutingTableEntry*>> RankedRoutes;
+    std::vector<RankedRoutes> own;
+    std::vector<Ipv4RoutingTableEntry*> first; // the first route of each prefix
+    uint32_t rank = 0;
+    for (auto route : routes)
+    {
+        uint32_t prefix = trie.Insert(route->GetDestNetwork(), route->GetDestNetworkMask());
+        if (prefix == own.size())
+        {
+            own.emplace_back();
+            first.push_back(route);
+        }
+        own[prefix].emplace_back(rank++, route);
+    }
+
+    // The shorter prefixes first, so that the routes of the longest prefix
+    // containing a prefix are known when the prefix is reached.
+    std::vector<uint32_t> order(own.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&first](uint32_t a, uint32_t b) {
+        return first[a]->GetDestNetworkMask().GetPrefixLength() <
+               first[b]->GetDestNetworkMask().GetPrefixLength();
+    });
+    std::vector<RankedRoutes> all(own.size());
+    for (uint32_t prefix : order)
     {
-        // pick up one of the routes uniformly at random if random
-        // ECMP routing is enabled, or always select the first route
-        // consistently if random ECMP routing is disabled
-        uint32_t selectIndex;
-        if (m_randomEcmpRouting)
+        uint16_t length = first[prefix]->GetDestNetworkMask().GetPrefixLength();
+        uint32_t parent = Ipv4PrefixTrie::NO_PREFIX;
+        if (length > 0)
         {
-            selectIndex = m_rand->GetInteger(0, allRoutes.size() - 1);
+            parent = trie.Lookup(first[prefix]->GetDestNetwork(), length - 1);
+        }
+        if (parent == Ipv4PrefixTrie::NO_PREFIX)
+        {
+            all[prefix] = own[prefix];
         }
         else
         {
-            selectIndex = 0;
+            std::merge(all[parent].begin(),
+                       all[parent].end(),
+                       own[prefix].begin(),
+                       own[prefix].end(),
+                       std::back_inserter(all[prefix]));
+        }
+        if (firstOnly)
+        {
+            all[prefix].resize(1);
         }
-        Ipv4RoutingTableEntry* route = allRoutes.at(selectIndex);
-        // create a Ipv4Route object from the selected routing table entry
-        rtentry = Create<Ipv4Route>();
-        rtentry->SetDestination(route->GetDest());
-        /// \todo handle multi-address case
-        rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
-        rtentry->SetGateway(route->GetGateway());
-        uint32_t interfaceIdx = route->GetInterface();
-        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-        return rtentry;
     }
-    else
+
+    table.assign(all.size(), {});
+    for (uint32_t prefix = 0; prefix < all.size(); prefix++)
     {
-        return nullptr;
+        table[prefix].reserve(all[prefix].size());
+        for (const auto& ranked : all[prefix])
+        {
+            table[prefix].push_back(ranked.second);
+        }
     }
 }
 
+void
+Ipv4GlobalRouting::BuildLookupTables()
+{
+    NS_LOG_FUNCTION(this);
+    m_lookupTablesValid = true;
+    m_hostTable.clear();
+    m_networkTrie.Clear();
+    m_networkTable.clear();
+    m_externalTrie.Clear();
+    m_externalTable.clear();
+
+    auto isContiguous = [](const Ipv4RoutingTableEntry* route) {
+        return Ipv4PrefixTrie::IsContiguous(route->GetDestNetworkMask());
+    };
+    m_lookupTablesUsable =
+        std::all_of(m_networkRoutes.begin(), m_networkRoutes.end(), isContiguous) &&
+        std::all_of(m_ASexternalRoutes.begin(), m_ASexternalRoutes.end(), isContiguous);
+    if (!m_lookupTablesUsable)
+    {
+        NS_LOG_LOGIC("A route has a non-contiguous mask, the routing table will be scanned");
+        return;
+    }
+
+    for (auto route : m_hostRoutes)
+    {
+        m_hostTable[route->GetDest().Get()].push_back(route);
+    }
+    BuildPrefixTable(m_networkRoutes, m_networkTrie, m_networkTable, false);
+    BuildPrefixTable(m_ASexternalRoutes, m_externalTrie, m_externalTable, true);
+}
+
+const std::vector<Ipv4RoutingTableEntry*>*
+Ipv4GlobalRouting::FindRoutes(Ipv4Address dest) const
+{
+    auto host = m_hostTable.find(dest.Get());
+    if (host != m_hostTable.end())
+    {
+        NS_LOG_LOGIC("Found " << host->second.size() << " global host routes");
+        return &host->second;
+    }
+    uint32_t prefix = m_networkTrie.Lookup(dest);
+    if (prefix != Ipv4PrefixTrie::NO_PREFIX)
+    {
+        NS_LOG_LOGIC("Found " << m_networkTable[prefix].size() << " global network routes");
+        return &m_networkTable[prefix];
+    }
+    prefix = m_externalTrie.Lookup(dest);
+    if (prefix != Ipv4PrefixTrie::NO_PREFIX)
+    {
+        NS_LOG_LOGIC("Found external route " << m_externalTable[prefix].front());
+        return &m_externalTable[prefix];
+    }
+    return nullptr;
+}
+
 uint32_t
 Ipv4GlobalRouting::GetNRoutes() const
 {
@@ -299,6 +463,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
                 delete *i;
                 m_hostRoutes.erase(i);
+                m_lookupTablesValid = false;
                 NS_LOG_LOGIC("Done removing host route "
                              << index << "; host route remaining size = " << m_hostRoutes.size());
                 return;
@@ -315,6 +480,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
             delete *j;
             m_networkRoutes.erase(j);
+            m_lookupTablesValid = false;
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -330,6 +496,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
             delete *k;
             m_ASexternalRoutes.erase(k);
+            m_lookupTablesValid = false;
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -364,6 +531,7 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_lookupTablesValid = false;
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -20,6 +20,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-prefix-trie.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
@@ -29,6 +30,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -66,6 +69,13 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * Unless the CompiledLookup attribute is false, the routes are not scanned
+ * for each packet: they are compiled, when the first packet is routed after
+ * they change, in a hash table of the host routes and in tries of the
+ * prefixes of the network and external routes which give, for each prefix,
+ * the group of equal-cost routes the packet may take.  The route chosen is
+ * the one the scan would choose.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -274,10 +284,44 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
 
+    /**
+     * \brief Choose one of the routes to a destination.
+     * \param routes the routes, empty if there is none
+     * \return Ipv4Route to route the packet along the route chosen
+     */
+    Ptr<Ipv4Route> SelectRoute(const std::vector<Ipv4RoutingTableEntry*>& routes);
+
+    /**
+     * \brief Compile the routes in the lookup tables.
+     */
+    void BuildLookupTables();
+
+    /**
+     * \brief Find the routes to a destination in the lookup tables.
+     * \param dest destination address
+     * \return the routes the packet may take, or nullptr if there is none
+     */
+    const std::vector<Ipv4RoutingTableEntry*>* FindRoutes(Ipv4Address dest) const;
+
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    /// Set to true to look the routes up in the tables below
+    bool m_compiledLookup;
+    /// Set to true when the tables below hold the current routes
+    bool m_lookupTablesValid;
+    /// Set to false when a route has a mask the tries can not hold
+    bool m_lookupTablesUsable;
+    /// The host routes to each destination, in table order
+    std::unordered_map<uint32_t, std::vector<Ipv4RoutingTableEntry*>> m_hostTable;
+    Ipv4PrefixTrie m_networkTrie; //!< The prefixes of the network routes
+    /// The network routes matching each prefix of m_networkTrie, in table order
+    std::vector<std::vector<Ipv4RoutingTableEntry*>> m_networkTable;
+    Ipv4PrefixTrie m_externalTrie; //!< The prefixes of the external routes
+    /// The first external route matching each prefix of m_externalTrie
+    std::vector<std::vector<Ipv4RoutingTableEntry*>> m_externalTable;
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -124,6 +124,11 @@ Ipv4Interface::DoSetup()
         return;
     }
     Ptr<ArpL3Protocol> arp = m_node->GetObject<ArpL3Protocol>();
+    if (!arp && m_node->IsGhost())
+    {
+        // A ghost node never sends packets and has no ARP
+        return;
+    }
     m_cache = arp->CreateCache(m_device, this);
 }
 
@@ -403,23 +403,30 @@ Ipv4L3Protocol::AddInterface(Ptr<NetDevice> device)
     NS_ASSERT(m_node);
 
     Ptr<TrafficControlLayer> tc = m_node->GetObject<TrafficControlLayer>();
+    Ptr<ArpL3Protocol> arp = GetObject<ArpL3Protocol>();
 
-    NS_ASSERT(tc);
+    // A ghost node never receives packets, and may have neither ARP nor
+    // traffic control layer
+    NS_ASSERT(tc || m_node->IsGhost());
 
-    m_node->RegisterProtocolHandler(MakeCallback(&TrafficControlLayer::Receive, tc),
+    if (tc)
+    {
+        m_node->RegisterProtocolHandler(MakeCallback(&TrafficControlLayer::Receive, tc),
+                                        Ipv4L3Protocol::PROT_NUMBER,
+                                        device);
+        tc->RegisterProtocolHandler(MakeCallback(&Ipv4L3Protocol::Receive, this),
                                     Ipv4L3Protocol::PROT_NUMBER,
                                     device);
-    m_node->RegisterProtocolHandler(MakeCallback(&TrafficControlLayer::Receive, tc),
+    }
+    if (tc && arp)
+    {
+        m_node->RegisterProtocolHandler(MakeCallback(&TrafficControlLayer::Receive, tc),
+                                        ArpL3Protocol::PROT_NUMBER,
+                                        device);
+        tc->RegisterProtocolHandler(MakeCallback(&ArpL3Protocol::Receive, PeekPointer(arp)),
                                     ArpL3Protocol::PROT_NUMBER,
                                     device);
-
-    tc->RegisterProtocolHandler(MakeCallback(&Ipv4L3Protocol::Receive, this),
-                                Ipv4L3Protocol::PROT_NUMBER,
-                                device);
-    tc->RegisterProtocolHandler(
-        MakeCallback(&ArpL3Protocol::Receive, PeekPointer(GetObject<ArpL3Protocol>())),
-        ArpL3Protocol::PROT_NUMBER,
-        device);
+    }
 
     Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface>();
     interface->SetNode(m_node);
@@ -596,14 +603,14 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
 
     if (ipv4Interface->IsUp())
     {
-        m_rxTrace(packet, this, interface);
+        NS_TRACE(m_rxTrace, packet, this, interface);
     }
     else
     {
         NS_LOG_LOGIC("Dropping received packet -- interface is down");
         Ipv4Header ipHeader;
         packet->RemoveHeader(ipHeader);
-        m_dropTrace(ipHeader, packet, DROP_INTERFACE_DOWN, this, interface);
+        NS_TRACE(m_dropTrace, ipHeader, packet, DROP_INTERFACE_DOWN, this, interface);
         return;
     }
 
@@ -623,7 +630,7 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     if (!ipHeader.IsChecksumOk())
     {
         NS_LOG_LOGIC("Dropping received packet -- checksum not ok");
-        m_dropTrace(ipHeader, packet, DROP_BAD_CHECKSUM, this, interface);
+        NS_TRACE(m_dropTrace, ipHeader, packet, DROP_BAD_CHECKSUM, this, interface);
         return;
     }
 
@@ -666,7 +673,7 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     if (m_enableDpd && ipHeader.GetDestination().IsMulticast() && UpdateDuplicate(packet, ipHeader))
     {
         NS_LOG_LOGIC("Dropping received packet -- duplicate.");
-        m_dropTrace(ipHeader, packet, DROP_DUPLICATE, this, interface);
+        NS_TRACE(m_dropTrace, ipHeader, packet, DROP_DUPLICATE, this, interface);
         return;
     }
 
@@ -674,7 +681,7 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     if (!m_routingProtocol->RouteInput(packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb))
     {
         NS_LOG_WARN("No route found for forwarding packet.  Drop.");
-        m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, interface);
+        NS_TRACE(m_dropTrace, ipHeader, packet, DROP_NO_ROUTE, this, interface);
     }
 }
 
@@ -747,12 +754,14 @@ Ipv4L3Protocol::CallTxTrace(const Ipv4Header& ipHeader,
                             Ptr<Ipv4> ipv4,
                             uint32_t interface)
 {
+#ifndef NS3_TRACE_SOURCES_DISABLE
     if (!m_txTrace.IsEmpty())
     {
         Ptr<Packet> packetCopy = packet->Copy();
         packetCopy->AddHeader(ipHeader);
         m_txTrace(packetCopy, ipv4, interface);
     }
+#endif
 }
 
 void
@@ -815,7 +824,7 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
         // 1b) with a valid gateway
         NS_LOG_LOGIC("Ipv4L3Protocol::Send case 1b:  passed in with route and valid gateway");
         int32_t interface = GetInterfaceForDevice(route->GetOutputDevice());
-        m_sendOutgoingTrace(ipHeader, packet, interface);
+        NS_TRACE(m_sendOutgoingTrace, ipHeader, packet, interface);
         if (m_enableDpd && ipHeader.GetDestination().IsMulticast())
         {
             UpdateDuplicate(packet, ipHeader);
@@ -910,7 +919,7 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
     else
     {
         NS_LOG_WARN("No route to host.  Drop.");
-        m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, 0);
+        NS_TRACE(m_dropTrace, ipHeader, packet, DROP_NO_ROUTE, this, 0);
         DecreaseIdentification(source, destination, protocol);
     }
 }
@@ -981,7 +990,7 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (!route)
     {
         NS_LOG_WARN("No route to host.  Drop.");
-        m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, 0);
+        NS_TRACE(m_dropTrace, ipHeader, packet, DROP_NO_ROUTE, this, 0);
         return;
     }
     Ptr<NetDevice> outDev = route->GetOutputDevice();
@@ -1048,7 +1057,7 @@ Ipv4L3Protocol::IpMulticastForward(Ptr<Ipv4MulticastRoute> mrtentry,
         if (ipHeader.GetTtl() == 0)
         {
             NS_LOG_WARN("TTL exceeded.  Drop.");
-            m_dropTrace(header, packet, DROP_TTL_EXPIRED, this, interface);
+            NS_TRACE(m_dropTrace, header, packet, DROP_TTL_EXPIRED, this, interface);
             return;
         }
         NS_LOG_LOGIC("Forward multicast via interface " << interface);
@@ -1058,7 +1067,7 @@ Ipv4L3Protocol::IpMulticastForward(Ptr<Ipv4MulticastRoute> mrtentry,
         rtentry->SetGateway(Ipv4Address::GetAny());
         rtentry->SetOutputDevice(GetNetDevice(interface));
 
-        m_multicastForwardTrace(ipHeader, packet, interface);
+        NS_TRACE(m_multicastForwardTrace, ipHeader, packet, interface);
         SendRealOut(rtentry, packet, ipHeader);
     }
 }
@@ -1083,7 +1092,7 @@ Ipv4L3Protocol::IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv
             icmp->SendTimeExceededTtl(ipHeader, packet, false);
         }
         NS_LOG_WARN("TTL exceeded.  Drop.");
-        m_dropTrace(header, packet, DROP_TTL_EXPIRED, this, interface);
+        NS_TRACE(m_dropTrace, header, packet, DROP_TTL_EXPIRED, this, interface);
         return;
     }
     // in case the packet still has a priority tag attached, remove it
@@ -1097,7 +1106,7 @@ Ipv4L3Protocol::IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv
         packet->AddPacketTag(priorityTag);
     }
 
-    m_unicastForwardTrace(ipHeader, packet, interface);
+    NS_TRACE(m_unicastForwardTrace, ipHeader, packet, interface);
     SendRealOut(rtentry, packet, ipHeader);
 }
 
@@ -1122,7 +1131,7 @@ Ipv4L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv4Header& ip, uin
         ipHeader.SetPayloadSize(p->GetSize());
     }
 
-    m_localDeliverTrace(ipHeader, p, iif);
+    NS_TRACE(m_localDeliverTrace, ipHeader, p, iif);
 
     Ptr<IpL4Protocol> protocol = GetProtocol(ipHeader.GetProtocol(), iif);
     if (protocol)
@@ -1459,7 +1468,7 @@ Ipv4L3Protocol::RouteInputError(Ptr<const Packet> p,
     NS_LOG_FUNCTION(this << p << ipHeader << sockErrno);
     NS_LOG_LOGIC("Route input failure-- dropping packet to " << ipHeader << " with errno "
                                                              << sockErrno);
-    m_dropTrace(ipHeader, p, DROP_ROUTE_ERROR, this, 0);
+    NS_TRACE(m_dropTrace, ipHeader, p, DROP_ROUTE_ERROR, this, 0);
 
     // \todo Send an ICMP no route.
 }
@@ -1757,7 +1766,7 @@ Ipv4L3Protocol::HandleFragmentsTimeout(FragmentKey_t key, Ipv4Header& ipHeader,
         Ptr<Icmpv4L4Protocol> icmp = GetIcmp();
         icmp->SendTimeExceededTtl(ipHeader, packet, true);
     }
-    m_dropTrace(ipHeader, packet, DROP_FRAGMENT_TIMEOUT, this, iif);
+    NS_TRACE(m_dropTrace, ipHeader, packet, DROP_FRAGMENT_TIMEOUT, this, iif);
 
     // clear the buffers
     it->second = nullptr;
@@ -0,0 +1,93 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-prefix-trie.h"
+
+#include "ns3/assert.h"
+
+namespace ns3
+{
+
+Ipv4PrefixTrie::Ipv4PrefixTrie()
+{
+    Clear();
+}
+
+bool
+Ipv4PrefixTrie::IsContiguous(Ipv4Mask mask)
+{
+    uint32_t host = ~mask.Get();
+    return (host & (host + 1)) == 0;
+}
+
+void
+Ipv4PrefixTrie::Clear()
+{
+    m_nodes.assign(1, Node());
+    m_nPrefixes = 0;
+}
+
+uint32_t
+Ipv4PrefixTrie::Insert(Ipv4Address network, Ipv4Mask mask)
+{
+    NS_ASSERT_MSG(IsContiguous(mask), "Mask " << mask << " is not contiguous");
+    uint32_t bits = network.Get();
+    uint16_t length = mask.GetPrefixLength();
+    uint32_t node = 0;
+    for (uint16_t i = 0; i < length; i++)
+    {
+        uint32_t bit = (bits >> (31 - i)) & 1;
+        if (m_nodes[node].child[bit] == 0)
+        {
+            m_nodes[node].child[bit] = m_nodes.size();
+            m_nodes.emplace_back();
+        }
+        node = m_nodes[node].child[bit];
+    }
+    if (m_nodes[node].prefix == NO_PREFIX)
+    {
+        m_nodes[node].prefix = m_nPrefixes++;
+    }
+    return m_nodes[node].prefix;
+}
+
+uint32_t
+Ipv4PrefixTrie::Lookup(Ipv4Address address, uint16_t maxLength) const
+{
+    uint32_t bits = address.Get();
+    uint32_t node = 0;
+    uint32_t prefix = m_nodes[0].prefix;
+    for (uint16_t i = 0; i < maxLength && i < 32; i++)
+    {
+        node = m_nodes[node].child[(bits >> (31 - i)) & 1];
+        if (node == 0)
+        {
+            break;
+        }
+        if (m_nodes[node].prefix != NO_PREFIX)
+        {
+            prefix = m_nodes[node].prefix;
+        }
+    }
+    return prefix;
+}
+
+uint32_t
+Ipv4PrefixTrie::GetNPrefixes() const
+{
+    return m_nPrefixes;
+}
+
+} // namespace ns3
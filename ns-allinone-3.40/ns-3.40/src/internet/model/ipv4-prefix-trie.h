@@ -0,0 +1,95 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_PREFIX_TRIE_H
+#define IPV4_PREFIX_TRIE_H
+
+#include "ns3/ipv4-address.h"
+
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A binary trie of IPv4 prefixes, for longest prefix match lookups.
+ *
+ * Each prefix inserted in the trie is given an index, from 0 to
+ * GetNPrefixes() - 1, which the routing protocols use to find the routes
+ * of the prefix in their own tables.  A lookup walks the bits of the
+ * address from the most significant one and costs at most 32 steps,
+ * whatever the number of prefixes.
+ *
+ * Only contiguous masks (see IsContiguous()) can be inserted.
+ */
+class Ipv4PrefixTrie
+{
+  public:
+    /// The index returned when no prefix matches
+    static constexpr uint32_t NO_PREFIX = std::numeric_limits<uint32_t>::max();
+
+    Ipv4PrefixTrie();
+
+    /**
+     * \param mask a mask
+     * \returns true if the bits set in the mask are the most significant ones
+     */
+    static bool IsContiguous(Ipv4Mask mask);
+
+    /// Remove all the prefixes
+    void Clear();
+
+    /**
+     * Insert a prefix, if it is not in the trie yet.
+     *
+     * \param network the network of the prefix; the bits outside the mask are ignored
+     * \param mask the mask of the prefix, which must be contiguous
+     * \returns the index of the prefix
+     */
+    uint32_t Insert(Ipv4Address network, Ipv4Mask mask);
+
+    /**
+     * Find the longest prefix matching an address.
+     *
+     * \param address the address
+     * \param maxLength the length of the longest prefix considered
+     * \returns the index of the prefix, or NO_PREFIX
+     */
+    uint32_t Lookup(Ipv4Address address, uint16_t maxLength = 32) const;
+
+    /**
+     * \returns the number of prefixes in the trie
+     */
+    uint32_t GetNPrefixes() const;
+
+  private:
+    /// A node of the trie; its depth is the length of the prefix it stands for
+    struct Node
+    {
+        uint32_t child[2]{0, 0};    //!< the index of the children, or 0 (the root) if none
+        uint32_t prefix{NO_PREFIX}; //!< the index of the prefix, or NO_PREFIX
+    };
+
+    std::vector<Node> m_nodes; //!< the nodes, starting with the root
+    uint32_t m_nPrefixes;      //!< the number of prefixes
+};
+
+} // namespace ns3
+
+#endif /* IPV4_PREFIX_TRIE_H */
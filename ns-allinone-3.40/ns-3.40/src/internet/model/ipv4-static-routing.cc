@@ -29,6 +29,7 @@
 #include "ipv4-route.h"
 #include "ipv4-routing-table-entry.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/node.h"
@@ -36,6 +37,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 
 using std::make_pair;
@@ -53,12 +55,22 @@ Ipv4StaticRouting::GetTypeId()
     static TypeId tid = TypeId("ns3::Ipv4StaticRouting")
                             .SetParent<Ipv4RoutingProtocol>()
                             .SetGroupName("Internet")
-                            .AddConstructor<Ipv4StaticRouting>();
+                            .AddConstructor<Ipv4StaticRouting>()
+                            .AddAttribute("CompiledLookup",
+                                          "Set to true to look the routes up in a table compiled "
+                                          "from the routing table, or to false to scan the "
+                                          "routing table for each packet",
+                                          BooleanValue(true),
+                                          MakeBooleanAccessor(&Ipv4StaticRouting::m_compiledLookup),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting()
-    : m_ipv4(nullptr)
+    : m_ipv4(nullptr),
+      m_compiledLookup(true),
+      m_lookupTableValid(false),
+      m_lookupTableUsable(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -80,6 +92,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     {
         auto routePtr = new Ipv4RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_lookupTableValid = false;
     }
 }
 
@@ -98,6 +111,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         auto routePtr = new Ipv4RoutingTableEntry(route);
 
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_lookupTableValid = false;
     }
 }
 
@@ -153,6 +167,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_lookupTableValid = false;
 }
 
 uint32_t
@@ -261,6 +276,33 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
+    if (!oif && m_compiledLookup)
+    {
+        if (!m_lookupTableValid)
+        {
+            BuildLookupTable();
+        }
+        if (m_lookupTableUsable)
+        {
+            uint32_t prefix = m_networkTrie.Lookup(dest);
+            if (prefix == Ipv4PrefixTrie::NO_PREFIX)
+            {
+                NS_LOG_LOGIC("No matching route to " << dest << " found");
+                return nullptr;
+            }
+            Ipv4RoutingTableEntry* route = m_networkTable[prefix].first;
+            NS_LOG_LOGIC("Found network route " << route << ", metric "
+                                                << m_networkTable[prefix].second);
+            uint32_t interfaceIdx = route->GetInterface();
+            rtentry = Create<Ipv4Route>();
+            rtentry->SetDestination(route->GetDest());
+            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+            rtentry->SetGateway(route->GetGateway());
+            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+            return rtentry;
+        }
+    }
+
     for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
     {
         Ipv4RoutingTableEntry* j = i->first;
@@ -322,6 +364,44 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
     return rtentry;
 }
 
+void
+Ipv4StaticRouting::BuildLookupTable()
+{
+    NS_LOG_FUNCTION(this);
+    m_lookupTableValid = true;
+    m_networkTrie.Clear();
+    m_networkTable.clear();
+
+    m_lookupTableUsable = std::all_of(m_networkRoutes.begin(),
+                                      m_networkRoutes.end(),
+                                      [](const std::pair<Ipv4RoutingTableEntry*, uint32_t>& route) {
+                                          return Ipv4PrefixTrie::IsContiguous(
+                                              route.first->GetDestNetworkMask());
+                                      });
+    if (!m_lookupTableUsable)
+    {
+        NS_LOG_LOGIC("A route has a non-contiguous mask, the routing table will be scanned");
+        return;
+    }
+
+    for (const auto& route : m_networkRoutes)
+    {
+        uint32_t prefix =
+            m_networkTrie.Insert(route.first->GetDestNetwork(), route.first->GetDestNetworkMask());
+        if (prefix == m_networkTable.size())
+        {
+            m_networkTable.push_back(route);
+        }
+        // As in the scan, the first host route is taken, and otherwise the
+        // last route with the lowest metric.
+        else if (route.first->GetDestNetworkMask().GetPrefixLength() < 32 &&
+                 route.second <= m_networkTable[prefix].second)
+        {
+            m_networkTable[prefix] = route;
+        }
+    }
+}
+
 Ptr<Ipv4MulticastRoute>
 Ipv4StaticRouting::LookupStatic(Ipv4Address origin, Ipv4Address group, uint32_t interface)
 {
@@ -459,6 +539,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
         {
             delete j->first;
             m_networkRoutes.erase(j);
+            m_lookupTableValid = false;
             return;
         }
         tmp++;
@@ -592,6 +673,7 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_lookupTableValid = false;
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -633,6 +715,7 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_lookupTableValid = false;
         }
         else
         {
@@ -678,6 +761,7 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_lookupTableValid = false;
         }
         else
         {
@@ -22,6 +22,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-prefix-trie.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
@@ -32,6 +33,7 @@
 #include <list>
 #include <stdint.h>
 #include <utility>
+#include <vector>
 
 namespace ns3
 {
@@ -60,6 +62,11 @@ class Node;
  * Ipv4RoutingProtocol that defines the interface methods that a routing
  * protocol must support.
  *
+ * Unless the CompiledLookup attribute is false, the unicast routes are not
+ * scanned for each packet: when the first packet is routed after they
+ * change, they are compiled in a trie of their prefixes which gives the
+ * route the scan would choose for each prefix.
+ *
  * \see Ipv4RoutingProtocol
  * \see Ipv4ListRouting
  * \see Ipv4ListRouting::AddRoutingProtocol
@@ -397,6 +404,11 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     Ptr<Ipv4Route> LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
 
+    /**
+     * \brief Compile the network routes in the lookup table.
+     */
+    void BuildLookupTable();
+
     /**
      * \brief Lookup in the multicast forwarding table for destination.
      * \param origin source address
@@ -420,6 +432,13 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      * \brief Ipv4 reference.
      */
     Ptr<Ipv4> m_ipv4;
+
+    bool m_compiledLookup;        //!< Set to true to look the routes up in the table below
+    bool m_lookupTableValid;      //!< Set to true when the table below holds the current routes
+    bool m_lookupTableUsable;     //!< Set to false when a route has a non-contiguous mask
+    Ipv4PrefixTrie m_networkTrie; //!< The prefixes of the network routes
+    /// The route chosen for each prefix of m_networkTrie, with its metric
+    std::vector<std::pair<Ipv4RoutingTableEntry*, uint32_t>> m_networkTable;
 };
 
 } // Namespace ns3
@@ -26,6 +26,7 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -186,6 +187,66 @@ class Ipv6EndPointDemux
      * \brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The addresses and ports of a connection, as seen locally.
+     */
+    struct Connection
+    {
+        Ipv6Address localAddress; //!< The local address
+        uint16_t localPort;       //!< The local port
+        Ipv6Address peerAddress;  //!< The peer address
+        uint16_t peerPort;        //!< The peer port
+
+        /**
+         * \param other The other connection
+         * \returns true if both connections are the same
+         */
+        bool operator==(const Connection& other) const;
+    };
+
+    /**
+     * \brief Hash function of a Connection.
+     */
+    struct ConnectionHash
+    {
+        /**
+         * \param connection The connection
+         * \returns the hash of the connection
+         */
+        size_t operator()(const Connection& connection) const;
+    };
+
+    /**
+     * \brief Add an end point to the list and to the index of its local port.
+     * \param endPoint The end point
+     */
+    void AddEndPoint(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remember the end point that fully matches a connection.
+     * \param connection The connection
+     * \param endPoint The end point
+     */
+    void AddConnection(const Connection& connection, Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief The end points of each local port, in the order of the list.
+     */
+    std::unordered_map<uint16_t, EndPoints> m_localPorts;
+
+    /**
+     * \brief The end points found by Lookup() to fully match a connection.
+     *
+     * The peer and the local address of an end point can change after it is
+     * allocated, so an entry is only used if the end point still matches.
+     */
+    std::unordered_map<Connection, Ipv6EndPoint*, ConnectionHash> m_connections;
+
+    /**
+     * \brief The connections of each end point in m_connections.
+     */
+    std::unordered_multimap<Ipv6EndPoint*, Connection> m_endPointConnections;
 };
 
 } /* namespace ns3 */
@@ -171,8 +171,13 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    auto i = m_data.begin();
+    // Remove overlapped bytes from packet. The stored packets do not overlap,
+    // so only the one holding headSeq and those after it can overlap the new one.
+    auto i = m_data.upper_bound(headSeq);
+    if (i != m_data.begin())
+    {
+        --i;
+    }
     while (i != m_data.end() && i->first <= tailSeq)
     {
         SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
@@ -221,7 +226,7 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
     // Update variables
     m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    for (i = m_data.lower_bound(m_nextRxSeq); i != m_data.end(); ++i)
     {
         if (i->first < m_nextRxSeq)
         {
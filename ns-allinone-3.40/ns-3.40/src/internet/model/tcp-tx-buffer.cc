@@ -26,6 +26,7 @@
 #include "ns3/simulator.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
 namespace ns3
@@ -61,9 +62,86 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_nextSegFrom(n),
+      m_lostUpTo(n),
+      m_lostEnd(n),
+      m_sentCursor(m_sentList.end())
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
+    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+}
+
+TcpTxBuffer::TcpTxBuffer(const TcpTxBuffer& other)
+    : Object(other),
+      m_maxBuffer(0),
+      m_size(0),
+      m_sentSize(0),
+      m_firstByteSeq(other.m_firstByteSeq),
+      m_sentCursor(m_sentList.end())
+{
+    NS_LOG_FUNCTION(this << &other);
+    *this = other;
+}
+
+TcpTxBuffer&
+TcpTxBuffer::operator=(const TcpTxBuffer& other)
+{
+    NS_LOG_FUNCTION(this << &other);
+
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    for (auto item : m_sentList)
+    {
+        delete item;
+    }
+    for (auto item : m_appList)
+    {
+        delete item;
+    }
+    m_sentList.clear();
+    m_appList.clear();
+
+    // The iterators of the other buffer point into its own lists, so
+    // m_highestSack is found again by position and the cursor is reset.
+    m_highestSack = std::make_pair(m_sentList.end(), other.m_highestSack.second);
+    for (auto it = other.m_sentList.begin(); it != other.m_sentList.end(); ++it)
+    {
+        auto item = new TcpTxItem(**it);
+        item->m_packet = (*it)->m_packet->Copy();
+        m_sentList.push_back(item);
+        if (it == other.m_highestSack.first)
+        {
+            m_highestSack.first = std::prev(m_sentList.end());
+        }
+    }
+    for (auto otherItem : other.m_appList)
+    {
+        auto item = new TcpTxItem(*otherItem);
+        item->m_packet = otherItem->m_packet->Copy();
+        m_appList.push_back(item);
+    }
+
+    m_maxBuffer = other.m_maxBuffer;
+    m_size = other.m_size;
+    m_sentSize = other.m_sentSize;
+    m_rWndCallback = other.m_rWndCallback;
+    m_firstByteSeq = other.m_firstByteSeq.Get();
+    m_lostOut = other.m_lostOut;
+    m_sackedOut = other.m_sackedOut;
+    m_retrans = other.m_retrans;
+    m_dupAckThresh = other.m_dupAckThresh;
+    m_segmentSize = other.m_segmentSize;
+    m_renoSack = other.m_renoSack;
+    m_sackEnabled = other.m_sackEnabled;
+
+    ResetScanMarks();
+    m_lostEnd = m_firstByteSeq + m_sentSize;
+    m_sentCursor = m_sentList.end();
+    return *this;
 }
 
 TcpTxBuffer::~TcpTxBuffer()
@@ -175,6 +253,8 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostEnd = seq;
+    ResetScanMarks();
 }
 
 bool
@@ -309,37 +389,33 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
+    auto it = FindSentItem(seq);
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    if ((*it)->m_startSeq == seq)
     {
-        if ((*it)->m_startSeq == seq)
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -438,6 +514,15 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    if (&list == &m_sentList && !list.empty())
+    {
+        // The sent items know where they start: skip the ones before seq. The
+        // empty erase turns the constant iterator into a mutable one.
+        auto found = FindSentItem(seq);
+        it = list.erase(found, found);
+        beginOfCurrentPacket = (*it)->m_startSeq;
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
@@ -518,6 +603,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     TcpTxItem* previous = *(--it);
 
                     list.erase(it);
+                    m_sentCursor = m_sentList.end();
 
                     MergeItems(previous, currentItem);
                     delete currentItem;
@@ -567,6 +653,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
 
             MergeItems(currentItem, next);
             list.erase(it);
+            m_sentCursor = m_sentList.end();
 
             delete next;
 
@@ -599,6 +686,7 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     // be updated in MarkTransmittedSegment.
     if (t1->m_retrans != t2->m_retrans)
     {
+        ResetScanMarks();
         if (t1->m_retrans)
         {
             auto self = const_cast<TcpTxBuffer*>(this);
@@ -650,16 +738,14 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    if (ack <= m_firstByteSeq || ack > m_firstByteSeq + m_sentSize)
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    // The item ending at ack is the one holding the byte before ack
+    TcpTxItem* item = *FindSentItem(ack - 1);
+    Ptr<Packet> p = item->m_packet;
+    return item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -707,6 +793,10 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            if (i == m_sentCursor)
+            {
+                m_sentCursor = m_sentList.end();
+            }
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -755,6 +845,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             // when adding Reno dupacks in the count.
             head->m_sacked = false;
             m_sackedOut -= head->m_packet->GetSize();
+            ResetScanMarks();
             NS_LOG_INFO("Moving the SACK flag from the HEAD to another segment");
             AddRenoSack();
             MarkHeadAsLost();
@@ -769,6 +860,18 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
     {
         m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
     }
+    if (m_nextSegFrom < m_firstByteSeq)
+    {
+        m_nextSegFrom = m_firstByteSeq;
+    }
+    if (m_lostUpTo < m_firstByteSeq)
+    {
+        m_lostUpTo = m_firstByteSeq;
+    }
+    if (m_lostEnd < m_firstByteSeq)
+    {
+        m_lostEnd = m_firstByteSeq;
+    }
 
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
                                     << " sacked: " << m_sackedOut);
@@ -788,15 +891,18 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // The items before the one holding the beginning of the block can not
+        // be mapped over it
+        auto item_it = FindSentItem((*option_it).first);
+        SequenceNumber32 beginOfCurrentPacket =
+            item_it != m_sentList.end() ? (*item_it)->m_startSeq : m_firstByteSeq.Get();
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -889,9 +995,16 @@ TcpTxBuffer::UpdateLostCount()
                                                  << *(*m_highestSack.first));
     }
 
+    SequenceNumber32 lostUpTo = m_lostUpTo;
     for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
         TcpTxItem* item = *it;
+        if (sacked >= m_dupAckThresh && item->m_startSeq < m_lostUpTo)
+        {
+            // This item and the ones before are already SACKed or lost
+            break;
+        }
+
         if (item->m_sacked)
         {
             sacked++;
@@ -904,6 +1017,7 @@ TcpTxBuffer::UpdateLostCount()
                 item->m_lost = true;
                 m_lostOut += item->m_packet->GetSize();
             }
+            lostUpTo = std::max(lostUpTo, item->m_startSeq + item->m_packet->GetSize());
         }
         beginOfCurrentPacket -= item->m_packet->GetSize();
     }
@@ -916,6 +1030,8 @@ TcpTxBuffer::UpdateLostCount()
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
         }
+        m_lostUpTo = lostUpTo;
+        m_lostEnd = std::max({m_lostEnd, lostUpTo, item->m_startSeq + item->m_packet->GetSize()});
     }
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
@@ -926,34 +1042,31 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
     if (seq >= m_highestSack.second)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Search for the first item starting at or after seq
+    auto it = FindSentItem(seq);
+    if (it != m_sentList.end() && (*it)->m_startSeq < seq)
     {
-        // Search for the right iterator before calling IsLost()
-        if (beginOfCurrentPacket >= seq)
-        {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+        ++it;
+    }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+    for (; it != m_sentList.end(); ++it)
+    {
+        if ((*it)->m_lost)
+        {
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
         }
 
-        beginOfCurrentPacket += (*it)->m_packet->GetSize();
+        if ((*it)->m_sacked)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
+        }
     }
 
     return false;
@@ -980,15 +1093,39 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    bool isNextSegFromFound = false;
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // The items before m_nextSegFrom are retransmitted or SACKed, so that
+    // neither rule (1) nor rule (3) can select them
+    auto it = m_sentList.begin();
+    if (m_nextSegFrom > m_firstByteSeq)
+    {
+        it = FindSentItem(m_nextSegFrom);
+    }
+    SequenceNumber32 beginOfCurrentPkt =
+        it != m_sentList.end() ? (*it)->m_startSeq : m_firstByteSeq.Get();
+
+    for (; it != m_sentList.end(); ++it)
     {
         item = *it;
 
+        // No item is lost from m_lostEnd on: stop once the first item for
+        // rule (3) is known
+        if (beginOfCurrentPkt >= m_lostEnd && isNextSegFromFound &&
+            (!isRecovery || seqPerRule3.GetValue() != 0))
+        {
+            break;
+        }
+
         // Condition 1.a , 1.b , and 1.c
         if (!item->m_retrans && !item->m_sacked)
         {
+            if (!isNextSegFromFound)
+            {
+                m_nextSegFrom = beginOfCurrentPkt;
+                isNextSegFromFound = true;
+            }
+
             if (item->m_lost)
             {
                 NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -1008,6 +1145,11 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
         beginOfCurrentPkt += item->m_packet->GetSize();
     }
 
+    if (!isNextSegFromFound)
+    {
+        m_nextSegFrom = m_firstByteSeq + m_sentSize;
+    }
+
     /* (2) If no sequence number 'S2' per rule (1) exists but there
      *     exists available unsent data and the receiver's advertised
      *     window allows, the sequence range of one segment of up to SMSS
@@ -1221,6 +1363,7 @@ TcpTxBuffer::ResetRenoSack()
     }
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    ResetScanMarks();
 }
 
 void
@@ -1244,12 +1387,14 @@ TcpTxBuffer::ResetSentList()
         m_appList.push_front(item);
         m_sentList.pop_back();
     }
+    m_sentCursor = m_sentList.end();
 
     m_sentSize = 0;
     m_lostOut = 0;
     m_retrans = 0;
     m_sackedOut = 0;
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    ResetScanMarks();
 }
 
 void
@@ -1261,12 +1406,14 @@ TcpTxBuffer::ResetLastSegmentSent()
         TcpTxItem* item = m_sentList.back();
 
         m_sentList.pop_back();
+        m_sentCursor = m_sentList.end();
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
         {
             m_retrans -= item->m_packet->GetSize();
         }
         m_appList.insert(m_appList.begin(), item);
+        ResetScanMarks();
     }
     ConsistencyCheck();
 }
@@ -1276,6 +1423,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
 {
     NS_LOG_FUNCTION(this);
     m_retrans = 0;
+    ResetScanMarks();
 
     if (resetSack)
     {
@@ -1313,6 +1461,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         (*it)->m_retrans = false;
     }
 
+    m_lostEnd = m_firstByteSeq + m_sentSize;
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
     ConsistencyCheck();
@@ -1345,6 +1494,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        ResetScanMarks();
     }
     ConsistencyCheck();
 }
@@ -1361,18 +1511,23 @@ TcpTxBuffer::MarkHeadAsLost()
         {
             m_sentList.front()->m_sacked = false;
             m_sackedOut -= m_sentList.front()->m_packet->GetSize();
+            ResetScanMarks();
         }
 
         if (m_sentList.front()->m_retrans)
         {
             m_sentList.front()->m_retrans = false;
             m_retrans -= m_sentList.front()->m_packet->GetSize();
+            ResetScanMarks();
         }
 
         if (!m_sentList.front()->m_lost)
         {
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
+            m_lostEnd = std::max(m_lostEnd,
+                                 m_sentList.front()->m_startSeq +
+                                     m_sentList.front()->m_packet->GetSize());
         }
     }
     ConsistencyCheck();
@@ -1420,6 +1575,58 @@ TcpTxBuffer::AddRenoSack()
     ConsistencyCheck();
 }
 
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    NS_LOG_FUNCTION(this << seq);
+
+    if (m_sentList.empty())
+    {
+        return m_sentList.end();
+    }
+
+    auto distance = [&seq](PacketList::const_iterator it) {
+        return std::abs(static_cast<int64_t>(seq - (*it)->m_startSeq));
+    };
+
+    auto it = m_sentList.cbegin();
+    auto last = std::prev(m_sentList.cend());
+    if (distance(last) < distance(it))
+    {
+        it = last;
+    }
+    if (m_sentCursor != m_sentList.cend() && distance(m_sentCursor) < distance(it))
+    {
+        it = m_sentCursor;
+    }
+
+    if ((*it)->m_startSeq <= seq)
+    {
+        for (auto next = std::next(it); next != m_sentList.cend() && (*next)->m_startSeq <= seq;
+             ++next)
+        {
+            it = next;
+        }
+    }
+    else
+    {
+        while (it != m_sentList.cbegin() && (*it)->m_startSeq > seq)
+        {
+            --it;
+        }
+    }
+
+    m_sentCursor = it;
+    return it;
+}
+
+void
+TcpTxBuffer::ResetScanMarks() const
+{
+    m_nextSegFrom = m_firstByteSeq;
+    m_lostUpTo = m_firstByteSeq;
+}
+
 void
 TcpTxBuffer::ConsistencyCheck() const
 {
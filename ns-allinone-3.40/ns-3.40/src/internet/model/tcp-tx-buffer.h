@@ -74,6 +74,16 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * Every sent item knows its starting sequence, so the item holding a given
+ * sequence is reached by walking the list from the nearest of its head, its
+ * tail and the item found last: consecutive lookups, such as the SACK blocks
+ * of an ACK and the retransmission that follows, are close to each other. Two
+ * marks bound the scans that would otherwise walk the whole list on each
+ * ACK or transmission: the items before the first one are either retransmitted
+ * or SACKed (where NextSeg starts), and the items before the second one are
+ * either SACKed or lost (where UpdateLostCount stops). A third one bounds the
+ * lost items from above (where NextSeg stops looking for them).
+ *
  * Item properties
  * ---------------
  *
@@ -133,6 +143,25 @@ class TcpTxBuffer : public Object
      * \param n initial Sequence number to be transmitted
      */
     TcpTxBuffer(uint32_t n = 0);
+    /**
+     * \brief Copy constructor
+     *
+     * The items are copied with their packets.  The scan marks and the
+     * cursor of the copy are reset, so its first lookups scan its own sent
+     * list in full.
+     *
+     * \param other the buffer to copy
+     */
+    TcpTxBuffer(const TcpTxBuffer& other);
+    /**
+     * \brief Copy the items and the state of another buffer
+     *
+     * As with the copy constructor, the scan marks and the cursor are reset.
+     *
+     * \param other the buffer to copy
+     * \returns this buffer
+     */
+    TcpTxBuffer& operator=(const TcpTxBuffer& other);
     ~TcpTxBuffer() override;
 
     // Accessors
@@ -428,12 +457,30 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. The walk stops once the items left are all
+     * SACKed or lost, as nothing would change in them.
      *
      */
     void UpdateLostCount();
 
+    /**
+     * \brief Find the sent item holding a sequence
+     *
+     * The list is walked from the nearest of its head, its tail and the item
+     * found last.
+     *
+     * \param seq Sequence
+     * \return the last item starting at or before seq, the first item if there
+     * is none, or the end of the list if it is empty
+     */
+    PacketList::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
+    /**
+     * \brief Forget the scan marks, after a flag that they rely on has been
+     * cleared or the last sent item has been removed
+     */
+    void ResetScanMarks() const;
+
     /**
      * \brief Remove the size specified from the lostOut, retrans, sacked count
      *
@@ -617,6 +664,11 @@ class TcpTxBuffer : public Object
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
 
+    mutable SequenceNumber32 m_nextSegFrom; //!< The sent items before are retransmitted or SACKed
+    mutable SequenceNumber32 m_lostUpTo;    //!< The sent items before are SACKed or lost
+    SequenceNumber32 m_lostEnd;             //!< The sent items from it on are not lost
+    mutable PacketList::const_iterator m_sentCursor; //!< The sent item found last, or end
+
     uint32_t m_dupAckThresh{0}; //!< Duplicate Ack threshold from TcpSocketBase
     uint32_t m_segmentSize{0};  //!< Segment size from TcpSocketBase
     bool m_renoSack{false};     //!< Indicates if AddRenoSack was called
@@ -0,0 +1,179 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/test.h"
+
+#include <set>
+#include <type_traits>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief End point demultiplexer test: the end point found for a packet is
+ * the most specific one, also when the end points change after they were
+ * found.
+ *
+ * \tparam Demux The type of the demultiplexer.
+ * \tparam Address The type of the addresses.
+ * \tparam Interface The type of the interfaces.
+ */
+template <typename Demux, typename Address, typename Interface>
+class EndPointDemuxTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param name The name of the test case.
+     * \param local The local address.
+     * \param peer A peer address.
+     * \param otherPeer Another peer address.
+     */
+    EndPointDemuxTestCase(std::string name, Address local, Address peer, Address otherPeer);
+
+  private:
+    void DoRun() override;
+
+    /// The type of the end points
+    typedef typename std::remove_pointer<typename Demux::EndPoints::value_type>::type EndPoint;
+
+    /**
+     * Look the end point of a packet up.
+     * \param demux The demultiplexer.
+     * \param peer The source address of the packet.
+     * \returns The end point, or nullptr if none is found.
+     */
+    EndPoint* Lookup(Demux& demux, Address peer);
+
+    Address m_local;        //!< The local address
+    Address m_peer;         //!< A peer address
+    Address m_otherPeer;    //!< Another peer address
+    Ptr<Interface> m_iface; //!< The incoming interface
+};
+
+template <typename Demux, typename Address, typename Interface>
+EndPointDemuxTestCase<Demux, Address, Interface>::EndPointDemuxTestCase(std::string name,
+                                                                        Address local,
+                                                                        Address peer,
+                                                                        Address otherPeer)
+    : TestCase(name),
+      m_local(local),
+      m_peer(peer),
+      m_otherPeer(otherPeer)
+{
+}
+
+template <typename Demux, typename Address, typename Interface>
+typename EndPointDemuxTestCase<Demux, Address, Interface>::EndPoint*
+EndPointDemuxTestCase<Demux, Address, Interface>::Lookup(Demux& demux, Address peer)
+{
+    typename Demux::EndPoints endPoints = demux.Lookup(m_local, 80, peer, 1000, m_iface);
+    return endPoints.empty() ? nullptr : endPoints.front();
+}
+
+template <typename Demux, typename Address, typename Interface>
+void
+EndPointDemuxTestCase<Demux, Address, Interface>::DoRun()
+{
+    m_iface = CreateObject<Interface>();
+    Demux demux;
+
+    EndPoint* listener = demux.Allocate(nullptr, 80);
+    EndPoint* connection = demux.Allocate(nullptr, m_local, 80, m_peer, 1000);
+    NS_TEST_ASSERT_MSG_NE(listener, nullptr, "Can not allocate the listener");
+    NS_TEST_ASSERT_MSG_NE(connection, nullptr, "Can not allocate the connection");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, m_local, 80, m_peer, 1000),
+                          nullptr,
+                          "Duplicated connection allocated");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, 80), nullptr, "Duplicated listener allocated");
+
+    for (int i = 0; i < 2; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer), connection, "Connection not found");
+        NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_otherPeer), listener, "Listener not found");
+    }
+    NS_TEST_EXPECT_MSG_EQ(demux.SimpleLookup(m_local, 80, m_peer, 1000),
+                          connection,
+                          "Connection not found by SimpleLookup");
+    NS_TEST_EXPECT_MSG_EQ(demux.Lookup(m_local, 81, m_peer, 1000, m_iface).size(),
+                          0,
+                          "End point found on another port");
+
+    // The end point found last time is not used once it no longer matches
+    connection->SetPeer(m_otherPeer, 1000);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_peer), listener, "Stale connection found");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_otherPeer), connection, "Moved connection not found");
+    connection->SetRxEnabled(false);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_otherPeer), listener, "Disabled connection found");
+    connection->SetRxEnabled(true);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_otherPeer), connection, "Connection not found");
+
+    demux.DeAllocate(connection);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_otherPeer), listener, "Deallocated connection found");
+    demux.DeAllocate(listener);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, m_otherPeer), nullptr, "Deallocated listener found");
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(80), false, "Port still in use");
+
+    std::set<uint16_t> ports;
+    for (int i = 0; i < 100; i++)
+    {
+        EndPoint* endPoint = demux.Allocate();
+        NS_TEST_ASSERT_MSG_NE(endPoint, nullptr, "Can not allocate an ephemeral port");
+        NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(endPoint->GetLocalPort()),
+                              true,
+                              "Ephemeral port not in use");
+        ports.insert(endPoint->GetLocalPort());
+    }
+    NS_TEST_EXPECT_MSG_EQ(ports.size(), 100, "Ephemeral port allocated twice");
+
+    m_iface = nullptr;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief End point demultiplexer TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite()
+    : TestSuite("end-point-demux", UNIT)
+{
+    AddTestCase(new EndPointDemuxTestCase<Ipv4EndPointDemux, Ipv4Address, Ipv4Interface>(
+                    "IPv4 end point demultiplexer",
+                    "10.0.0.1",
+                    "10.0.0.2",
+                    "10.0.0.3"),
+                TestCase::QUICK);
+    AddTestCase(new EndPointDemuxTestCase<Ipv6EndPointDemux, Ipv6Address, Ipv6Interface>(
+                    "IPv6 end point demultiplexer",
+                    "2001:1::1",
+                    "2001:1::2",
+                    "2001:1::3"),
+                TestCase::QUICK);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
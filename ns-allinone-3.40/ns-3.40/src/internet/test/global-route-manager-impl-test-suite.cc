@@ -27,6 +27,7 @@
 #include "ns3/test.h"
 
 #include <cstdlib> // for rand()
+#include <vector>
 
 using namespace ns3;
 
@@ -65,13 +66,41 @@ GlobalRouteManagerImplTestCase::DoRun()
         candidate.Push(v);
     }
 
+    uint32_t lastDistance = 0;
     for (int i = 0; i < 100; ++i)
     {
         SPFVertex* v = candidate.Pop();
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(v->GetDistanceFromRoot(),
+                                    lastDistance,
+                                    "Candidates should be popped by increasing distance");
+        lastDistance = v->GetDistanceFromRoot();
         delete v;
         v = nullptr;
     }
 
+    // Equal candidates are popped in the order they were pushed, or last
+    // reordered, in
+    std::vector<SPFVertex*> vertices;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        auto v = new SPFVertex;
+        v->SetVertexId(Ipv4Address(i + 1));
+        v->SetDistanceFromRoot(i == 1 ? 7 : 5);
+        candidate.Push(v);
+        vertices.push_back(v);
+    }
+    NS_TEST_EXPECT_MSG_EQ(candidate.Find(Ipv4Address(2)), vertices[1], "Wrong candidate found");
+    vertices[1]->SetDistanceFromRoot(5);
+    candidate.Reorder(vertices[1]);
+    NS_TEST_EXPECT_MSG_EQ(candidate.Pop(), vertices[0], "Wrong candidate popped");
+    NS_TEST_EXPECT_MSG_EQ(candidate.Pop(), vertices[2], "Wrong candidate popped");
+    NS_TEST_EXPECT_MSG_EQ(candidate.Pop(), vertices[1], "Wrong candidate popped");
+    NS_TEST_EXPECT_MSG_EQ(candidate.Find(Ipv4Address(2)), nullptr, "Popped candidate found");
+    for (auto v : vertices)
+    {
+        delete v;
+    }
+
     // Build fake link state database; four routers (0-3), 3 point-to-point
     // links
     //
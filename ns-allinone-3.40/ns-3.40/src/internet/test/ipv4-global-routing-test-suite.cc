@@ -16,6 +16,7 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -41,6 +42,7 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1311,6 +1313,212 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Test that the routes computed on several threads are those
+ * computed on one.
+ */
+class Ipv4GlobalRoutingThreadsTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingThreadsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Compute the global routes.
+     * \param nodes The nodes.
+     * \param threads The number of threads computing the routes.
+     * \returns The routing tables of the nodes.
+     */
+    std::string ComputeRoutes(const NodeContainer& nodes, uint32_t threads);
+};
+
+Ipv4GlobalRoutingThreadsTestCase::Ipv4GlobalRoutingThreadsTestCase()
+    : TestCase("Global routing computed on several threads")
+{
+}
+
+std::string
+Ipv4GlobalRoutingThreadsTestCase::ComputeRoutes(const NodeContainer& nodes, uint32_t threads)
+{
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(threads));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(1));
+
+    std::ostringstream routes;
+    for (auto i = nodes.Begin(); i != nodes.End(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> gr = (*i)->GetObject<GlobalRouter>()->GetRoutingProtocol();
+        routes << "Node " << (*i)->GetId() << std::endl;
+        for (uint32_t j = 0; j < gr->GetNRoutes(); j++)
+        {
+            routes << *gr->GetRoute(j) << std::endl;
+        }
+    }
+    return routes.str();
+}
+
+// A ring of six routers, with equal cost paths across it, and a LAN
+// joining two neighbours (SPF does not support several equal cost paths
+// to a network)
+void
+Ipv4GlobalRoutingThreadsTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(6);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.252");
+    devHelper.SetNetDevicePointToPointMode(true);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        NodeContainer link(nodes.Get(i), nodes.Get((i + 1) % nodes.GetN()));
+        ipv4.Assign(devHelper.Install(link));
+        ipv4.NewNetwork();
+    }
+
+    ipv4.SetBase("10.2.0.0", "255.255.255.0");
+    devHelper.SetNetDevicePointToPointMode(false);
+    ipv4.Assign(devHelper.Install(NodeContainer(nodes.Get(0), nodes.Get(1))));
+
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::string serial = ComputeRoutes(nodes, 1);
+    std::string parallel = ComputeRoutes(nodes, 4);
+
+    NS_TEST_EXPECT_MSG_NE(serial.find("10.2.0.0"), std::string::npos, "No route to the LAN");
+    NS_TEST_EXPECT_MSG_EQ(parallel, serial, "The routes depend on the number of threads");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Checks that the routes looked up in the compiled tables are the
+ * ones found by scanning the routing table.
+ */
+class Ipv4GlobalRoutingCompiledLookupTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingCompiledLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a routing protocol holding the routes of the test.
+     * \param ipv4 The IPv4 stack.
+     * \param compiled Whether to look the routes up in the compiled tables.
+     * \returns The routing protocol.
+     */
+    Ptr<Ipv4GlobalRouting> CreateRouting(Ptr<Ipv4> ipv4, bool compiled);
+};
+
+Ipv4GlobalRoutingCompiledLookupTestCase::Ipv4GlobalRoutingCompiledLookupTestCase()
+    : TestCase("Global routing lookup in the compiled tables")
+{
+}
+
+Ptr<Ipv4GlobalRouting>
+Ipv4GlobalRoutingCompiledLookupTestCase::CreateRouting(Ptr<Ipv4> ipv4, bool compiled)
+{
+    Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting>();
+    routing->SetAttribute("CompiledLookup", BooleanValue(compiled));
+    routing->SetAttribute("RandomEcmpRouting", BooleanValue(true));
+    routing->AssignStreams(1);
+    routing->SetIpv4(ipv4);
+
+    // Equal cost host routes
+    routing->AddHostRouteTo("10.1.2.3", "10.0.1.2", 1);
+    routing->AddHostRouteTo("10.1.2.3", "10.0.2.2", 2);
+    routing->AddHostRouteTo("10.1.2.4", "10.0.3.2", 3);
+    // Nested network routes, all of which are used by the scan
+    routing->AddNetworkRouteTo("10.0.0.0", "255.0.0.0", "10.0.1.2", 1);
+    routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "10.0.2.2", 2);
+    routing->AddNetworkRouteTo("10.1.2.0", "255.255.255.0", "10.0.3.2", 3);
+    routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "10.0.3.2", 3);
+    routing->AddNetworkRouteTo("10.2.0.0", "255.255.0.0", "10.0.1.2", 1);
+    // External routes, of which the first one matching is used
+    routing->AddASExternalRouteTo("11.1.0.0", "255.255.0.0", "10.0.1.2", 1);
+    routing->AddASExternalRouteTo("0.0.0.0", "0.0.0.0", "10.0.2.2", 2);
+    routing->AddASExternalRouteTo("11.1.1.0", "255.255.255.0", "10.0.3.2", 3);
+    return routing;
+}
+
+void
+Ipv4GlobalRoutingCompiledLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.1.0", "255.255.255.0");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ipv4.Assign(devHelper.Install(node));
+        ipv4.NewNetwork();
+    }
+
+    Ptr<Ipv4GlobalRouting> scanned = CreateRouting(node->GetObject<Ipv4>(), false);
+    Ptr<Ipv4GlobalRouting> compiled = CreateRouting(node->GetObject<Ipv4>(), true);
+
+    std::vector<Ipv4Address> destinations = {"10.1.2.3",
+                                             "10.1.2.4",
+                                             "10.1.2.5",
+                                             "10.1.3.1",
+                                             "10.2.0.1",
+                                             "10.3.0.1",
+                                             "11.1.1.1",
+                                             "11.2.0.1",
+                                             "12.0.0.1"};
+    for (int round = 0; round < 8; round++)
+    {
+        for (const auto& destination : destinations)
+        {
+            Ipv4Header header;
+            header.SetDestination(destination);
+            Socket::SocketErrno error;
+            Ptr<Ipv4Route> expected = scanned->RouteOutput(nullptr, header, nullptr, error);
+            Ptr<Ipv4Route> route = compiled->RouteOutput(nullptr, header, nullptr, error);
+            NS_TEST_ASSERT_MSG_NE(route, nullptr, "No route to " << destination);
+            NS_TEST_EXPECT_MSG_EQ(route->GetGateway(),
+                                  expected->GetGateway(),
+                                  "Wrong gateway to " << destination);
+            NS_TEST_EXPECT_MSG_EQ(route->GetOutputDevice(),
+                                  expected->GetOutputDevice(),
+                                  "Wrong device to " << destination);
+            NS_TEST_EXPECT_MSG_EQ(route->GetSource(),
+                                  expected->GetSource(),
+                                  "Wrong source to " << destination);
+        }
+    }
+
+    // The tables follow the changes of the routes
+    compiled->SetAttribute("RandomEcmpRouting", BooleanValue(false));
+    compiled->RemoveRoute(0);
+    compiled->RemoveRoute(0);
+    Ipv4Header header;
+    header.SetDestination("10.1.2.3");
+    Socket::SocketErrno error;
+    Ptr<Ipv4Route> route = compiled->RouteOutput(nullptr, header, nullptr, error);
+    NS_TEST_ASSERT_MSG_NE(route, nullptr, "No route to 10.1.2.3");
+    NS_TEST_EXPECT_MSG_EQ(route->GetGateway(),
+                          Ipv4Address("10.0.1.2"),
+                          "The host routes were not removed");
+
+    scanned->Dispose();
+    compiled->Dispose();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1541,8 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingThreadsTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingCompiledLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -21,6 +21,7 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
@@ -35,6 +36,8 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -207,6 +210,126 @@ Ipv4StaticRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Checks that the routes looked up in the compiled table are the
+ * ones found by scanning the routing table.
+ */
+class Ipv4StaticRoutingCompiledLookupTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingCompiledLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a routing protocol holding the routes of the test.
+     * \param ipv4 The IPv4 stack.
+     * \param compiled Whether to look the routes up in the compiled table.
+     * \returns The routing protocol.
+     */
+    Ptr<Ipv4StaticRouting> CreateRouting(Ptr<Ipv4> ipv4, bool compiled);
+
+    /**
+     * \brief Checks that both routing protocols choose the same routes.
+     * \param scanned The routing protocol scanning its routes.
+     * \param compiled The routing protocol using the compiled table.
+     */
+    void CheckRoutes(Ptr<Ipv4StaticRouting> scanned, Ptr<Ipv4StaticRouting> compiled);
+};
+
+Ipv4StaticRoutingCompiledLookupTestCase::Ipv4StaticRoutingCompiledLookupTestCase()
+    : TestCase("Static routing lookup in the compiled table")
+{
+}
+
+Ptr<Ipv4StaticRouting>
+Ipv4StaticRoutingCompiledLookupTestCase::CreateRouting(Ptr<Ipv4> ipv4, bool compiled)
+{
+    Ptr<Ipv4StaticRouting> routing = CreateObject<Ipv4StaticRouting>();
+    routing->SetAttribute("CompiledLookup", BooleanValue(compiled));
+    routing->SetIpv4(ipv4);
+
+    // The last route with the lowest metric wins
+    routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "10.0.1.2", 1, 5);
+    routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "10.0.2.2", 2, 2);
+    routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "10.0.3.2", 3, 2);
+    routing->AddNetworkRouteTo("10.1.0.0", "255.255.0.0", "10.0.1.2", 1, 9);
+    // ... but the first host route wins
+    routing->AddHostRouteTo("10.1.2.3", "10.0.2.2", 2, 7);
+    routing->AddHostRouteTo("10.1.2.3", "10.0.3.2", 3, 1);
+    routing->AddNetworkRouteTo("10.1.3.0", "255.255.255.0", "10.0.1.2", 1, 0);
+    routing->SetDefaultRoute("10.0.2.2", 2, 3);
+    return routing;
+}
+
+void
+Ipv4StaticRoutingCompiledLookupTestCase::CheckRoutes(Ptr<Ipv4StaticRouting> scanned,
+                                                     Ptr<Ipv4StaticRouting> compiled)
+{
+    std::vector<Ipv4Address> destinations =
+        {"10.1.2.3", "10.1.2.4", "10.1.3.9", "10.0.2.7", "12.0.0.1", "127.0.0.1"};
+    for (const auto& destination : destinations)
+    {
+        Ipv4Header header;
+        header.SetDestination(destination);
+        Socket::SocketErrno error;
+        Ptr<Ipv4Route> expected = scanned->RouteOutput(nullptr, header, nullptr, error);
+        Ptr<Ipv4Route> route = compiled->RouteOutput(nullptr, header, nullptr, error);
+        NS_TEST_ASSERT_MSG_NE(route, nullptr, "No route to " << destination);
+        NS_TEST_EXPECT_MSG_EQ(route->GetGateway(),
+                              expected->GetGateway(),
+                              "Wrong gateway to " << destination);
+        NS_TEST_EXPECT_MSG_EQ(route->GetOutputDevice(),
+                              expected->GetOutputDevice(),
+                              "Wrong device to " << destination);
+        NS_TEST_EXPECT_MSG_EQ(route->GetSource(),
+                              expected->GetSource(),
+                              "Wrong source to " << destination);
+    }
+}
+
+void
+Ipv4StaticRoutingCompiledLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.1.0", "255.255.255.0");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ipv4.Assign(devHelper.Install(node));
+        ipv4.NewNetwork();
+    }
+
+    Ptr<Ipv4StaticRouting> scanned = CreateRouting(node->GetObject<Ipv4>(), false);
+    Ptr<Ipv4StaticRouting> compiled = CreateRouting(node->GetObject<Ipv4>(), true);
+    CheckRoutes(scanned, compiled);
+
+    Ipv4Header header;
+    header.SetDestination("10.1.2.4");
+    Socket::SocketErrno error;
+    Ptr<Ipv4Route> route = compiled->RouteOutput(nullptr, header, nullptr, error);
+    NS_TEST_ASSERT_MSG_NE(route, nullptr, "No route to 10.1.2.4");
+    NS_TEST_EXPECT_MSG_EQ(route->GetGateway(), Ipv4Address("10.0.3.2"), "Wrong metric tie-break");
+
+    // The table follows the changes of the routes
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        scanned->RemoveRoute(scanned->GetNRoutes() - 4);
+        compiled->RemoveRoute(compiled->GetNRoutes() - 4);
+        CheckRoutes(scanned, compiled);
+    }
+
+    scanned->Dispose();
+    compiled->Dispose();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -222,6 +345,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite()
     : TestSuite("ipv4-static-routing", UNIT)
 {
     AddTestCase(new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4StaticRoutingCompiledLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite
@@ -16,11 +16,15 @@
 
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/tcp-tx-buffer.h"
 #include "ns3/test.h"
 
 #include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -430,6 +434,517 @@ TcpTxBufferTestCase::DoTeardown()
 {
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Checks that a TcpTxBuffer copied by CopyObject, as a listening
+ * socket does when it forks, works on its own items once the original is gone.
+ */
+class TcpTxBufferCopyTestCase : public TestCase
+{
+  public:
+    TcpTxBufferCopyTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run the same transfer on a buffer and on a reference buffer
+     * \param txBuf the buffer
+     * \param ref the reference buffer
+     */
+    void Transfer(Ptr<TcpTxBuffer> txBuf, Ptr<TcpTxBuffer> ref);
+
+    /**
+     * \brief Callback to provide a value of receiver window
+     * \returns the receiver window size
+     */
+    uint32_t GetRWnd() const;
+};
+
+TcpTxBufferCopyTestCase::TcpTxBufferCopyTestCase()
+    : TestCase("TcpTxBuffer copied by a forking socket")
+{
+}
+
+uint32_t
+TcpTxBufferCopyTestCase::GetRWnd() const
+{
+    return 100000;
+}
+
+void
+TcpTxBufferCopyTestCase::Transfer(Ptr<TcpTxBuffer> txBuf, Ptr<TcpTxBuffer> ref)
+{
+    for (auto buf : {txBuf, ref})
+    {
+        buf->Add(Create<Packet>(10000));
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            buf->CopyFromSequence(1000, SequenceNumber32(1001 + i * 1000));
+        }
+        TcpOptionSack::SackList sack;
+        sack.emplace_back(SequenceNumber32(3001), SequenceNumber32(7001));
+        buf->Update(sack);
+    }
+
+    SequenceNumber32 seq;
+    SequenceNumber32 seqHigh;
+    SequenceNumber32 refSeq;
+    SequenceNumber32 refSeqHigh;
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&seq, &seqHigh, true),
+                          ref->NextSeg(&refSeq, &refSeqHigh, true),
+                          "NextSeg differs on the copy");
+    NS_TEST_ASSERT_MSG_EQ(seq, refSeq, "NextSeg differs on the copy");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(1001)),
+                          ref->IsLost(SequenceNumber32(1001)),
+                          "IsLost differs on the copy");
+    txBuf->CopyFromSequence(1000, seq);
+    ref->CopyFromSequence(1000, refSeq);
+    txBuf->DiscardUpTo(SequenceNumber32(8001));
+    ref->DiscardUpTo(SequenceNumber32(8001));
+
+    std::ostringstream copyState;
+    std::ostringstream refState;
+    copyState << *txBuf;
+    refState << *ref;
+    NS_TEST_ASSERT_MSG_EQ(copyState.str(), refState.str(), "The copy lost track of its items");
+}
+
+void
+TcpTxBufferCopyTestCase::DoRun()
+{
+    Ptr<TcpTxBuffer> listener = CreateObject<TcpTxBuffer>();
+    listener->SetRWndCallback(MakeCallback(&TcpTxBufferCopyTestCase::GetRWnd, this));
+    listener->SetSegmentSize(1000);
+    listener->SetDupAckThresh(3);
+
+    // A forked socket copies the empty buffer of its listener
+    Ptr<TcpTxBuffer> forked = CopyObject(listener);
+    forked->SetHeadSequence(SequenceNumber32(1001));
+    Ptr<TcpTxBuffer> ref = CreateObject<TcpTxBuffer>();
+    ref->SetRWndCallback(MakeCallback(&TcpTxBufferCopyTestCase::GetRWnd, this));
+    ref->SetSegmentSize(1000);
+    ref->SetDupAckThresh(3);
+    ref->SetHeadSequence(SequenceNumber32(1001));
+    listener = nullptr;
+    Transfer(forked, ref);
+
+    // A copy of a buffer in the middle of a recovery goes on with it
+    Ptr<TcpTxBuffer> copy = CopyObject(forked);
+    forked = nullptr;
+    std::ostringstream copyState;
+    std::ostringstream refState;
+    copy->Add(Create<Packet>(5000));
+    ref->Add(Create<Packet>(5000));
+    TcpOptionSack::SackList sack;
+    sack.emplace_back(SequenceNumber32(9001), SequenceNumber32(10001));
+    NS_TEST_ASSERT_MSG_EQ(copy->Update(sack), ref->Update(sack), "Update differs on the copy");
+    NS_TEST_ASSERT_MSG_EQ(copy->BytesInFlight(),
+                          ref->BytesInFlight(),
+                          "BytesInFlight differs on the copy");
+    copyState << *copy;
+    refState << *ref;
+    NS_TEST_ASSERT_MSG_EQ(copyState.str(), refState.str(), "The copy lost track of its items");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Checks the cursor and the scan marks of TcpTxBuffer with random
+ * operations.
+ *
+ * Before each operation, the buffer is copied; the copy has no cursor and
+ * no scan marks, so it scans its items from the start.  The same operation
+ * is done on both, which must return the same results and end in the same
+ * state.  From time to time the test goes on with the copy, as a forked
+ * socket does.
+ */
+class TcpTxBufferRandomTestCase : public TestCase
+{
+  public:
+    TcpTxBufferRandomTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run random operations on a buffer
+     * \param seed the seed of the operations
+     * \param steps the number of operations
+     */
+    void RunBuffer(uint32_t seed, uint32_t steps);
+
+    /**
+     * \brief Draw a random number
+     * \param n the number of values
+     * \returns a number between 0 and n - 1, or 0 if n is 0
+     */
+    uint32_t Draw(uint32_t n);
+
+    /**
+     * \brief Record the items passed to the callback of the buffer
+     * \param item the item
+     */
+    void RecordBuf(TcpTxItem* item);
+
+    /**
+     * \brief Record the items passed to the callback of the copy
+     * \param item the item
+     */
+    void RecordRef(TcpTxItem* item);
+
+    /**
+     * \brief Callback to provide a value of receiver window
+     * \returns the receiver window size
+     */
+    uint32_t GetRWnd() const;
+
+    /**
+     * \brief Print an item
+     * \param item the item, or nullptr
+     * \returns the item as a string
+     */
+    static std::string Str(TcpTxItem* item);
+
+    /// A sent item, as printed by the buffer
+    struct SentItem
+    {
+        uint32_t start;  //!< First sequence number
+        uint32_t length; //!< Length
+        bool sacked;     //!< Whether the item is SACKed
+    };
+
+    /**
+     * \brief Parse the sent items of a buffer
+     * \param state the buffer, as printed
+     * \returns the sent items
+     */
+    static std::vector<SentItem> SentItems(const std::string& state);
+
+    Ptr<UniformRandomVariable> m_rng; //!< Random operations
+    uint32_t m_rWnd{0};               //!< Receiver window
+    std::string m_cbBuf;              //!< Items passed to the callback of the buffer
+    std::string m_cbRef;              //!< Items passed to the callback of the copy
+};
+
+TcpTxBufferRandomTestCase::TcpTxBufferRandomTestCase()
+    : TestCase("TcpTxBuffer scan marks compared with full scans")
+{
+}
+
+uint32_t
+TcpTxBufferRandomTestCase::Draw(uint32_t n)
+{
+    return n > 0 ? m_rng->GetInteger(0, n - 1) : 0;
+}
+
+void
+TcpTxBufferRandomTestCase::RecordBuf(TcpTxItem* item)
+{
+    m_cbBuf += Str(item) + ";";
+}
+
+void
+TcpTxBufferRandomTestCase::RecordRef(TcpTxItem* item)
+{
+    m_cbRef += Str(item) + ";";
+}
+
+uint32_t
+TcpTxBufferRandomTestCase::GetRWnd() const
+{
+    return m_rWnd;
+}
+
+std::string
+TcpTxBufferRandomTestCase::Str(TcpTxItem* item)
+{
+    if (item == nullptr)
+    {
+        return "null";
+    }
+    std::ostringstream os;
+    item->Print(os);
+    return os.str();
+}
+
+std::vector<TcpTxBufferRandomTestCase::SentItem>
+TcpTxBufferRandomTestCase::SentItems(const std::string& state)
+{
+    std::vector<SentItem> items;
+    for (std::size_t q = state.find("{["); q != std::string::npos; q = state.find("{[", q + 2))
+    {
+        std::string item = state.substr(q, state.find('}', q) - q);
+        items.push_back({static_cast<uint32_t>(std::stoul(item.substr(2))),
+                         static_cast<uint32_t>(std::stoul(item.substr(item.find('|') + 1))),
+                         item.find("sacked") != std::string::npos});
+    }
+    return items;
+}
+
+void
+TcpTxBufferRandomTestCase::RunBuffer(uint32_t seed, uint32_t steps)
+{
+    m_rng->SetStream(seed);
+    SequenceNumber32 head(Draw(4) == 0 ? 0xffffffff - Draw(50000) : Draw(100000));
+    uint32_t mss = 500 + Draw(1000);
+    bool sackEnabled = Draw(4) != 0;
+
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetHeadSequence(head);
+    txBuf->SetMaxBufferSize(200000);
+    txBuf->SetSegmentSize(mss);
+    txBuf->SetDupAckThresh(1 + Draw(4));
+    txBuf->SetSackEnabled(sackEnabled);
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferRandomTestCase::GetRWnd, this));
+
+    for (uint32_t step = 0; step < steps; step++)
+    {
+        std::ostringstream os;
+        os << *txBuf;
+        std::string state = os.str();
+        SequenceNumber32 first = txBuf->HeadSequence();
+        uint32_t sent = std::stoul(state.substr(state.find("m_sentSize = ") + 13));
+        SequenceNumber32 sentEnd = first + sent;
+        uint32_t size = txBuf->Size();
+        std::vector<SentItem> items = SentItems(state);
+
+        Ptr<TcpTxBuffer> ref = CopyObject(txBuf);
+        m_cbBuf.clear();
+        m_cbRef.clear();
+        uint32_t op = Draw(18);
+        switch (op)
+        {
+        case 0:
+        case 1: {
+            Ptr<Packet> p = Create<Packet>(1 + Draw(3 * mss));
+            NS_TEST_ASSERT_MSG_EQ(txBuf->Add(p), ref->Add(p), "Add differs");
+            break;
+        }
+        case 2:
+        case 3:
+            if (size > sent)
+            {
+                uint32_t n = 1 + Draw(2 * mss);
+                NS_TEST_ASSERT_MSG_EQ(Str(txBuf->CopyFromSequence(n, sentEnd)),
+                                      Str(ref->CopyFromSequence(n, sentEnd)),
+                                      "CopyFromSequence of new data differs");
+                if (Draw(5) == 0)
+                {
+                    txBuf->ResetLastSegmentSent();
+                    ref->ResetLastSegmentSent();
+                }
+            }
+            break;
+        case 4: {
+            // Retransmit all or part of an item which is not SACKed
+            std::vector<SentItem> candidates;
+            for (const auto& item : items)
+            {
+                if (!item.sacked)
+                {
+                    candidates.push_back(item);
+                }
+            }
+            if (!candidates.empty())
+            {
+                SentItem item = candidates[Draw(candidates.size())];
+                SequenceNumber32 seq(item.start);
+                uint32_t n = 1 + Draw(2 * mss);
+                if (Draw(4) == 0)
+                {
+                    uint32_t offset = Draw(item.length);
+                    seq += offset;
+                    n = 1 + Draw(item.length - offset);
+                }
+                if ((sentEnd.GetValue() < seq.GetValue() ||
+                     static_cast<uint64_t>(seq.GetValue()) + n > 0xffffffffULL) &&
+                    seq + n > sentEnd)
+                {
+                    // A partial retransmission is not split across the wrap
+                    // of the sequence numbers
+                    n = sentEnd - seq;
+                }
+                NS_TEST_ASSERT_MSG_EQ(Str(txBuf->CopyFromSequence(n, seq)),
+                                      Str(ref->CopyFromSequence(n, seq)),
+                                      "CopyFromSequence of sent data differs");
+            }
+            break;
+        }
+        case 5:
+        case 6:
+            if (sent > 0 && sackEnabled)
+            {
+                // SACK blocks mostly on item boundaries, never covering the head
+                std::vector<uint32_t> starts;
+                for (const auto& item : items)
+                {
+                    starts.push_back(item.start);
+                }
+                starts.push_back(sentEnd.GetValue());
+                TcpOptionSack::SackList list;
+                bool headCovered = false;
+                for (uint32_t blocks = 1 + Draw(4); blocks > 0; blocks--)
+                {
+                    std::size_t ia = std::min<std::size_t>(1 + Draw(starts.size() - 1),
+                                                           starts.size() - 1);
+                    std::size_t ib = std::min<std::size_t>(ia + 1 + Draw(4), starts.size() - 1);
+                    SequenceNumber32 a(starts[ia]);
+                    SequenceNumber32 b(starts[ib]);
+                    a += Draw(5) == 0 ? Draw(mss) : 0;
+                    b += Draw(5) == 0 ? Draw(mss) : 0;
+                    if (Draw(20) == 0 || a <= first)
+                    {
+                        a = first + 1;
+                    }
+                    if (Draw(30) == 0)
+                    {
+                        b = sentEnd + Draw(5000);
+                    }
+                    headCovered |= a <= first && SequenceNumber32(starts[1]) <= b;
+                    list.emplace_back(a, b);
+                }
+                if (!headCovered)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(
+                        txBuf->Update(list,
+                                      MakeCallback(&TcpTxBufferRandomTestCase::RecordBuf, this)),
+                        ref->Update(list,
+                                    MakeCallback(&TcpTxBufferRandomTestCase::RecordRef, this)),
+                        "Update differs");
+                }
+            }
+            break;
+        case 7:
+        case 8:
+            if (size > 0)
+            {
+                uint32_t n = Draw(3) == 0 ? Draw(size + 1) : Draw(std::min(size, sent + 1) + 1);
+                n = std::min(n, size - 1);
+                // The receiver also acknowledges the SACKed data that follows
+                SequenceNumber32 seq = first + n;
+                for (const auto& item : items)
+                {
+                    if (item.sacked && SequenceNumber32(item.start) <= seq &&
+                        seq < SequenceNumber32(item.start) + item.length)
+                    {
+                        seq = SequenceNumber32(item.start) + item.length;
+                    }
+                }
+                txBuf->DiscardUpTo(seq, MakeCallback(&TcpTxBufferRandomTestCase::RecordBuf, this));
+                ref->DiscardUpTo(seq, MakeCallback(&TcpTxBufferRandomTestCase::RecordRef, this));
+            }
+            break;
+        case 9:
+        case 10: {
+            SequenceNumber32 seq;
+            SequenceNumber32 seqHigh;
+            SequenceNumber32 refSeq;
+            SequenceNumber32 refSeqHigh;
+            bool isRecovery = Draw(2);
+            m_rWnd = Draw(4) ? 1000000 : Draw(sent + 2 * mss);
+            bool found = txBuf->NextSeg(&seq, &seqHigh, isRecovery);
+            NS_TEST_ASSERT_MSG_EQ(found,
+                                  ref->NextSeg(&refSeq, &refSeqHigh, isRecovery),
+                                  "NextSeg differs");
+            if (found)
+            {
+                NS_TEST_ASSERT_MSG_EQ(seq, refSeq, "NextSeg differs");
+                NS_TEST_ASSERT_MSG_EQ(seqHigh, refSeqHigh, "NextSeg differs");
+            }
+            break;
+        }
+        case 11:
+            for (uint32_t k = 0; k < 5; k++)
+            {
+                SequenceNumber32 seq = first + Draw(sent + 2) - 1;
+                NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(seq), ref->IsLost(seq), "IsLost differs");
+                SequenceNumber32 ack = first + Draw(sent + 3) - 1;
+                NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(ack),
+                                      ref->IsRetransmittedDataAcked(ack),
+                                      "IsRetransmittedDataAcked differs");
+            }
+            break;
+        case 12:
+            switch (Draw(8))
+            {
+            case 0: {
+                bool resetSack = Draw(2);
+                txBuf->SetSentListLost(resetSack);
+                ref->SetSentListLost(resetSack);
+                break;
+            }
+            case 1:
+                txBuf->ResetSentList();
+                ref->ResetSentList();
+                break;
+            case 2:
+            case 3:
+                txBuf->MarkHeadAsLost();
+                ref->MarkHeadAsLost();
+                break;
+            case 4:
+                txBuf->DeleteRetransmittedFlagFromHead();
+                ref->DeleteRetransmittedFlagFromHead();
+                break;
+            case 5:
+                if (!sackEnabled && txBuf->GetLost() == 0 && items.size() > 1)
+                {
+                    txBuf->AddRenoSack();
+                    ref->AddRenoSack();
+                }
+                break;
+            default:
+                txBuf->ResetRenoSack();
+                ref->ResetRenoSack();
+                break;
+            }
+            break;
+        case 13:
+            // Go on with the copy, as a forked socket
+            txBuf = CopyObject(ref);
+            ref = CopyObject(txBuf);
+            break;
+        default:
+            // New data in bulk, as a sender would send it
+            while (txBuf->Size() > sent && Draw(8))
+            {
+                TcpTxItem* item = txBuf->CopyFromSequence(mss, sentEnd);
+                NS_TEST_ASSERT_MSG_EQ(Str(item),
+                                      Str(ref->CopyFromSequence(mss, sentEnd)),
+                                      "CopyFromSequence of new data differs");
+                sent += item->GetSeqSize();
+                sentEnd = first + sent;
+            }
+            break;
+        }
+
+        NS_TEST_ASSERT_MSG_EQ(m_cbBuf, m_cbRef, "The callbacks differ");
+        NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(),
+                              ref->BytesInFlight(),
+                              "BytesInFlight differs");
+        NS_TEST_ASSERT_MSG_EQ(txBuf->IsHeadRetransmitted(),
+                              ref->IsHeadRetransmitted(),
+                              "IsHeadRetransmitted differs");
+        std::ostringstream bufState;
+        std::ostringstream refState;
+        bufState << *txBuf;
+        refState << *ref;
+        NS_TEST_ASSERT_MSG_EQ(bufState.str(), refState.str(), "The states differ at step " << step);
+    }
+}
+
+void
+TcpTxBufferRandomTestCase::DoRun()
+{
+    m_rng = CreateObject<UniformRandomVariable>();
+    for (uint32_t seed = 1; seed <= 20; seed++)
+    {
+        RunBuffer(seed, 1000);
+    }
+}
+
 /**
  * \ingroup internet-test
  *
@@ -442,6 +957,8 @@ class TcpTxBufferTestSuite : public TestSuite
         : TestSuite("tcp-tx-buffer", UNIT)
     {
         AddTestCase(new TcpTxBufferTestCase, TestCase::QUICK);
+        AddTestCase(new TcpTxBufferCopyTestCase, TestCase::QUICK);
+        AddTestCase(new TcpTxBufferRandomTestCase, TestCase::QUICK);
     }
 };
 
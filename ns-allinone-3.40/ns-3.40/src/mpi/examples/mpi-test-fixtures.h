@@ -20,6 +20,7 @@
 #ifndef MPI_TEST_FIXTURES_H
 #define MPI_TEST_FIXTURES_H
 
+#include <atomic>
 #include <iomanip>
 #include <ios>
 #include <sstream>
@@ -152,10 +153,10 @@ class SinkTracer
     }
 
   private:
-    static unsigned long m_sinkCount; //!< Running sum of number of SinkTrace calls observed
-    static unsigned long m_line;      //!< Current output line number for ordering output
-    static int m_worldRank;           //!< MPI CommWorld rank
-    static int m_worldSize;           //!< MPI CommWorld size
+    static std::atomic<unsigned long> m_sinkCount; //!< Running sum of SinkTrace calls observed
+    static unsigned long m_line;                   //!< Current output line number for ordering
+    static int m_worldRank;                        //!< MPI CommWorld rank
+    static int m_worldSize;                        //!< MPI CommWorld size
 };
 
 } // namespace ns3
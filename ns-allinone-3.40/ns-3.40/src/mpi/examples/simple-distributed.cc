@@ -42,11 +42,16 @@
  *
  * One packet is sent from each left leaf node.  The packet sinks on the
  * right leaf nodes output logging information when they receive the packet.
+ *
+ * With --detour, a node n10 with system id 0 is attached to n5, and n3
+ * sends to it instead of n9: its packets leave rank 0 and come back to it.
+ * The flow monitor must count them as received, with the hop on rank 1.
  */
 
 #include "mpi-test-fixtures.h"
 
 #include "ns3/core-module.h"
+#include "ns3/flow-monitor-helper.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
@@ -55,7 +60,10 @@
 #include "ns3/nix-vector-helper.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/packet-sink-helper.h"
+#include "ns3/partition-helper.h"
 #include "ns3/point-to-point-helper.h"
+#include "ns3/remote-packet-codec.h"
+#include "ns3/sync-telemetry.h"
 
 #include <iomanip>
 #include <mpi.h>
@@ -69,7 +77,20 @@ main(int argc, char* argv[])
 {
     bool nix = true;
     bool nullmsg = false;
+    bool demand = false;
+    bool aggregate = false;
+    bool neighbor = false;
+    bool nonblocking = false;
+    bool partition = false;
+    uint32_t threads = 0;
+    uint32_t packets = 1;
+    uint32_t ring = 1 << 20;
+    bool compact = false;
     bool tracing = false;
+    bool flowmon = false;
+    bool detour = false;
+    bool pool = false;
+    bool ghost = false;
     bool testing = false;
     bool verbose = true;
 
@@ -77,23 +98,57 @@ main(int argc, char* argv[])
     CommandLine cmd(__FILE__);
     cmd.AddValue("nix", "Enable the use of nix-vector or global routing", nix);
     cmd.AddValue("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+    cmd.AddValue("demand", "Only send null messages to blocked neighbors", demand);
+    cmd.AddValue("aggregate", "Aggregate packets sent to a remote rank in each window", aggregate);
+    cmd.AddValue("neighbor", "Use the per rank lookahead to grant time windows", neighbor);
+    cmd.AddValue("nonblocking", "Overlap the LBTS computation with event execution", nonblocking);
+    cmd.AddValue("partition", "Assign the system ids by partitioning the topology", partition);
+    cmd.AddValue("threads", "Execute the nodes of each rank on this many threads", threads);
+    cmd.AddValue("packets", "Number of packets sent by each left leaf node", packets);
+    cmd.AddValue("ring", "Size of the shared memory ring to each rank on this host", ring);
+    cmd.AddValue("compact", "Use the compact encoding for packets sent to other ranks", compact);
     cmd.AddValue("tracing", "Enable pcap tracing", tracing);
+    cmd.AddValue("flowmon", "Monitor the flows and gather their statistics on rank 0", flowmon);
+    cmd.AddValue("detour",
+                 "Send from the last left leaf node back to rank 0 through rank 1",
+                 detour);
+    cmd.AddValue("pool", "Check that the MPI sends reuse their buffers", pool);
+    cmd.AddValue("ghost", "Make the nodes of the other rank lightweight ghost nodes", ghost);
     cmd.AddValue("verbose", "verbose output", verbose);
     cmd.AddValue("test", "Enable regression test output", testing);
     cmd.Parse(argc, argv);
 
     // Distributed simulation setup; by default use granted time window algorithm.
-    if (nullmsg)
+    if (threads > 0)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::HybridSimulatorImpl"));
+        Config::SetDefault("ns3::HybridSimulatorImpl::ThreadCount", UintegerValue(threads));
+        Config::SetDefault("ns3::HybridSimulatorImpl::SharedMemoryRingSize", UintegerValue(ring));
+    }
+    else if (nullmsg)
     {
         GlobalValue::Bind("SimulatorImplementationType",
                           StringValue("ns3::NullMessageSimulatorImpl"));
+        Config::SetDefault("ns3::NullMessageSimulatorImpl::DemandDriven", BooleanValue(demand));
     }
     else
     {
         GlobalValue::Bind("SimulatorImplementationType",
                           StringValue("ns3::DistributedSimulatorImpl"));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::AggregatePackets",
+                           BooleanValue(aggregate));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::NeighborLookahead",
+                           BooleanValue(neighbor));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::NonBlockingLbts",
+                           BooleanValue(nonblocking));
+        Config::SetDefault("ns3::DistributedSimulatorImpl::SharedMemoryRingSize",
+                           UintegerValue(ring));
     }
 
+    RemotePacketCodec::SetCompact(compact);
+    GlobalValue::Bind("GhostNodes", BooleanValue(ghost));
+
     // Enable parallel simulator with the command line arguments
     MpiInterface::Enable(&argc, &argv);
 
@@ -119,7 +174,7 @@ main(int argc, char* argv[])
     // Some default values
     Config::SetDefault("ns3::OnOffApplication::PacketSize", UintegerValue(512));
     Config::SetDefault("ns3::OnOffApplication::DataRate", StringValue("1Mbps"));
-    Config::SetDefault("ns3::OnOffApplication::MaxBytes", UintegerValue(512));
+    Config::SetDefault("ns3::OnOffApplication::MaxBytes", UintegerValue(512 * packets));
 
     // Create leaf nodes on left with system id 0
     NodeContainer leftLeafNodes;
@@ -138,6 +193,13 @@ main(int argc, char* argv[])
     NodeContainer rightLeafNodes;
     rightLeafNodes.Create(4, 1);
 
+    // Create the node on rank 0 behind the right router
+    Ptr<Node> detourNode;
+    if (detour)
+    {
+        detourNode = CreateObject<Node>(0);
+    }
+
     PointToPointHelper routerLink;
     routerLink.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
     routerLink.SetChannelAttribute("Delay", StringValue("5ms"));
@@ -146,6 +208,22 @@ main(int argc, char* argv[])
     leafLink.SetDeviceAttribute("DataRate", StringValue("1Mbps"));
     leafLink.SetChannelAttribute("Delay", StringValue("2ms"));
 
+    // Recompute the system ids from the links; this yields the same halves
+    if (partition)
+    {
+        PartitionHelper partitionHelper;
+        partitionHelper.AddLink(routerNodes.Get(0), routerNodes.Get(1), MilliSeconds(5));
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            partitionHelper.AddLink(leftLeafNodes.Get(i), routerNodes.Get(0), MilliSeconds(2));
+            partitionHelper.AddLink(rightLeafNodes.Get(i), routerNodes.Get(1), MilliSeconds(2));
+        }
+        partitionHelper.Assign();
+        NS_ABORT_MSG_UNLESS(partitionHelper.GetCutSize() == 1 &&
+                                rightLeafNodes.Get(0)->GetSystemId() == 1,
+                            "Unexpected partition of the dumbbell");
+    }
+
     // Add link connecting routers
     NetDeviceContainer routerDevices;
     routerDevices = routerLink.Install(routerNodes);
@@ -170,6 +248,13 @@ main(int argc, char* argv[])
         rightRouterDevices.Add(temp.Get(1));
     }
 
+    // Add the link connecting the right router to the detour node
+    NetDeviceContainer detourDevices;
+    if (detour)
+    {
+        detourDevices = leafLink.Install(detourNode, routerNodes.Get(1));
+    }
+
     InternetStackHelper stack;
     if (nix)
     {
@@ -221,6 +306,15 @@ main(int argc, char* argv[])
         rightAddress.NewNetwork();
     }
 
+    // Detour interfaces
+    Ipv4InterfaceContainer detourInterfaces;
+    if (detour)
+    {
+        Ipv4AddressHelper detourAddress;
+        detourAddress.SetBase("10.4.1.0", "255.255.255.0");
+        detourInterfaces = detourAddress.Assign(detourDevices);
+    }
+
     if (!nix)
     {
         Ipv4GlobalRoutingHelper::PopulateRoutingTables();
@@ -261,6 +355,19 @@ main(int argc, char* argv[])
         sinkApp.Start(Seconds(1.0));
         sinkApp.Stop(Seconds(5));
     }
+    if (detour && systemId == 0)
+    {
+        Address sinkLocalAddress(InetSocketAddress(Ipv4Address::GetAny(), port));
+        PacketSinkHelper sinkHelper("ns3::UdpSocketFactory", sinkLocalAddress);
+        ApplicationContainer sinkApp = sinkHelper.Install(detourNode);
+        if (testing)
+        {
+            sinkApp.Get(0)->TraceConnectWithoutContext("RxWithAddresses",
+                                                       MakeCallback(&SinkTracer::SinkTrace));
+        }
+        sinkApp.Start(Seconds(1.0));
+        sinkApp.Stop(Seconds(5));
+    }
 
     // Create the OnOff applications to send
     if (systemId == 0)
@@ -273,7 +380,12 @@ main(int argc, char* argv[])
         ApplicationContainer clientApps;
         for (uint32_t i = 0; i < 4; ++i)
         {
-            AddressValue remoteAddress(InetSocketAddress(rightLeafInterfaces.GetAddress(i), port));
+            Ipv4Address remote = rightLeafInterfaces.GetAddress(i);
+            if (detour && i == 3)
+            {
+                remote = detourInterfaces.GetAddress(0);
+            }
+            AddressValue remoteAddress(InetSocketAddress(remote, port));
             clientHelper.SetAttribute("Remote", remoteAddress);
             clientApps.Add(clientHelper.Install(leftLeafNodes.Get(i)));
         }
@@ -282,12 +394,74 @@ main(int argc, char* argv[])
     }
 
     Simulator::Stop(Seconds(5));
+    FlowMonitorHelper flowmonHelper;
+    if (flowmon)
+    {
+        if (detour)
+        {
+            // Stop tracking the packets that left a rank before the end, so
+            // that they count as lost unless another rank received them
+            flowmonHelper.SetMonitorAttribute("MaxPerHopDelay", TimeValue(Seconds(1)));
+        }
+        flowmonHelper.InstallAll();
+    }
+
     Simulator::Run();
+    if (flowmon)
+    {
+        Ptr<FlowMonitor> monitor = flowmonHelper.GetMonitor();
+        monitor->GatherStats();
+        uint32_t txPackets = 0;
+        uint32_t rxPackets = 0;
+        uint32_t lostPackets = 0;
+        uint32_t timesForwarded = 0;
+        for (const auto& flow : monitor->GetFlowStats())
+        {
+            txPackets += flow.second.txPackets;
+            rxPackets += flow.second.rxPackets;
+            lostPackets += flow.second.lostPackets;
+            timesForwarded += flow.second.timesForwarded;
+        }
+        std::ostringstream oss;
+        oss << monitor->GetFlowStats().size() << " flows, " << txPackets << " packets sent, "
+            << rxPackets << " received, " << lostPackets << " lost, " << timesForwarded
+            << " forwards";
+        if (testing)
+        {
+            RANK0COUT(oss.str() << "\n");
+        }
+        else if (systemId == 0)
+        {
+            std::cout << oss.str() << std::endl;
+        }
+    }
+    if (pool)
+    {
+        // Once as many sends as can be in flight have allocated a buffer,
+        // the next ones reuse the buffers of the completed sends
+        uint64_t allocations = SyncTelemetry::GetSendBufferAllocations();
+        uint64_t reuses = SyncTelemetry::GetSendBufferReuses();
+        if (testing)
+        {
+            RANK0COUT("send buffers " << (reuses > 10 * allocations ? "reused" : "not reused")
+                                      << "\n");
+        }
+        else if (systemId == 0)
+        {
+            std::cout << "Send buffers allocated " << allocations << " times, reused " << reuses
+                      << " times" << std::endl;
+        }
+    }
+    if (verbose && systemId == 0)
+    {
+        std::cout << "Sent " << SyncTelemetry::GetPacketsSent() << " packets to rank 1, "
+                  << SyncTelemetry::GetBytesPerPacket() << " bytes per packet" << std::endl;
+    }
     Simulator::Destroy();
 
     if (testing)
     {
-        SinkTracer::Verify(4);
+        SinkTracer::Verify(4 * packets);
     }
 
     // Exit the MPI execution environment
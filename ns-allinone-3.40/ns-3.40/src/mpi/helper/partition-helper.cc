@@ -0,0 +1,538 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::PartitionHelper.
+ */
+
+#include "partition-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PartitionHelper");
+
+/** Coarsen until there are at most this many vertices per part. */
+const uint32_t COARSEST_VERTICES_PER_PART = 15;
+
+/** Stop coarsening when a level removes fewer vertices than this fraction. */
+const double MIN_COARSEN_REDUCTION = 0.05;
+
+/** Number of refinement passes at each level. */
+const uint32_t REFINE_PASSES = 8;
+
+PartitionHelper::PartitionHelper()
+    : m_imbalance(0.03),
+      m_defaultWeight(1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PartitionHelper::SetImbalance(double imbalance)
+{
+    NS_LOG_FUNCTION(this << imbalance);
+    m_imbalance = imbalance;
+}
+
+void
+PartitionHelper::SetNodeWeight(Ptr<Node> node, double weight)
+{
+    NS_LOG_FUNCTION(this << node << weight);
+    m_nodeWeight[node->GetId()] = weight;
+}
+
+void
+PartitionHelper::LoadNodeCosts(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    std::ifstream in(filename);
+    NS_ABORT_MSG_UNLESS(in.is_open(), "Can't open node cost file " << filename);
+    std::string line;
+    double total = 0;
+    uint32_t count = 0;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        uint32_t id;
+        uint64_t events;
+        uint64_t nanoseconds;
+        fields >> id >> events >> nanoseconds;
+        NS_ABORT_MSG_IF(fields.fail(), "Malformed line in node cost file: " << line);
+        m_nodeWeight[id] = nanoseconds;
+        total += nanoseconds;
+        count++;
+    }
+    if (count > 0)
+    {
+        m_defaultWeight = total / count;
+        NS_LOG_INFO("loaded " << count << " node costs, mean " << m_defaultWeight << " ns");
+    }
+}
+
+void
+PartitionHelper::AddLink(Ptr<Node> a, Ptr<Node> b, Time delay, double weight)
+{
+    NS_LOG_FUNCTION(this << a << b << delay << weight);
+    m_links.push_back({a->GetId(), b->GetId(), delay, weight});
+}
+
+void
+PartitionHelper::Assign()
+{
+    Assign(MpiInterface::GetSize());
+}
+
+void
+PartitionHelper::Assign(uint32_t systemCount)
+{
+    NS_LOG_FUNCTION(this << systemCount);
+    NS_ASSERT(systemCount > 0);
+
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<double> weight(nNodes, m_defaultWeight);
+    for (const auto& [id, nodeWeight] : m_nodeWeight)
+    {
+        if (id < nNodes)
+        {
+            weight[id] = nodeWeight;
+        }
+    }
+
+    // Links added explicitly, and those of the channels already installed;
+    // channels with more than two devices are modeled as a star.
+    m_graphLinks = m_links;
+    for (auto i = ChannelList::Begin(); i != ChannelList::End(); ++i)
+    {
+        Ptr<Channel> channel = *i;
+        if (channel->GetNDevices() < 2)
+        {
+            continue;
+        }
+        TimeValue delay(Seconds(0));
+        channel->GetAttributeFailSafe("Delay", delay);
+        uint32_t a = channel->GetDevice(0)->GetNode()->GetId();
+        for (std::size_t j = 1; j < channel->GetNDevices(); ++j)
+        {
+            uint32_t b = channel->GetDevice(j)->GetNode()->GetId();
+            m_graphLinks.push_back({a, b, delay.Get(), 1});
+        }
+    }
+
+    Graph graph = BuildGraph(weight, m_graphLinks);
+    double maxPartWeight = (1 + m_imbalance) * graph.m_totalWeight / systemCount;
+
+    std::vector<uint32_t> part(nNodes, 0);
+    if (systemCount > 1 && nNodes > 0)
+    {
+        // Coarsen, keeping the vertices small enough to still balance the parts
+        uint32_t coarsest = COARSEST_VERTICES_PER_PART * systemCount;
+        double maxVertexWeight = graph.m_totalWeight / coarsest * 1.5;
+        std::vector<Graph> levels{graph};
+        std::vector<std::vector<uint32_t>> maps;
+        while (levels.back().m_vertexWeight.size() > coarsest)
+        {
+            std::vector<uint32_t> map;
+            Graph coarse = Coarsen(levels.back(), maxVertexWeight, map);
+            std::size_t fineSize = levels.back().m_vertexWeight.size();
+            if (coarse.m_vertexWeight.size() > fineSize * (1 - MIN_COARSEN_REDUCTION))
+            {
+                break;
+            }
+            levels.push_back(std::move(coarse));
+            maps.push_back(std::move(map));
+        }
+        NS_LOG_LOGIC("coarsened " << nNodes << " nodes to "
+                                  << levels.back().m_vertexWeight.size() << " in "
+                                  << maps.size() << " levels");
+
+        part = GrowPartition(levels.back(), systemCount);
+        Refine(levels.back(), systemCount, maxPartWeight, part);
+        for (std::size_t level = maps.size(); level > 0; --level)
+        {
+            const std::vector<uint32_t>& map = maps[level - 1];
+            std::vector<uint32_t> finePart(map.size());
+            for (std::size_t v = 0; v < map.size(); ++v)
+            {
+                finePart[v] = part[map[v]];
+            }
+            part.swap(finePart);
+            Refine(levels[level - 1], systemCount, maxPartWeight, part);
+        }
+    }
+
+    m_systemId = part;
+    m_systemWeight.assign(systemCount, 0);
+    for (uint32_t id = 0; id < nNodes; ++id)
+    {
+        NodeList::GetNode(id)->SetAttribute("SystemId", UintegerValue(part[id]));
+        m_systemWeight[part[id]] += weight[id];
+    }
+
+    NS_LOG_INFO("cut size " << GetCutSize() << ", lookahead " << GetLookAhead());
+    for (uint32_t systemId = 0; systemId < systemCount; ++systemId)
+    {
+        NS_LOG_INFO("rank " << systemId << " weight " << m_systemWeight[systemId]);
+    }
+}
+
+double
+PartitionHelper::GetCutSize() const
+{
+    double cut = 0;
+    for (const auto& link : m_graphLinks)
+    {
+        if (m_systemId[link.m_a] != m_systemId[link.m_b])
+        {
+            cut += link.m_weight;
+        }
+    }
+    return cut;
+}
+
+Time
+PartitionHelper::GetLookAhead() const
+{
+    Time lookAhead = Time::Max();
+    for (const auto& link : m_graphLinks)
+    {
+        if (m_systemId[link.m_a] != m_systemId[link.m_b])
+        {
+            lookAhead = Min(lookAhead, link.m_delay);
+        }
+    }
+    return lookAhead;
+}
+
+double
+PartitionHelper::GetSystemWeight(uint32_t systemId) const
+{
+    NS_ASSERT(systemId < m_systemWeight.size());
+    return m_systemWeight[systemId];
+}
+
+PartitionHelper::Graph
+PartitionHelper::BuildGraph(const std::vector<double>& vertexWeight, const std::vector<Link>& links)
+{
+    uint32_t n = vertexWeight.size();
+
+    // Both directions of every edge, sorted so parallel edges are adjacent
+    std::vector<std::pair<std::pair<uint32_t, uint32_t>, double>> edges;
+    edges.reserve(2 * links.size());
+    for (const auto& link : links)
+    {
+        if (link.m_a != link.m_b)
+        {
+            edges.push_back({{link.m_a, link.m_b}, link.m_weight});
+            edges.push_back({{link.m_b, link.m_a}, link.m_weight});
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    Graph graph;
+    graph.m_vertexWeight = vertexWeight;
+    graph.m_totalWeight = 0;
+    for (double w : vertexWeight)
+    {
+        graph.m_totalWeight += w;
+    }
+    graph.m_start.assign(n + 1, 0);
+    for (std::size_t i = 0; i < edges.size(); ++i)
+    {
+        if (i > 0 && edges[i].first == edges[i - 1].first)
+        {
+            graph.m_edgeWeight.back() += edges[i].second;
+            continue;
+        }
+        graph.m_start[edges[i].first.first + 1]++;
+        graph.m_adjacent.push_back(edges[i].first.second);
+        graph.m_edgeWeight.push_back(edges[i].second);
+    }
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        graph.m_start[v + 1] += graph.m_start[v];
+    }
+    return graph;
+}
+
+PartitionHelper::Graph
+PartitionHelper::Coarsen(const Graph& fine, double maxVertexWeight, std::vector<uint32_t>& map)
+{
+    uint32_t n = fine.m_vertexWeight.size();
+    const uint32_t unmatched = n;
+
+    // Visit the vertices with the fewest edges first, so they still find a mate
+    std::vector<uint32_t> order(n);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(), [&fine](uint32_t a, uint32_t b) {
+        return fine.m_start[a + 1] - fine.m_start[a] < fine.m_start[b + 1] - fine.m_start[b];
+    });
+
+    std::vector<uint32_t> match(n, unmatched);
+    for (uint32_t v : order)
+    {
+        if (match[v] != unmatched)
+        {
+            continue;
+        }
+        uint32_t mate = v;
+        double heaviest = 0;
+        for (uint32_t e = fine.m_start[v]; e < fine.m_start[v + 1]; ++e)
+        {
+            uint32_t u = fine.m_adjacent[e];
+            if (match[u] == unmatched && fine.m_edgeWeight[e] > heaviest &&
+                fine.m_vertexWeight[v] + fine.m_vertexWeight[u] <= maxVertexWeight)
+            {
+                mate = u;
+                heaviest = fine.m_edgeWeight[e];
+            }
+        }
+        match[v] = mate;
+        match[mate] = v;
+    }
+
+    map.assign(n, unmatched);
+    std::vector<std::pair<uint32_t, uint32_t>> members;
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        if (map[v] == unmatched)
+        {
+            map[v] = members.size();
+            map[match[v]] = members.size();
+            members.emplace_back(v, match[v]);
+        }
+    }
+
+    uint32_t nc = members.size();
+    Graph coarse;
+    coarse.m_totalWeight = fine.m_totalWeight;
+    coarse.m_vertexWeight.resize(nc);
+    coarse.m_start.assign(nc + 1, 0);
+    // Position of each coarse neighbor in the edges of the current vertex
+    std::vector<uint32_t> position(nc, UINT32_MAX);
+    for (uint32_t c = 0; c < nc; ++c)
+    {
+        uint32_t begin = coarse.m_adjacent.size();
+        uint32_t v = members[c].first;
+        uint32_t u = members[c].second;
+        coarse.m_vertexWeight[c] = fine.m_vertexWeight[v];
+        if (u != v)
+        {
+            coarse.m_vertexWeight[c] += fine.m_vertexWeight[u];
+        }
+        for (uint32_t w : {v, u})
+        {
+            for (uint32_t e = fine.m_start[w]; e < fine.m_start[w + 1]; ++e)
+            {
+                uint32_t neighbor = map[fine.m_adjacent[e]];
+                if (neighbor == c)
+                {
+                    continue;
+                }
+                if (position[neighbor] == UINT32_MAX)
+                {
+                    position[neighbor] = coarse.m_adjacent.size();
+                    coarse.m_adjacent.push_back(neighbor);
+                    coarse.m_edgeWeight.push_back(0);
+                }
+                coarse.m_edgeWeight[position[neighbor]] += fine.m_edgeWeight[e];
+            }
+            if (u == v)
+            {
+                break;
+            }
+        }
+        for (uint32_t e = begin; e < coarse.m_adjacent.size(); ++e)
+        {
+            position[coarse.m_adjacent[e]] = UINT32_MAX;
+        }
+        coarse.m_start[c + 1] = coarse.m_adjacent.size();
+    }
+    return coarse;
+}
+
+std::vector<uint32_t>
+PartitionHelper::GrowPartition(const Graph& graph, uint32_t parts)
+{
+    uint32_t n = graph.m_vertexWeight.size();
+    const uint32_t unassigned = parts;
+    std::vector<uint32_t> part(n, unassigned);
+
+    double remaining = graph.m_totalWeight;
+    uint32_t nextSeed = 0;
+    for (uint32_t p = 0; p + 1 < parts; ++p)
+    {
+        double target = remaining / (parts - p);
+        double weight = 0;
+
+        // Grow the part from a seed, always adding the vertex most
+        // connected to it; ordered by (-connection, vertex).
+        std::vector<double> connection(n, 0);
+        std::set<std::pair<double, uint32_t>> frontier;
+        while (weight < target)
+        {
+            if (frontier.empty())
+            {
+                while (nextSeed < n && part[nextSeed] != unassigned)
+                {
+                    ++nextSeed;
+                }
+                if (nextSeed == n)
+                {
+                    break;
+                }
+                frontier.emplace(0, nextSeed);
+            }
+            uint32_t v = frontier.begin()->second;
+            frontier.erase(frontier.begin());
+            part[v] = p;
+            weight += graph.m_vertexWeight[v];
+
+            for (uint32_t e = graph.m_start[v]; e < graph.m_start[v + 1]; ++e)
+            {
+                uint32_t u = graph.m_adjacent[e];
+                if (part[u] != unassigned)
+                {
+                    continue;
+                }
+                frontier.erase({-connection[u], u});
+                connection[u] += graph.m_edgeWeight[e];
+                frontier.emplace(-connection[u], u);
+            }
+        }
+        remaining -= weight;
+    }
+
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        if (part[v] == unassigned)
+        {
+            part[v] = parts - 1;
+        }
+    }
+    return part;
+}
+
+void
+PartitionHelper::Refine(const Graph& graph,
+                        uint32_t parts,
+                        double maxPartWeight,
+                        std::vector<uint32_t>& part)
+{
+    uint32_t n = graph.m_vertexWeight.size();
+    std::vector<double> partWeight(parts, 0);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        partWeight[part[v]] += graph.m_vertexWeight[v];
+    }
+
+    std::vector<double> connection(parts, 0);
+    std::vector<uint32_t> touched;
+    for (uint32_t pass = 0; pass < REFINE_PASSES; ++pass)
+    {
+        bool moved = false;
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            uint32_t from = part[v];
+            double w = graph.m_vertexWeight[v];
+            bool overloaded = partWeight[from] > maxPartWeight;
+
+            for (uint32_t e = graph.m_start[v]; e < graph.m_start[v + 1]; ++e)
+            {
+                uint32_t p = part[graph.m_adjacent[e]];
+                if (connection[p] == 0)
+                {
+                    touched.push_back(p);
+                }
+                connection[p] += graph.m_edgeWeight[e];
+            }
+            if (overloaded)
+            {
+                // Also consider the lightest part, which may not be adjacent
+                uint32_t lightest = std::min_element(partWeight.begin(), partWeight.end()) -
+                                    partWeight.begin();
+                touched.push_back(lightest);
+            }
+
+            // Best move by gain in cut, then by the lighter destination
+            uint32_t to = from;
+            double bestGain = 0;
+            for (uint32_t p : touched)
+            {
+                if (p == from || partWeight[p] + w > maxPartWeight)
+                {
+                    continue;
+                }
+                double gain = connection[p] - connection[from];
+                bool balances = partWeight[p] + w < partWeight[from];
+                if (!(gain > 0 || overloaded || (gain == 0 && balances)))
+                {
+                    continue;
+                }
+                if (to == from || gain > bestGain ||
+                    (gain == bestGain && partWeight[p] < partWeight[to]))
+                {
+                    to = p;
+                    bestGain = gain;
+                }
+            }
+
+            for (uint32_t p : touched)
+            {
+                connection[p] = 0;
+            }
+            touched.clear();
+
+            if (to != from)
+            {
+                part[v] = to;
+                partWeight[from] -= w;
+                partWeight[to] += w;
+                moved = true;
+            }
+        }
+        if (!moved)
+        {
+            break;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,207 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::PartitionHelper.
+ */
+
+#ifndef NS3_PARTITION_HELPER_H
+#define NS3_PARTITION_HELPER_H
+
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Assign the nodes to MPI ranks from the topology.
+ *
+ * The graph of nodes and links is split into one part per rank so that
+ * the parts have about the same total node weight and as few links as
+ * possible cross between them.  This uses multilevel graph partitioning:
+ * the graph is coarsened by collapsing heavy edges, the coarsest graph is
+ * partitioned by greedy graph growing, and the partition is projected
+ * back and refined at each level.
+ *
+ * The graph holds every node in the NodeList, the channels in the
+ * ChannelList and the links added with AddLink().  Since the
+ * PointToPointHelper picks a remote channel from the system ids of the
+ * nodes, links which may cross ranks have to be added with AddLink(),
+ * and Assign() called, before the devices are installed:
+ *
+ * \code
+ *   NodeContainer nodes;
+ *   nodes.Create(4);
+ *   PartitionHelper partition;
+ *   partition.AddLink(nodes.Get(0), nodes.Get(1), MilliSeconds(1));
+ *   ...
+ *   partition.Assign();
+ *   pointToPoint.Install(nodes.Get(0), nodes.Get(1));
+ * \endcode
+ *
+ * The partition is deterministic, so every rank computes the same
+ * assignment as long as they build the same graph.
+ */
+class PartitionHelper
+{
+  public:
+    PartitionHelper();
+
+    /**
+     * Set the allowed load imbalance.
+     *
+     * \param [in] imbalance The fraction by which the weight of a part may
+     *             exceed the average weight; defaults to 0.03.
+     */
+    void SetImbalance(double imbalance);
+    /**
+     * Set the compute cost of a node.
+     *
+     * \param [in] node The node.
+     * \param [in] weight The node weight; defaults to 1.
+     */
+    void SetNodeWeight(Ptr<Node> node, double weight);
+    /**
+     * Set the node weights from the costs recorded in a previous run.
+     *
+     * The file is written by the NodeCostFile attribute of the
+     * distributed simulators.  Each node is weighted by the wall time of
+     * its events, in nanoseconds.  The nodes missing from the file, and
+     * those not given a weight, are weighted by the mean cost of the nodes
+     * of the file, so that all the weights are in the same unit.
+     *
+     * \param [in] filename The node cost file.
+     */
+    void LoadNodeCosts(const std::string& filename);
+    /**
+     * Add a link which will be installed between two nodes.
+     *
+     * \param [in] a The first node.
+     * \param [in] b The second node.
+     * \param [in] delay The link delay.
+     * \param [in] weight The cost of the link crossing between ranks.
+     */
+    void AddLink(Ptr<Node> a, Ptr<Node> b, Time delay, double weight = 1);
+
+    /**
+     * Partition the graph over the MPI ranks and set the SystemId
+     * attribute of every node.
+     */
+    void Assign();
+    /**
+     * Partition the graph and set the SystemId attribute of every node.
+     *
+     * \param [in] systemCount The number of parts.
+     */
+    void Assign(uint32_t systemCount);
+
+    /**
+     * \return The total weight of the links crossing between ranks.
+     */
+    double GetCutSize() const;
+    /**
+     * \return The smallest delay of the links crossing between ranks,
+     *         which bounds the lookahead, or Time::Max() if none cross.
+     */
+    Time GetLookAhead() const;
+    /**
+     * \param [in] systemId The rank.
+     * \return The total weight of the nodes assigned to the rank.
+     */
+    double GetSystemWeight(uint32_t systemId) const;
+
+  private:
+    /** A link between two nodes. */
+    struct Link
+    {
+        uint32_t m_a;    //!< Id of the first node.
+        uint32_t m_b;    //!< Id of the second node.
+        Time m_delay;    //!< Link delay.
+        double m_weight; //!< Cost of cutting the link.
+    };
+
+    /** Undirected graph in compressed adjacency form. */
+    struct Graph
+    {
+        /** Vertex v has the edges in [m_start[v], m_start[v + 1]). */
+        std::vector<uint32_t> m_start;
+        std::vector<uint32_t> m_adjacent;   //!< Far end of each edge.
+        std::vector<double> m_edgeWeight;   //!< Weight of each edge.
+        std::vector<double> m_vertexWeight; //!< Weight of each vertex.
+        double m_totalWeight;               //!< Sum of the vertex weights.
+    };
+
+    /**
+     * Build a graph, merging parallel edges.
+     *
+     * \param [in] vertexWeight The vertex weights.
+     * \param [in] links The edges.
+     * \return The graph.
+     */
+    static Graph BuildGraph(const std::vector<double>& vertexWeight,
+                            const std::vector<Link>& links);
+    /**
+     * Collapse a maximal heavy edge matching.
+     *
+     * \param [in] fine The graph to coarsen.
+     * \param [in] maxVertexWeight The largest allowed coarse vertex weight.
+     * \param [out] map The coarse vertex of each fine vertex.
+     * \return The coarse graph.
+     */
+    static Graph Coarsen(const Graph& fine, double maxVertexWeight, std::vector<uint32_t>& map);
+    /**
+     * Partition a graph by greedy graph growing.
+     *
+     * \param [in] graph The graph.
+     * \param [in] parts The number of parts.
+     * \return The part of each vertex.
+     */
+    static std::vector<uint32_t> GrowPartition(const Graph& graph, uint32_t parts);
+    /**
+     * Move boundary vertices to reduce the cut and restore the balance.
+     *
+     * \param [in] graph The graph.
+     * \param [in] parts The number of parts.
+     * \param [in] maxPartWeight The largest allowed part weight.
+     * \param [in,out] part The part of each vertex.
+     */
+    static void Refine(const Graph& graph,
+                       uint32_t parts,
+                       double maxPartWeight,
+                       std::vector<uint32_t>& part);
+
+    double m_imbalance;                      //!< Allowed load imbalance.
+    std::map<uint32_t, double> m_nodeWeight; //!< Weight of the nodes given one, by id.
+    double m_defaultWeight;                  //!< Weight of the other nodes.
+    std::vector<Link> m_links;               //!< Links added with AddLink().
+    std::vector<Link> m_graphLinks;          //!< All the links of the last partition.
+    std::vector<uint32_t> m_systemId;        //!< Assigned rank of each node, by id.
+    std::vector<double> m_systemWeight;      //!< Total node weight of each rank.
+};
+
+} // namespace ns3
+
+#endif /* NS3_PARTITION_HELPER_H */
@@ -26,8 +26,13 @@
 
 #include "granted-time-window-mpi-interface.h"
 #include "mpi-interface.h"
+#include "remote-channel-bundle-manager.h"
+#include "remote-channel-bundle.h"
+#include "sync-telemetry.h"
 
+#include "ns3/abort.h"
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/channel.h"
 #include "ns3/event-impl.h"
 #include "ns3/log.h"
@@ -36,9 +41,15 @@
 #include "ns3/ptr.h"
 #include "ns3/scheduler.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
 
+#include <chrono>
 #include <cmath>
+#include <functional>
+#include <limits>
 #include <mpi.h>
+#include <queue>
 
 namespace ns3
 {
@@ -81,6 +92,32 @@ LbtsMessage::IsFinished() const
     return m_isFinished;
 }
 
+/**
+ * MPI reduction operator for the non-blocking LBTS computation.
+ *
+ * Combines LbtsMessages into the smallest next event time, the total
+ * message counts and whether every rank is finished.
+ *
+ * \param [in] in The input messages.
+ * \param [in,out] inout The accumulated messages.
+ * \param [in] len The number of messages.
+ * \param [in] datatype The MPI datatype of an LbtsMessage.
+ */
+static void
+LbtsReduce(void* in, void* inout, int* len, MPI_Datatype* datatype)
+{
+    auto a = static_cast<LbtsMessage*>(in);
+    auto b = static_cast<LbtsMessage*>(inout);
+    for (int i = 0; i < *len; ++i)
+    {
+        b[i] = LbtsMessage(a[i].GetRxCount() + b[i].GetRxCount(),
+                           a[i].GetTxCount() + b[i].GetTxCount(),
+                           b[i].GetMyId(),
+                           a[i].IsFinished() && b[i].IsFinished(),
+                           Min(a[i].GetSmallestTime(), b[i].GetSmallestTime()));
+    }
+}
+
 /**
  * Initialize m_lookAhead to maximum, it will be constrained by
  * user supplied time via BoundLookAhead and the
@@ -94,7 +131,61 @@ DistributedSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DistributedSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Mpi")
-                            .AddConstructor<DistributedSimulatorImpl>();
+                            .AddConstructor<DistributedSimulatorImpl>()
+                            .AddAttribute("AggregatePackets",
+                                          "Coalesce all packets sent to the same remote rank "
+                                          "during a granted time window into one MPI message",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &DistributedSimulatorImpl::m_aggregatePackets),
+                                          MakeBooleanChecker())
+                            .AddAttribute("SharedMemoryRingSize",
+                                          "Size in bytes of the shared memory ring carrying "
+                                          "packets to each rank on the same host instead of "
+                                          "MPI messages; 0 to always use MPI",
+                                          UintegerValue(1 << 20),
+                                          MakeUintegerAccessor(
+                                              &DistributedSimulatorImpl::m_sharedMemoryRingSize),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("NeighborLookahead",
+                                          "Grant each rank a time window from the next event "
+                                          "times of the ranks which can reach it and the "
+                                          "delays along the way, instead of a global lookahead",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &DistributedSimulatorImpl::m_neighborLookahead),
+                                          MakeBooleanChecker())
+                            .AddAttribute("NonBlockingLbts",
+                                          "Compute the LBTS with a non-blocking MPI_Iallreduce "
+                                          "which overlaps the execution of granted events",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &DistributedSimulatorImpl::m_nonBlockingLbts),
+                                          MakeBooleanChecker())
+                            .AddAttribute("LbtsStartThreshold",
+                                          "Start the non-blocking LBTS reduction when fewer "
+                                          "events than this are estimated to remain in the "
+                                          "granted time window",
+                                          UintegerValue(64),
+                                          MakeUintegerAccessor(
+                                              &DistributedSimulatorImpl::m_lbtsStartThreshold),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("NodeCostFile",
+                                          "Record the number of events and the wall time of "
+                                          "each node, and write them to this file at Destroy; "
+                                          "empty to disable",
+                                          StringValue(""),
+                                          MakeStringAccessor(
+                                              &DistributedSimulatorImpl::m_nodeCostFile),
+                                          MakeStringChecker())
+                            .AddAttribute("TelemetryFile",
+                                          "Write the synchronization counters of each rank to "
+                                          "<TelemetryFile>-<rank>.csv at Destroy; empty to "
+                                          "disable",
+                                          StringValue(""),
+                                          MakeStringAccessor(
+                                              &DistributedSimulatorImpl::m_telemetryFile),
+                                          MakeStringChecker());
     return tid;
 }
 
@@ -118,6 +209,19 @@ DistributedSimulatorImpl::DistributedSimulatorImpl()
     m_unscheduledEvents = 0;
     m_eventCount = 0;
     m_events = nullptr;
+    m_aggregatePackets = false;
+    m_sharedMemoryRingSize = 0;
+    m_neighborLookahead = false;
+    m_nonBlockingLbts = false;
+    m_lbtsStartThreshold = 0;
+    m_lbtsPending = false;
+    m_lbtsRequest = MPI_REQUEST_NULL;
+    m_lbtsOp = MPI_OP_NULL;
+    m_lbtsType = MPI_DATATYPE_NULL;
+    m_windowEvents = 0;
+    m_lastWindowEvents = 0;
+
+    SyncTelemetry::Reset(m_systemCount);
 }
 
 DistributedSimulatorImpl::~DistributedSimulatorImpl()
@@ -156,6 +260,15 @@ DistributedSimulatorImpl::Destroy()
         }
     }
 
+    if (!m_nodeCostFile.empty())
+    {
+        m_nodeCosts.Write(m_nodeCostFile);
+    }
+    if (!m_telemetryFile.empty())
+    {
+        SyncTelemetry::Write(m_telemetryFile, m_myId);
+    }
+
     MpiInterface::Destroy();
 }
 
@@ -171,6 +284,11 @@ DistributedSimulatorImpl::CalculateLookAhead()
     }
     else
     {
+        if (m_neighborLookahead)
+        {
+            CalculateNeighborLookAhead(m_lookAhead);
+        }
+
         NodeContainer c = NodeContainer::GetGlobal();
         for (auto iter = c.Begin(); iter != c.End(); ++iter)
         {
@@ -270,6 +388,116 @@ DistributedSimulatorImpl::CalculateLookAhead()
     }
 }
 
+void
+DistributedSimulatorImpl::CalculateNeighborLookAhead(const Time bound)
+{
+    NS_LOG_FUNCTION(this << bound);
+
+    RemoteChannelBundleManager::AddRemoteChannels();
+
+    // (rank, delay) pairs for the neighbors of this rank
+    std::vector<int64_t> neighbors;
+    Time minDelay = GetMaximumSimulationTime();
+    for (uint32_t rank = 0; rank < m_systemCount; ++rank)
+    {
+        Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
+        if (bundle)
+        {
+            Time delay = Min(bundle->GetDelay(), bound);
+            neighbors.push_back(rank);
+            neighbors.push_back(delay.GetInteger());
+            minDelay = Min(minDelay, delay);
+        }
+    }
+    RemoteChannelBundleManager::Destroy();
+
+    MPI_Comm comm = MpiInterface::GetCommunicator();
+    int count = neighbors.size();
+    std::vector<int> counts(m_systemCount);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    std::vector<int> displs(m_systemCount, 0);
+    for (uint32_t rank = 1; rank < m_systemCount; ++rank)
+    {
+        displs[rank] = displs[rank - 1] + counts[rank - 1];
+    }
+    std::vector<int64_t> graph(displs.back() + counts.back());
+    MPI_Allgatherv(neighbors.data(),
+                   count,
+                   MPI_INT64_T,
+                   graph.data(),
+                   counts.data(),
+                   displs.data(),
+                   MPI_INT64_T,
+                   comm);
+
+    m_neighborDelay.clear();
+    if (minDelay == GetMaximumSimulationTime())
+    {
+        // No inter-task links, fall back to the global lookahead
+        return;
+    }
+
+    // Channels are symmetric, so the shortest delays from this rank are
+    // also the shortest delays to it.
+    const int64_t unreachable = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> distance(m_systemCount, unreachable);
+    typedef std::pair<int64_t, uint32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distance[m_myId] = 0;
+    queue.emplace(0, m_myId);
+    while (!queue.empty())
+    {
+        Entry top = queue.top();
+        queue.pop();
+        if (top.first > distance[top.second])
+        {
+            continue;
+        }
+        int end = displs[top.second] + counts[top.second];
+        for (int i = displs[top.second]; i < end; i += 2)
+        {
+            uint32_t rank = graph[i];
+            int64_t d = top.first + graph[i + 1];
+            if (d < distance[rank])
+            {
+                distance[rank] = d;
+                queue.emplace(d, rank);
+            }
+        }
+    }
+
+    m_neighborDelay.resize(m_systemCount, GetMaximumSimulationTime());
+    for (uint32_t rank = 0; rank < m_systemCount; ++rank)
+    {
+        if (distance[rank] != unreachable)
+        {
+            m_neighborDelay[rank] = Time(distance[rank]);
+        }
+    }
+    // Events on this rank come back to it no sooner than a round trip
+    // over its shortest link.
+    m_neighborDelay[m_myId] = minDelay + minDelay;
+}
+
+Time
+DistributedSimulatorImpl::CalculateNeighborGrantedTime() const
+{
+    Time grantedTime = GetMaximumSimulationTime();
+    for (uint32_t rank = 0; rank < m_systemCount; ++rank)
+    {
+        Time smallestTime = m_pLBTS[rank].GetSmallestTime();
+        // Ranks without events or without a path to this one can't
+        // send anything here.
+        if (smallestTime == GetMaximumSimulationTime() ||
+            m_neighborDelay[rank] == GetMaximumSimulationTime())
+        {
+            continue;
+        }
+        grantedTime = Min(grantedTime, smallestTime + m_neighborDelay[rank]);
+    }
+    return grantedTime;
+}
+
 void
 DistributedSimulatorImpl::BoundLookAhead(const Time lookAhead)
 {
@@ -297,6 +525,10 @@ DistributedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
         {
             Scheduler::Event next = m_events->RemoveNext();
             scheduler->Insert(next);
+            if (next.impl->IsCancelled())
+            {
+                scheduler->NotifyCancel();
+            }
         }
     }
     m_events = scheduler;
@@ -319,7 +551,22 @@ DistributedSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (next.impl->IsCancelled())
+    {
+        m_events->NotifyCancelledRemoved();
+    }
+    if (m_nodeCostFile.empty())
+    {
+        next.impl->Invoke();
+    }
+    else
+    {
+        auto start = std::chrono::steady_clock::now();
+        next.impl->Invoke();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        m_nodeCosts.Record(next.key.m_context,
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
     next.impl->Unref();
 }
 
@@ -361,26 +608,56 @@ void
 DistributedSimulatorImpl::Run()
 {
     NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_nonBlockingLbts && m_neighborLookahead,
+                    "NeighborLookahead requires the blocking LBTS computation");
 
+    SyncTelemetry::Clock::time_point runStart = SyncTelemetry::Clock::now();
     CalculateLookAhead();
+    GrantedTimeWindowMpiInterface::SetPacketAggregation(m_aggregatePackets);
+    GrantedTimeWindowMpiInterface::EnableSharedMemory(m_sharedMemoryRingSize);
     m_stop = false;
     m_globalFinished = false;
+    if (m_nonBlockingLbts)
+    {
+        MPI_Type_contiguous(sizeof(LbtsMessage), MPI_BYTE, &m_lbtsType);
+        MPI_Type_commit(&m_lbtsType);
+        MPI_Op_create(&LbtsReduce, 1, &m_lbtsOp);
+        m_windowEvents = 0;
+        m_lastWindowEvents = 0;
+    }
     while (!m_globalFinished)
     {
         Time nextTime = Next();
 
+        if (m_nonBlockingLbts)
+        {
+            if (!m_lbtsPending && IsLbtsDue(nextTime))
+            {
+                StartLbts();
+                // Receiving messages may have added earlier events
+                nextTime = Next();
+            }
+            if (m_lbtsPending)
+            {
+                // Only block when there is no granted event left to execute
+                FinishLbts(nextTime > m_grantedTime || IsLocalFinished());
+            }
+        }
         // If local event is beyond grantedTime then need to synchronize
         // with other tasks to determine new time window. If local task
         // is finished then continue to participate in allgather
         // synchronizations with other tasks until all tasks have
         // completed.
-        if (nextTime > m_grantedTime || IsLocalFinished())
+        else if (nextTime > m_grantedTime || IsLocalFinished())
         {
             // Can't process next event, calculate a new LBTS
             // First receive any pending messages
             GrantedTimeWindowMpiInterface::ReceiveMessages();
             // reset next time
             nextTime = Next();
+            // Send the packets aggregated during this window so they
+            // are counted as transmitted
+            GrantedTimeWindowMpiInterface::FlushAggregatedPackets();
             // And check for send completes
             GrantedTimeWindowMpiInterface::TestSendComplete();
             // Finally calculate the lbts
@@ -390,6 +667,7 @@ DistributedSimulatorImpl::Run()
                              IsLocalFinished(),
                              nextTime);
             m_pLBTS[m_myId] = lMsg;
+            SyncTelemetry::Clock::time_point blockStart = SyncTelemetry::Clock::now();
             MPI_Allgather(&lMsg,
                           sizeof(LbtsMessage),
                           MPI_BYTE,
@@ -397,6 +675,7 @@ DistributedSimulatorImpl::Run()
                           sizeof(LbtsMessage),
                           MPI_BYTE,
                           MpiInterface::GetCommunicator());
+            SyncTelemetry::RecordBlocked(blockStart);
             Time smallestTime = m_pLBTS[0].GetSmallestTime();
             // The totRx and totTx counts insure there are no transient
             // messages;  If totRx != totTx, there are transients,
@@ -420,6 +699,7 @@ DistributedSimulatorImpl::Run()
             // no messages are in-flight.
             m_globalFinished &= totRx == totTx;
 
+            Time previousGrantedTime = m_grantedTime;
             if (totRx == totTx)
             {
                 // If lookahead is infinite then granted time should be as well.
@@ -429,12 +709,18 @@ DistributedSimulatorImpl::Run()
                 {
                     m_grantedTime = GetMaximumSimulationTime();
                 }
+                else if (!m_neighborDelay.empty())
+                {
+                    m_grantedTime = CalculateNeighborGrantedTime();
+                }
                 else
                 {
                     // Overflow is possible here if near end of representable time.
                     m_grantedTime = smallestTime + m_lookAhead;
                 }
             }
+            SyncTelemetry::RecordRound(m_grantedTime - previousGrantedTime, m_windowEvents);
+            m_windowEvents = 0;
         }
 
         // Execute next event if it is within the current time window.
@@ -442,14 +728,110 @@ DistributedSimulatorImpl::Run()
         if ((nextTime <= m_grantedTime) && (!IsLocalFinished()))
         { // Safe to process
             ProcessOneEvent();
+            m_windowEvents++;
         }
     }
 
+    if (m_nonBlockingLbts)
+    {
+        MPI_Op_free(&m_lbtsOp);
+        MPI_Type_free(&m_lbtsType);
+    }
+
+    SyncTelemetry::RecordRun(runStart);
+
     // If the simulator stopped naturally by lack of events, make a
     // consistency test to check that we didn't lose any events along the way.
     NS_ASSERT(!m_events->IsEmpty() || m_unscheduledEvents == 0);
 }
 
+bool
+DistributedSimulatorImpl::IsLbtsDue(const Time& nextTime) const
+{
+    return nextTime > m_grantedTime || IsLocalFinished() ||
+           m_windowEvents + m_lbtsStartThreshold >= m_lastWindowEvents;
+}
+
+void
+DistributedSimulatorImpl::StartLbts()
+{
+    NS_LOG_FUNCTION(this);
+
+    GrantedTimeWindowMpiInterface::ReceiveMessages();
+    GrantedTimeWindowMpiInterface::FlushAggregatedPackets();
+    GrantedTimeWindowMpiInterface::TestSendComplete();
+
+    // Events executed after this point are no earlier than the next
+    // event now, and packets they send arrive no earlier than that time
+    // plus the lookahead, so it is a valid lower bound for this rank.
+    m_lbtsLocal = LbtsMessage(GrantedTimeWindowMpiInterface::GetRxCount(),
+                              GrantedTimeWindowMpiInterface::GetTxCount(),
+                              m_myId,
+                              IsLocalFinished(),
+                              Next());
+    // Packets sent from now on are not part of this round's counts
+    GrantedTimeWindowMpiInterface::AdvanceEpoch();
+
+    MPI_Iallreduce(&m_lbtsLocal,
+                   &m_lbtsGlobal,
+                   1,
+                   m_lbtsType,
+                   m_lbtsOp,
+                   MpiInterface::GetCommunicator(),
+                   &m_lbtsRequest);
+    m_lbtsPending = true;
+}
+
+bool
+DistributedSimulatorImpl::FinishLbts(bool wait)
+{
+    int flag = 0;
+    if (wait)
+    {
+        SyncTelemetry::Clock::time_point blockStart = SyncTelemetry::Clock::now();
+        MPI_Wait(&m_lbtsRequest, MPI_STATUS_IGNORE);
+        SyncTelemetry::RecordBlocked(blockStart);
+        flag = 1;
+    }
+    else
+    {
+        MPI_Test(&m_lbtsRequest, &flag, MPI_STATUS_IGNORE);
+    }
+    if (!flag)
+    {
+        return false;
+    }
+    NS_LOG_FUNCTION(this << wait);
+    m_lbtsPending = false;
+
+    // As with the allgather, matching counts insure there are no
+    // transient messages from the rounds before this one.
+    bool noTransients = m_lbtsGlobal.GetRxCount() == m_lbtsGlobal.GetTxCount();
+    m_globalFinished = m_lbtsGlobal.IsFinished() && noTransients;
+
+    Time previousGrantedTime = m_grantedTime;
+    if (noTransients)
+    {
+        if (m_lookAhead == GetMaximumSimulationTime())
+        {
+            m_grantedTime = GetMaximumSimulationTime();
+        }
+        else
+        {
+            m_grantedTime = Max(m_grantedTime, m_lbtsGlobal.GetSmallestTime() + m_lookAhead);
+        }
+        SyncTelemetry::RecordRound(m_grantedTime - previousGrantedTime, m_windowEvents);
+        m_lastWindowEvents = m_windowEvents;
+        m_windowEvents = 0;
+    }
+    else
+    {
+        // The events of this window are counted when it is granted
+        SyncTelemetry::RecordRound(Time(0), 0);
+    }
+    return true;
+}
+
 uint32_t
 DistributedSimulatorImpl::GetSystemId() const
 {
@@ -586,6 +968,10 @@ DistributedSimulatorImpl::Cancel(const EventId& id)
     if (!IsExpired(id))
     {
         id.PeekEventImpl()->Cancel();
+        if (id.GetUid() != EventId::UID::DESTROY)
+        {
+            m_unscheduledEvents -= NotifyCancel(m_events, m_unscheduledEvents);
+        }
     }
 }
 
@@ -25,12 +25,16 @@
 #ifndef NS3_DISTRIBUTED_SIMULATOR_IMPL_H
 #define NS3_DISTRIBUTED_SIMULATOR_IMPL_H
 
+#include "node-cost-profiler.h"
+
 #include "ns3/event-impl.h"
 #include "ns3/ptr.h"
 #include "ns3/scheduler.h"
 #include "ns3/simulator-impl.h"
 
 #include <list>
+#include <mpi.h>
+#include <vector>
 
 namespace ns3
 {
@@ -167,6 +171,51 @@ class DistributedSimulatorImpl : public SimulatorImpl
      * using the ConstrainLookAhead() method.
      */
     void CalculateLookAhead();
+    /**
+     * Calculate the lookahead from every rank to this one.
+     *
+     * Uses the RemoteChannelBundleManager to find the delay to each
+     * neighbor rank, exchanges the neighbor delays between all ranks and
+     * computes the shortest delay along the rank graph from each rank to
+     * this one.
+     *
+     * \param [in] bound Upper bound on the delay of any link, as set by
+     *            BoundLookAhead().
+     */
+    void CalculateNeighborLookAhead(const Time bound);
+    /**
+     * Calculate the granted time from the per rank lookahead.
+     *
+     * \returns The minimum over all ranks of their next event time plus
+     *          their lookahead to this rank.
+     */
+    Time CalculateNeighborGrantedTime() const;
+    /**
+     * Start a non-blocking LBTS reduction.
+     *
+     * Receives pending messages and contributes this rank's next event
+     * time, message counts and finished state to an MPI_Iallreduce, so
+     * events already granted can be executed while it completes.
+     */
+    void StartLbts();
+    /**
+     * Complete the pending non-blocking LBTS reduction.
+     *
+     * \param [in] wait Block until the reduction completes.
+     * \returns \c true if the reduction completed and the granted time
+     *          window was updated.
+     */
+    bool FinishLbts(bool wait);
+    /**
+     * Should a non-blocking LBTS reduction be started now.
+     *
+     * \param [in] nextTime The time of the next local event.
+     * \returns \c true when the events remaining in the current window,
+     *          estimated from the previous window, fall below the
+     *          LbtsStartThreshold attribute.
+     */
+    bool IsLbtsDue(const Time& nextTime) const;
+
     /**
      * Check if this rank is finished.  It's finished when there are
      * no more events or stop has been requested.
@@ -229,6 +278,47 @@ class DistributedSimulatorImpl : public SimulatorImpl
     uint32_t m_systemCount;  /**< MPI communicator size. */
     Time m_grantedTime;      /**< End of current window. */
     static Time m_lookAhead; /**< Current window size. */
+
+    /** Coalesce packets to the same rank into one message per window. */
+    bool m_aggregatePackets;
+    /** Size of the shared memory ring to each rank of this host; 0 to disable. */
+    uint32_t m_sharedMemoryRingSize;
+
+    /** Grant time windows from the per rank lookahead rather than the global one. */
+    bool m_neighborLookahead;
+    /**
+     * Shortest delay from each rank to this one, indexed by rank.
+     * Empty when this rank has no inter-task links.
+     */
+    std::vector<Time> m_neighborDelay;
+
+    /** Compute the LBTS with a non-blocking reduction overlapping events. */
+    bool m_nonBlockingLbts;
+    /** Remaining events in the window below which the reduction is started. */
+    uint32_t m_lbtsStartThreshold;
+    /** Is a non-blocking LBTS reduction in flight. */
+    bool m_lbtsPending;
+    /** Request of the pending non-blocking LBTS reduction. */
+    MPI_Request m_lbtsRequest;
+    /** Contribution of this rank to the pending LBTS reduction. */
+    LbtsMessage m_lbtsLocal;
+    /** Result of the pending LBTS reduction. */
+    LbtsMessage m_lbtsGlobal;
+    /** Reduction operator combining LbtsMessage contributions. */
+    MPI_Op m_lbtsOp;
+    /** MPI datatype of an LbtsMessage. */
+    MPI_Datatype m_lbtsType;
+    /** Events executed in the current granted time window. */
+    uint64_t m_windowEvents;
+    /** Events executed in the previous granted time window. */
+    uint64_t m_lastWindowEvents;
+
+    /** File to write the cost of each node to at Destroy; empty to disable. */
+    std::string m_nodeCostFile;
+    /** Event count and wall time of each node. */
+    NodeCostProfiler m_nodeCosts;
+    /** Prefix of the files to write the synchronization counters to; empty to disable. */
+    std::string m_telemetryFile;
 };
 
 } // namespace ns3
@@ -18,7 +18,7 @@
 /**
  * \file
  * \ingroup mpi
- * Implementation of classes ns3::SentBuffer and ns3::GrantedTimeWindowMpiInterface.
+ * Implementation of class ns3::GrantedTimeWindowMpiInterface.
  */
 
 // This object contains static methods that provide an easy interface
@@ -28,6 +28,8 @@
 
 #include "mpi-interface.h"
 #include "mpi-receiver.h"
+#include "remote-packet-codec.h"
+#include "sync-telemetry.h"
 
 #include "ns3/log.h"
 #include "ns3/net-device.h"
@@ -37,9 +39,9 @@
 #include "ns3/simulator-impl.h"
 #include "ns3/simulator.h"
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <list>
 #include <mpi.h>
 
 namespace ns3
@@ -49,34 +51,23 @@ NS_LOG_COMPONENT_DEFINE("GrantedTimeWindowMpiInterface");
 
 NS_OBJECT_ENSURE_REGISTERED(GrantedTimeWindowMpiInterface);
 
-SentBuffer::SentBuffer()
-{
-    m_buffer = nullptr;
-    m_request = nullptr;
-}
-
-SentBuffer::~SentBuffer()
-{
-    delete[] m_buffer;
-}
-
-uint8_t*
-SentBuffer::GetBuffer()
-{
-    return m_buffer;
-}
+/** MPI tag of a message carrying a single packet. */
+const int PACKET_MSG_TAG = 0;
 
-void
-SentBuffer::SetBuffer(uint8_t* buffer)
-{
-    m_buffer = buffer;
-}
+/**
+ * MPI tag of a message carrying aggregated packets.  Each packet is
+ * framed by its message size as a uint32_t, followed by the same
+ * receive time, node, device and packet data used by single packets.
+ */
+const int AGGREGATE_MSG_TAG = 1;
 
-MPI_Request*
-SentBuffer::GetRequest()
-{
-    return &m_request;
-}
+/**
+ * Number of LBTS rounds distinguished by the MPI tag.  The tag of a
+ * message is its kind plus twice the round it was sent in, modulo this
+ * count.  A message would have to stay in flight for this many rounds
+ * to be mistaken for one sent in the next round.
+ */
+const uint32_t EPOCH_TAG_COUNT = 4096;
 
 uint32_t GrantedTimeWindowMpiInterface::g_sid = 0;
 uint32_t GrantedTimeWindowMpiInterface::g_size = 1;
@@ -84,10 +75,15 @@ bool GrantedTimeWindowMpiInterface::g_enabled = false;
 bool GrantedTimeWindowMpiInterface::g_mpiInitCalled = false;
 uint32_t GrantedTimeWindowMpiInterface::g_rxCount = 0;
 uint32_t GrantedTimeWindowMpiInterface::g_txCount = 0;
-std::list<SentBuffer> GrantedTimeWindowMpiInterface::g_pendingTx;
-
-MPI_Request* GrantedTimeWindowMpiInterface::g_requests;
-char** GrantedTimeWindowMpiInterface::g_pRxBuffers;
+uint32_t GrantedTimeWindowMpiInterface::g_epoch = 0;
+uint32_t GrantedTimeWindowMpiInterface::g_rxEarly = 0;
+SendBufferPool GrantedTimeWindowMpiInterface::g_pendingTx;
+bool GrantedTimeWindowMpiInterface::g_aggregate = false;
+std::vector<std::vector<uint8_t>> GrantedTimeWindowMpiInterface::g_aggregateTx;
+SharedMemoryRings GrantedTimeWindowMpiInterface::g_sharedRings;
+std::mutex GrantedTimeWindowMpiInterface::g_sendMutex;
+
+std::vector<uint8_t> GrantedTimeWindowMpiInterface::g_rxBuffer;
 MPI_Comm GrantedTimeWindowMpiInterface::g_communicator = MPI_COMM_WORLD;
 bool GrantedTimeWindowMpiInterface::g_freeCommunicator = false;
 
@@ -104,21 +100,26 @@ GrantedTimeWindowMpiInterface::Destroy()
 {
     NS_LOG_FUNCTION(this);
 
-    for (uint32_t i = 0; i < GetSize(); ++i)
-    {
-        delete[] g_pRxBuffers[i];
-    }
-    delete[] g_pRxBuffers;
-    delete[] g_requests;
-
-    g_pendingTx.clear();
+    g_pendingTx.Clear();
+    g_aggregateTx.clear();
+    g_rxBuffer.clear();
+    g_rxBuffer.shrink_to_fit();
 }
 
 uint32_t
 GrantedTimeWindowMpiInterface::GetRxCount()
 {
     NS_ASSERT(g_enabled);
-    return g_rxCount;
+    return g_rxCount - g_rxEarly;
+}
+
+void
+GrantedTimeWindowMpiInterface::AdvanceEpoch()
+{
+    NS_ASSERT(g_enabled);
+    // Packets from the new round are now part of the count
+    g_rxEarly = 0;
+    g_epoch++;
 }
 
 uint32_t
@@ -192,20 +193,7 @@ GrantedTimeWindowMpiInterface::Enable(MPI_Comm communicator)
     g_size = mpiSize;
 
     g_enabled = true;
-    // Post a non-blocking receive for all peers
-    g_pRxBuffers = new char*[g_size];
-    g_requests = new MPI_Request[g_size];
-    for (uint32_t i = 0; i < GetSize(); ++i)
-    {
-        g_pRxBuffers[i] = new char[MAX_MPI_MSG_SIZE];
-        MPI_Irecv(g_pRxBuffers[i],
-                  MAX_MPI_MSG_SIZE,
-                  MPI_CHAR,
-                  MPI_ANY_SOURCE,
-                  0,
-                  g_communicator,
-                  &g_requests[i]);
-    }
+    g_aggregateTx.resize(g_size);
 }
 
 void
@@ -216,35 +204,121 @@ GrantedTimeWindowMpiInterface::SendPacket(Ptr<Packet> p,
 {
     NS_LOG_FUNCTION(this << p << rxTime.GetTimeStep() << node << dev);
 
-    SentBuffer sendBuf;
-    g_pendingTx.push_back(sendBuf);
-    auto i = g_pendingTx.rbegin(); // Points to the last element
-
-    uint32_t serializedSize = p->GetSerializedSize();
-    auto buffer = new uint8_t[serializedSize + 16];
-    i->SetBuffer(buffer);
-    // Add the time, dest node and dest device
-    uint64_t t = rxTime.GetInteger();
-    auto pTime = reinterpret_cast<uint64_t*>(buffer);
-    *pTime++ = t;
-    auto pData = reinterpret_cast<uint32_t*>(pTime);
-    *pData++ = node;
-    *pData++ = dev;
-    // Serialize the packet
-    p->Serialize(reinterpret_cast<uint8_t*>(pData), serializedSize);
+    std::lock_guard<std::mutex> lock(g_sendMutex);
 
     // Find the system id for the destination node
     Ptr<Node> destNode = NodeList::GetNode(node);
     uint32_t nodeSysId = destNode->GetSystemId();
 
-    MPI_Isend(reinterpret_cast<void*>(i->GetBuffer()),
-              serializedSize + 16,
+    uint64_t t = rxTime.GetInteger();
+    uint32_t serializedSize = RemotePacketCodec::GetSerializedSize(p);
+    uint32_t messageSize = RemotePacketCodec::GetHeaderSize(t, node, dev) + serializedSize;
+    SyncTelemetry::RecordPacketTx(messageSize);
+
+    if (g_sharedRings.IsLocal(nodeSysId))
+    {
+        // Serialize the packet straight into the ring of the receiver
+        uint8_t* record = g_sharedRings.Reserve(nodeSysId, messageSize, g_epoch);
+        if (record != nullptr)
+        {
+            record = RemotePacketCodec::SerializeHeader(record, t, node, dev);
+            RemotePacketCodec::Serialize(p, record, serializedSize);
+            g_sharedRings.Commit(nodeSysId);
+            g_txCount++;
+            SyncTelemetry::RecordTx(nodeSysId, messageSize);
+            return;
+        }
+        // The ring is full, use MPI
+        NS_LOG_LOGIC("ring to rank " << nodeSysId << " full");
+    }
+
+    if (g_aggregate)
+    {
+        // Append the packet to the message for this rank, it is sent
+        // when the granted time window ends.
+        uint32_t recordSize = sizeof(messageSize) + messageSize;
+        std::vector<uint8_t>& pending = g_aggregateTx[nodeSysId];
+        std::size_t offset = pending.size();
+        pending.resize(offset + recordSize);
+        uint8_t* record = pending.data() + offset;
+        std::memcpy(record, &messageSize, sizeof(messageSize));
+        record += sizeof(messageSize);
+        record = RemotePacketCodec::SerializeHeader(record, t, node, dev);
+        RemotePacketCodec::Serialize(p, record, serializedSize);
+        g_txCount++;
+        return;
+    }
+
+    uint32_t slot = g_pendingTx.Allocate(messageSize);
+    uint8_t* buffer = g_pendingTx.GetBuffer(slot);
+    // Add the time, dest node and dest device, then the packet
+    uint8_t* data = RemotePacketCodec::SerializeHeader(buffer, t, node, dev);
+    RemotePacketCodec::Serialize(p, data, serializedSize);
+
+    MPI_Isend(reinterpret_cast<void*>(buffer),
+              messageSize,
               MPI_CHAR,
               nodeSysId,
-              0,
+              PACKET_MSG_TAG + 2 * (g_epoch % EPOCH_TAG_COUNT),
               g_communicator,
-              (i->GetRequest()));
+              g_pendingTx.GetRequest(slot));
     g_txCount++;
+    SyncTelemetry::RecordTx(nodeSysId, messageSize);
+}
+
+void
+GrantedTimeWindowMpiInterface::SetPacketAggregation(bool aggregate)
+{
+    NS_LOG_FUNCTION(aggregate);
+
+    g_aggregate = aggregate;
+}
+
+void
+GrantedTimeWindowMpiInterface::EnableSharedMemory(uint32_t capacity)
+{
+    NS_LOG_FUNCTION(capacity);
+
+    if (!g_sharedRings.IsEnabled())
+    {
+        g_sharedRings.Create(g_communicator, capacity);
+    }
+}
+
+void
+GrantedTimeWindowMpiInterface::FlushAggregatedPackets()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    for (uint32_t rank = 0; rank < g_aggregateTx.size(); ++rank)
+    {
+        FlushAggregatedPackets(rank);
+    }
+}
+
+void
+GrantedTimeWindowMpiInterface::FlushAggregatedPackets(uint32_t rank)
+{
+    std::vector<uint8_t>& pending = g_aggregateTx[rank];
+    if (pending.empty())
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(rank << pending.size());
+
+    uint32_t slot = g_pendingTx.Allocate(pending.size());
+    uint8_t* buffer = g_pendingTx.GetBuffer(slot);
+    std::memcpy(buffer, pending.data(), pending.size());
+
+    MPI_Isend(reinterpret_cast<void*>(buffer),
+              pending.size(),
+              MPI_CHAR,
+              rank,
+              AGGREGATE_MSG_TAG + 2 * (g_epoch % EPOCH_TAG_COUNT),
+              g_communicator,
+              g_pendingTx.GetRequest(slot));
+    SyncTelemetry::RecordTx(rank, pending.size());
+    pending.clear();
 }
 
 void
@@ -252,87 +326,119 @@ GrantedTimeWindowMpiInterface::ReceiveMessages()
 {
     NS_LOG_FUNCTION_NOARGS();
 
-    // Poll the non-block reads to see if data arrived
+    // Packets from the ranks of this host
+    uint32_t rank;
+    uint32_t size;
+    uint32_t epoch;
+    while (const uint8_t* data = g_sharedRings.Next(&rank, &size, &epoch))
+    {
+        SyncTelemetry::RecordRx(rank, size);
+        g_rxCount++;
+        if (epoch == g_epoch + 1)
+        {
+            // The sender already started the next LBTS round
+            g_rxEarly++;
+        }
+        ScheduleReceive(data, size);
+        g_sharedRings.Release();
+    }
+
+    // Probe for arrived messages from any rank; each matched message is
+    // received into a buffer of the right size.
     while (true)
     {
         int flag = 0;
-        int index = 0;
+        MPI_Message message;
         MPI_Status status;
 
-        MPI_Testany(MpiInterface::GetSize(), g_requests, &index, &flag, &status);
+        MPI_Improbe(MPI_ANY_SOURCE, MPI_ANY_TAG, g_communicator, &flag, &message, &status);
         if (!flag)
         {
             break; // No more messages
         }
         int count;
         MPI_Get_count(&status, MPI_CHAR, &count);
-        g_rxCount++; // Count this receive
-
-        // Get the meta data first
-        auto pTime = reinterpret_cast<uint64_t*>(g_pRxBuffers[index]);
-        uint64_t time = *pTime++;
-        auto pData = reinterpret_cast<uint32_t*>(pTime);
-        uint32_t node = *pData++;
-        uint32_t dev = *pData++;
-
-        Time rxTime(time);
-
-        count -= sizeof(time) + sizeof(node) + sizeof(dev);
-
-        Ptr<Packet> p = Create<Packet>(reinterpret_cast<uint8_t*>(pData), count, true);
+        if (g_rxBuffer.size() < static_cast<std::size_t>(count))
+        {
+            g_rxBuffer.resize(count);
+        }
+        MPI_Mrecv(g_rxBuffer.data(), count, MPI_CHAR, &message, MPI_STATUS_IGNORE);
+        SyncTelemetry::RecordRx(status.MPI_SOURCE, count);
+        uint8_t* data = g_rxBuffer.data();
+        uint32_t rxCount = g_rxCount;
 
-        // Find the correct node/device to schedule receive event
-        Ptr<Node> pNode = NodeList::GetNode(node);
-        Ptr<MpiReceiver> pMpiRec = nullptr;
-        uint32_t nDevices = pNode->GetNDevices();
-        for (uint32_t i = 0; i < nDevices; ++i)
+        if (status.MPI_TAG % 2 == AGGREGATE_MSG_TAG)
         {
-            Ptr<NetDevice> pThisDev = pNode->GetDevice(i);
-            if (pThisDev->GetIfIndex() == dev)
+            // Unpack each framed packet in the aggregated message
+            uint8_t* end = data + count;
+            while (data < end)
             {
-                pMpiRec = pThisDev->GetObject<MpiReceiver>();
-                break;
+                uint32_t messageSize;
+                std::memcpy(&messageSize, data, sizeof(messageSize));
+                data += sizeof(messageSize);
+                NS_ASSERT(data + messageSize <= end);
+                g_rxCount++; // Count this receive
+                ScheduleReceive(data, messageSize);
+                data += messageSize;
             }
         }
+        else
+        {
+            g_rxCount++; // Count this receive
+            ScheduleReceive(data, count);
+        }
 
-        NS_ASSERT(pNode && pMpiRec);
-
-        // Schedule the rx event
-        Simulator::ScheduleWithContext(pNode->GetId(),
-                                       rxTime - Simulator::Now(),
-                                       &MpiReceiver::Receive,
-                                       pMpiRec,
-                                       p);
-
-        // Re-queue the next read
-        MPI_Irecv(g_pRxBuffers[index],
-                  MAX_MPI_MSG_SIZE,
-                  MPI_CHAR,
-                  MPI_ANY_SOURCE,
-                  0,
-                  g_communicator,
-                  &g_requests[index]);
+        // The sender already started the next LBTS round
+        if (static_cast<uint32_t>(status.MPI_TAG / 2) == (g_epoch + 1) % EPOCH_TAG_COUNT)
+        {
+            g_rxEarly += g_rxCount - rxCount;
+        }
     }
 }
 
 void
-GrantedTimeWindowMpiInterface::TestSendComplete()
+GrantedTimeWindowMpiInterface::ScheduleReceive(const uint8_t* data, uint32_t size)
 {
-    NS_LOG_FUNCTION_NOARGS();
+    // Get the meta data first
+    uint64_t time;
+    uint32_t node;
+    uint32_t dev;
+    const uint8_t* packet = RemotePacketCodec::DeserializeHeader(data, &time, &node, &dev);
 
-    auto i = g_pendingTx.begin();
-    while (i != g_pendingTx.end())
+    Time rxTime(time);
+
+    Ptr<Packet> p = RemotePacketCodec::Deserialize(packet, size - (packet - data));
+
+    // Find the correct node/device to schedule receive event
+    Ptr<Node> pNode = NodeList::GetNode(node);
+    Ptr<MpiReceiver> pMpiRec = nullptr;
+    uint32_t nDevices = pNode->GetNDevices();
+    for (uint32_t i = 0; i < nDevices; ++i)
     {
-        MPI_Status status;
-        int flag = 0;
-        MPI_Test(i->GetRequest(), &flag, &status);
-        auto current = i; // Save current for erasing
-        i++;              // Advance to next
-        if (flag)
-        { // This message is complete
-            g_pendingTx.erase(current);
+        Ptr<NetDevice> pThisDev = pNode->GetDevice(i);
+        if (pThisDev->GetIfIndex() == dev)
+        {
+            pMpiRec = pThisDev->GetObject<MpiReceiver>();
+            break;
         }
     }
+
+    NS_ASSERT(pNode && pMpiRec);
+
+    // Schedule the rx event
+    Simulator::ScheduleWithContext(pNode->GetId(),
+                                   rxTime - Simulator::Now(),
+                                   &MpiReceiver::Receive,
+                                   pMpiRec,
+                                   p);
+}
+
+void
+GrantedTimeWindowMpiInterface::TestSendComplete()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    g_pendingTx.TestComplete();
 }
 
 void
@@ -340,6 +446,8 @@ GrantedTimeWindowMpiInterface::Disable()
 {
     NS_LOG_FUNCTION_NOARGS();
 
+    g_sharedRings.Free();
+
     if (g_freeCommunicator)
     {
         MPI_Comm_free(&g_communicator);
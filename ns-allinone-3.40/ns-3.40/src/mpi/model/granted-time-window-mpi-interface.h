@@ -18,7 +18,7 @@
 /**
  * \file
  * \ingroup mpi
- * Declaration of classes ns3::SentBuffer and ns3::GrantedTimeWindowMpiInterface.
+ * Declaration of class ns3::GrantedTimeWindowMpiInterface.
  */
 
 // This object contains static methods that provide an easy interface
@@ -28,57 +28,23 @@
 #define NS3_GRANTED_TIME_WINDOW_MPI_INTERFACE_H
 
 #include "parallel-communication-interface.h"
+#include "send-buffer-pool.h"
+#include "shared-memory-rings.h"
 
 #include "ns3/buffer.h"
 #include "ns3/nstime.h"
 
-#include <list>
 #include <mpi.h>
+#include <mutex>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t MAX_MPI_MSG_SIZE = 2000;
-
-/**
- * \ingroup mpi
- *
- * \brief Tracks non-blocking sends
- *
- * This class is used to keep track of the asynchronous non-blocking
- * sends that have been posted.
- */
-class SentBuffer
-{
-  public:
-    SentBuffer();
-    ~SentBuffer();
-
-    /**
-     * \return pointer to sent buffer
-     */
-    uint8_t* GetBuffer();
-    /**
-     * \param buffer pointer to sent buffer
-     */
-    void SetBuffer(uint8_t* buffer);
-    /**
-     * \return MPI request
-     */
-    MPI_Request* GetRequest();
-
-  private:
-    uint8_t* m_buffer;     /**< The buffer. */
-    MPI_Request m_request; /**< The MPI request handle. */
-};
-
 class Packet;
 class DistributedSimulatorImpl;
+class HybridSimulatorImpl;
 
 /**
  * \ingroup mpi
@@ -117,17 +83,64 @@ class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Obj
      * It is not intended for state to be shared.
      */
     friend ns3::DistributedSimulatorImpl;
+    friend ns3::HybridSimulatorImpl;
 
     /**
      * Check for received messages complete
      */
     static void ReceiveMessages();
+    /**
+     * Rebuild a received packet and schedule its receive event.
+     *
+     * \param [in] data Start of the message: receive time, destination
+     *             node and device, followed by the serialized packet.
+     * \param [in] size Number of bytes in the message.
+     */
+    static void ScheduleReceive(const uint8_t* data, uint32_t size);
+    /**
+     * Enable or disable coalescing of the packets sent to each
+     * remote rank into one MPI message per granted time window.
+     *
+     * \param [in] aggregate \c true to enable packet aggregation.
+     */
+    static void SetPacketAggregation(bool aggregate);
+    /**
+     * Carry the packets to the ranks on this host through rings in
+     * shared memory instead of MPI messages.  Collective; does nothing
+     * if the rings already exist.
+     *
+     * \param [in] capacity The size in bytes of the ring from each rank
+     *             to each other rank of the host; 0 to use MPI messages.
+     */
+    static void EnableSharedMemory(uint32_t capacity);
+    /**
+     * Send the packets aggregated for every remote rank.
+     *
+     * Must be called before the LBTS computation so the aggregated
+     * packets are accounted as in flight.
+     */
+    static void FlushAggregatedPackets();
+    /**
+     * Send the packets aggregated for one remote rank.
+     *
+     * \param [in] rank The destination rank.
+     */
+    static void FlushAggregatedPackets(uint32_t rank);
     /**
      * Check for completed sends
      */
     static void TestSendComplete();
     /**
-     * \return received count in packets
+     * Start a new LBTS round.
+     *
+     * Used when the LBTS reduction overlaps event execution.  Packets
+     * sent from now on are tagged with the new round, so a receiver that
+     * has not started the round yet does not count them.
+     */
+    static void AdvanceEpoch();
+    /**
+     * \return received count in packets, excluding packets sent after
+     * the sender started an LBTS round this task has not started yet
      */
     static uint32_t GetRxCount();
     /**
@@ -146,6 +159,12 @@ class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Obj
     /** Total packets sent. */
     static uint32_t g_txCount;
 
+    /** Number of LBTS rounds started, see AdvanceEpoch(). */
+    static uint32_t g_epoch;
+
+    /** Packets received that were sent in the next LBTS round. */
+    static uint32_t g_rxEarly;
+
     /** Has this interface been enabled. */
     static bool g_enabled;
 
@@ -155,14 +174,29 @@ class GrantedTimeWindowMpiInterface : public ParallelCommunicationInterface, Obj
      */
     static bool g_mpiInitCalled;
 
-    /** Pending non-blocking receives. */
-    static MPI_Request* g_requests;
+    /**
+     * Reusable receive buffer.  Messages are probed before they are
+     * received, the buffer grows to the largest message seen.
+     */
+    static std::vector<uint8_t> g_rxBuffer;
+
+    /** Buffers of the pending non-blocking sends. */
+    static SendBufferPool g_pendingTx;
+
+    /** Are packets to the same rank coalesced into one message per window. */
+    static bool g_aggregate;
+
+    /** Rings to the ranks sharing this host. */
+    static SharedMemoryRings g_sharedRings;
 
-    /** Data buffers for non-blocking reads. */
-    static char** g_pRxBuffers;
+    /** Packets waiting to be sent in one aggregated message, indexed by rank. */
+    static std::vector<std::vector<uint8_t>> g_aggregateTx;
 
-    /** List of pending non-blocking sends. */
-    static std::list<SentBuffer> g_pendingTx;
+    /**
+     * Serializes SendPacket(), which the threads of HybridSimulatorImpl
+     * call concurrently with packet aggregation enabled.
+     */
+    static std::mutex g_sendMutex;
 
     /** MPI communicator being used for ns-3 tasks. */
     static MPI_Comm g_communicator;
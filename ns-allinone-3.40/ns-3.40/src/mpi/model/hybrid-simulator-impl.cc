@@ -0,0 +1,767 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::HybridSimulatorImpl.
+ */
+
+#include "hybrid-simulator-impl.h"
+
+#include "granted-time-window-mpi-interface.h"
+#include "mpi-interface.h"
+#include "sync-telemetry.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <mpi.h>
+#include <thread>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("HybridSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(HybridSimulatorImpl);
+
+/**
+ * Partition executed by the current thread; the main thread executes
+ * partition 0, which also holds the events scheduled before Run().
+ */
+static thread_local uint32_t g_partition = 0;
+
+TypeId
+HybridSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HybridSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mpi")
+            .AddConstructor<HybridSimulatorImpl>()
+            .AddAttribute("ThreadCount",
+                          "Number of threads executing the nodes of this rank",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&HybridSimulatorImpl::m_threadCount),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SharedMemoryRingSize",
+                          "Size in bytes of the shared memory ring carrying packets to each "
+                          "rank on the same host instead of MPI messages; 0 to always use MPI",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&HybridSimulatorImpl::m_sharedMemoryRingSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TelemetryFile",
+                          "Write the synchronization counters of each rank to "
+                          "<TelemetryFile>-<rank>.csv at Destroy; empty to disable",
+                          StringValue(""),
+                          MakeStringAccessor(&HybridSimulatorImpl::m_telemetryFile),
+                          MakeStringChecker());
+    return tid;
+}
+
+HybridSimulatorImpl::HybridSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_myId = MpiInterface::GetSystemId();
+    m_systemCount = MpiInterface::GetSize();
+    m_pLBTS.resize(m_systemCount);
+    m_grantedTime = Seconds(0);
+    m_lookAhead = GetMaximumSimulationTime();
+    m_partitionLookAhead = GetMaximumSimulationTime();
+
+    m_stop = false;
+    m_globalFinished = false;
+    m_inWindow = false;
+    m_round = 0;
+    m_threadCount = 1;
+    m_sharedMemoryRingSize = 0;
+    m_barrierCount = 0;
+    m_barrierGeneration = 0;
+    // Partition 0 holds all the events until Run() knows the nodes
+    m_partitions.resize(1);
+
+    SyncTelemetry::Reset(m_systemCount);
+}
+
+HybridSimulatorImpl::~HybridSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+HybridSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto& partition : m_partitions)
+    {
+        while (!partition.m_events->IsEmpty())
+        {
+            Scheduler::Event next = partition.m_events->RemoveNext();
+            next.impl->Unref();
+        }
+        partition.m_events = nullptr;
+        for (auto& outbox : partition.m_outbox)
+        {
+            for (auto& events : outbox)
+            {
+                for (auto& ev : events)
+                {
+                    ev.impl->Unref();
+                }
+            }
+        }
+    }
+    m_partitions.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+HybridSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+
+    if (!m_telemetryFile.empty())
+    {
+        SyncTelemetry::Write(m_telemetryFile, m_myId);
+    }
+
+    MpiInterface::Destroy();
+}
+
+void
+HybridSimulatorImpl::AssignPartitions()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::vector<uint32_t> localNodes;
+    for (auto iter = NodeList::Begin(); iter != NodeList::End(); ++iter)
+    {
+        if ((*iter)->GetSystemId() == m_myId)
+        {
+            localNodes.push_back((*iter)->GetId());
+        }
+    }
+
+#ifndef NS3_MPI_THREADS
+    NS_ABORT_MSG_IF(m_threadCount > 1,
+                    "Running HybridSimulatorImpl on several threads requires building ns-3 "
+                    "with NS3_MPI_THREADS");
+#endif
+
+    // Consecutive node ids are usually close in the topology
+    uint32_t count = std::min<std::size_t>(m_threadCount, localNodes.size());
+    count = std::max<uint32_t>(count, 1);
+    m_nodePartition.assign(NodeList::GetNNodes(), 0);
+    for (std::size_t i = 0; i < localNodes.size(); ++i)
+    {
+        m_nodePartition[localNodes[i]] = i * count / localNodes.size();
+    }
+
+    m_partitions.resize(count);
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        Partition& partition = m_partitions[index];
+        if (index > 0)
+        {
+            partition.m_events = m_schedulerFactory.Create<Scheduler>();
+            partition.m_uid = m_partitions[0].m_uid;
+            partition.m_currentTs = m_partitions[0].m_currentTs;
+        }
+        for (auto& outbox : partition.m_outbox)
+        {
+            outbox.resize(count);
+        }
+    }
+    NS_LOG_INFO("Executing " << localNodes.size() << " nodes on " << count << " threads");
+
+    // Move the events scheduled before Run() to their partition
+    std::vector<Scheduler::Event> moved;
+    Partition& main = m_partitions[0];
+    while (!main.m_events->IsEmpty())
+    {
+        moved.push_back(main.m_events->RemoveNext());
+    }
+    for (auto& ev : moved)
+    {
+        Partition& partition = m_partitions[GetPartition(ev.key.m_context)];
+        if (&partition != &main)
+        {
+            main.m_unscheduledEvents--;
+            partition.m_unscheduledEvents++;
+        }
+        partition.m_events->Insert(ev);
+    }
+}
+
+void
+HybridSimulatorImpl::CalculateLookAhead()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto iter = NodeList::Begin(); iter != NodeList::End(); ++iter)
+    {
+        if ((*iter)->GetSystemId() != m_myId)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < (*iter)->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> localNetDevice = (*iter)->GetDevice(i);
+            // only works for p2p links currently
+            if (!localNetDevice->IsPointToPoint())
+            {
+                continue;
+            }
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+
+            // grab the adjacent node
+            Ptr<Node> remoteNode;
+            if (channel->GetDevice(0) == localNetDevice)
+            {
+                remoteNode = (channel->GetDevice(1))->GetNode();
+            }
+            else
+            {
+                remoteNode = (channel->GetDevice(0))->GetNode();
+            }
+
+            TimeValue delay;
+            channel->GetAttribute("Delay", delay);
+            if (remoteNode->GetSystemId() != m_myId)
+            {
+                m_lookAhead = Min(m_lookAhead, delay.Get());
+            }
+            else if (GetPartition(remoteNode->GetId()) != GetPartition((*iter)->GetId()))
+            {
+                m_partitionLookAhead = Min(m_partitionLookAhead, delay.Get());
+                // The two threads must not share the packets sent over the link
+                NS_ABORT_MSG_UNLESS(channel->SetAttributeFailSafe("DeepCopy", BooleanValue(true)),
+                                    "Partitions must be connected by PointToPointChannels");
+            }
+        }
+    }
+
+    // As in DistributedSimulatorImpl, tasks with no inter-task links use
+    // the largest lookahead of the other tasks.
+    long sendbuf = m_lookAhead == GetMaximumSimulationTime() ? 0 : m_lookAhead.GetInteger();
+    long recvbuf;
+    MPI_Allreduce(&sendbuf, &recvbuf, 1, MPI_LONG, MPI_MAX, MpiInterface::GetCommunicator());
+    if (m_lookAhead == GetMaximumSimulationTime() && recvbuf != 0)
+    {
+        m_lookAhead = Time(recvbuf);
+    }
+    NS_LOG_INFO("Lookahead " << m_lookAhead << " between ranks, " << m_partitionLookAhead
+                             << " between partitions");
+}
+
+uint32_t
+HybridSimulatorImpl::GetPartition(uint32_t context) const
+{
+    return context < m_nodePartition.size() ? m_nodePartition[context] : 0;
+}
+
+void
+HybridSimulatorImpl::BoundLookAhead(const Time lookAhead)
+{
+    if (lookAhead > Time(0))
+    {
+        NS_LOG_FUNCTION(this << lookAhead);
+        m_lookAhead = Min(m_lookAhead, lookAhead);
+    }
+    else
+    {
+        NS_LOG_WARN("attempted to set lookahead to a negative time: " << lookAhead);
+    }
+}
+
+void
+HybridSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+
+    m_schedulerFactory = schedulerFactory;
+    for (auto& partition : m_partitions)
+    {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (partition.m_events)
+        {
+            while (!partition.m_events->IsEmpty())
+            {
+                Scheduler::Event next = partition.m_events->RemoveNext();
+                scheduler->Insert(next);
+            }
+        }
+        partition.m_events = scheduler;
+    }
+}
+
+void
+HybridSimulatorImpl::ProcessOneEvent(Partition& partition)
+{
+    Scheduler::Event next = partition.m_events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= partition.m_currentTs);
+    partition.m_unscheduledEvents--;
+    partition.m_eventCount++;
+    partition.m_windowEvents++;
+
+    NS_LOG_LOGIC("handle " << next.key.m_ts);
+    partition.m_currentTs = next.key.m_ts;
+    partition.m_currentContext = next.key.m_context;
+    partition.m_currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+HybridSimulatorImpl::Barrier()
+{
+    uint32_t generation = m_barrierGeneration.load(std::memory_order_acquire);
+    if (m_barrierCount.fetch_add(1, std::memory_order_acq_rel) + 1 == m_partitions.size())
+    {
+        m_barrierCount.store(0, std::memory_order_relaxed);
+        m_barrierGeneration.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    // Windows are short, so spin rather than sleep
+    while (m_barrierGeneration.load(std::memory_order_acquire) == generation)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void
+HybridSimulatorImpl::DeliverEvents(uint32_t index)
+{
+    Partition& partition = m_partitions[index];
+    // The outboxes of the window which just ended
+    uint32_t parity = (m_round - 1) % 2;
+    for (auto& source : m_partitions)
+    {
+        std::vector<Scheduler::Event>& events = source.m_outbox[parity][index];
+        for (auto& ev : events)
+        {
+            ev.key.m_uid = partition.m_uid++;
+            partition.m_unscheduledEvents++;
+            partition.m_events->Insert(ev);
+        }
+        events.clear();
+    }
+}
+
+void
+HybridSimulatorImpl::Synchronize()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_inWindow = false;
+
+    // Receive the packets of the other ranks into the partitions and
+    // send the packets aggregated during the window.
+    GrantedTimeWindowMpiInterface::ReceiveMessages();
+    GrantedTimeWindowMpiInterface::FlushAggregatedPackets();
+    GrantedTimeWindowMpiInterface::TestSendComplete();
+
+    // The events of the window in the outboxes are not delivered yet
+    const uint64_t maxTs = GetMaximumSimulationTime().GetTimeStep();
+    uint64_t nextTs = maxTs;
+    uint64_t windowEvents = 0;
+    for (auto& partition : m_partitions)
+    {
+        if (!partition.m_events->IsEmpty())
+        {
+            nextTs = std::min(nextTs, partition.m_events->PeekNext().key.m_ts);
+        }
+        for (auto& events : partition.m_outbox[m_round % 2])
+        {
+            for (auto& ev : events)
+            {
+                nextTs = std::min(nextTs, ev.key.m_ts);
+            }
+        }
+        windowEvents += partition.m_windowEvents;
+        partition.m_windowEvents = 0;
+    }
+    bool localFinished = m_stop || nextTs == maxTs;
+    Time nextTime = localFinished ? GetMaximumSimulationTime() : TimeStep(nextTs);
+
+    LbtsMessage lMsg(GrantedTimeWindowMpiInterface::GetRxCount(),
+                     GrantedTimeWindowMpiInterface::GetTxCount(),
+                     m_myId,
+                     localFinished,
+                     nextTime);
+    SyncTelemetry::Clock::time_point blockStart = SyncTelemetry::Clock::now();
+    MPI_Allgather(&lMsg,
+                  sizeof(LbtsMessage),
+                  MPI_BYTE,
+                  m_pLBTS.data(),
+                  sizeof(LbtsMessage),
+                  MPI_BYTE,
+                  MpiInterface::GetCommunicator());
+    SyncTelemetry::RecordBlocked(blockStart);
+
+    Time smallestTime = GetMaximumSimulationTime();
+    uint32_t totRx = 0;
+    uint32_t totTx = 0;
+    m_globalFinished = true;
+    for (auto& msg : m_pLBTS)
+    {
+        smallestTime = Min(smallestTime, msg.GetSmallestTime());
+        totRx += msg.GetRxCount();
+        totTx += msg.GetTxCount();
+        m_globalFinished &= msg.IsFinished();
+    }
+    // Global halting condition is all nodes have empty queue's and
+    // no messages are in-flight.
+    m_globalFinished &= totRx == totTx;
+
+    Time previousGrantedTime = m_grantedTime;
+    if (totRx == totTx)
+    {
+        // Guard against overflow when there is nothing to wait for
+        Time grantedTime = GetMaximumSimulationTime();
+        if (m_lookAhead != GetMaximumSimulationTime() &&
+            smallestTime != GetMaximumSimulationTime())
+        {
+            grantedTime = smallestTime + m_lookAhead;
+        }
+        if (m_partitionLookAhead != GetMaximumSimulationTime() &&
+            nextTime != GetMaximumSimulationTime())
+        {
+            grantedTime = Min(grantedTime, nextTime + m_partitionLookAhead);
+        }
+        m_grantedTime = Max(m_grantedTime, grantedTime);
+    }
+    SyncTelemetry::RecordRound(m_grantedTime - previousGrantedTime, windowEvents);
+
+    m_round++;
+    m_inWindow = true;
+}
+
+void
+HybridSimulatorImpl::RunPartition(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+
+    g_partition = index;
+    Partition& partition = m_partitions[index];
+    while (true)
+    {
+        Barrier();
+        if (index == 0)
+        {
+            Synchronize();
+        }
+        Barrier();
+        DeliverEvents(index);
+        if (m_globalFinished)
+        {
+            break;
+        }
+
+        // Execute the events of this partition within the window
+        while (!m_stop && !partition.m_events->IsEmpty() &&
+               TimeStep(partition.m_events->PeekNext().key.m_ts) <= m_grantedTime)
+        {
+            ProcessOneEvent(partition);
+        }
+    }
+    g_partition = 0;
+}
+
+void
+HybridSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+
+    SyncTelemetry::Clock::time_point runStart = SyncTelemetry::Clock::now();
+    if (m_nodePartition.empty())
+    {
+        AssignPartitions();
+    }
+    CalculateLookAhead();
+    // Only the main thread may call MPI, so the threads queue the
+    // packets to other ranks until the end of the window.
+    GrantedTimeWindowMpiInterface::SetPacketAggregation(true);
+    GrantedTimeWindowMpiInterface::EnableSharedMemory(m_sharedMemoryRingSize);
+    m_stop = false;
+    m_globalFinished = false;
+
+    std::vector<std::thread> threads;
+    for (uint32_t index = 1; index < m_partitions.size(); ++index)
+    {
+        threads.emplace_back(&HybridSimulatorImpl::RunPartition, this, index);
+    }
+    RunPartition(0);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    m_inWindow = false;
+
+    SyncTelemetry::RecordRun(runStart);
+
+    // If the simulator stopped naturally by lack of events, make a
+    // consistency test to check that we didn't lose any events along the way.
+    for (auto& partition : m_partitions)
+    {
+        NS_ASSERT(!partition.m_events->IsEmpty() || partition.m_unscheduledEvents == 0);
+    }
+}
+
+uint32_t
+HybridSimulatorImpl::GetSystemId() const
+{
+    return m_myId;
+}
+
+bool
+HybridSimulatorImpl::IsFinished() const
+{
+    return m_globalFinished;
+}
+
+void
+HybridSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_stop = true;
+}
+
+void
+HybridSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+
+    Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+HybridSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+
+    Partition& partition = m_partitions[g_partition];
+    Time tAbsolute = delay + TimeStep(partition.m_currentTs);
+
+    NS_ASSERT(tAbsolute.IsPositive());
+    NS_ASSERT(tAbsolute >= TimeStep(partition.m_currentTs));
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = static_cast<uint64_t>(tAbsolute.GetTimeStep());
+    ev.key.m_context = partition.m_currentContext;
+    ev.key.m_uid = partition.m_uid;
+    partition.m_uid++;
+    partition.m_unscheduledEvents++;
+    partition.m_events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+HybridSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    Partition& current = m_partitions[g_partition];
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = current.m_currentTs + delay.GetTimeStep();
+    ev.key.m_context = context;
+
+    uint32_t index = GetPartition(context);
+    if (index != g_partition && m_inWindow)
+    {
+        // The other thread may be executing this window, so the event
+        // waits for the next one.
+        NS_ABORT_MSG_IF(TimeStep(ev.key.m_ts) < m_grantedTime,
+                        "Event for node " << context << " of another partition scheduled "
+                                          "within the window; partitions must be connected "
+                                          "by point-to-point links");
+        current.m_outbox[m_round % 2][index].push_back(ev);
+        return;
+    }
+
+    Partition& partition = m_partitions[index];
+    ev.key.m_uid = partition.m_uid;
+    partition.m_uid++;
+    partition.m_unscheduledEvents++;
+    partition.m_events->Insert(ev);
+}
+
+EventId
+HybridSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << event);
+    return Schedule(Time(0), event);
+}
+
+EventId
+HybridSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << event);
+
+    std::lock_guard<std::mutex> lock(m_destroyMutex);
+    EventId id(Ptr<EventImpl>(event, false), m_partitions[g_partition].m_currentTs, 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+HybridSimulatorImpl::Now() const
+{
+    return TimeStep(m_partitions[g_partition].m_currentTs);
+}
+
+Time
+HybridSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - m_partitions[g_partition].m_currentTs);
+    }
+}
+
+void
+HybridSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::lock_guard<std::mutex> lock(m_destroyMutex);
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition& partition = m_partitions[GetPartition(id.GetContext())];
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    partition.m_events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    partition.m_unscheduledEvents--;
+}
+
+void
+HybridSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+HybridSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    const Partition& partition = m_partitions[GetPartition(id.GetContext())];
+    return id.PeekEventImpl() == nullptr || id.GetTs() < partition.m_currentTs ||
+           (id.GetTs() == partition.m_currentTs && id.GetUid() <= partition.m_currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+HybridSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+HybridSimulatorImpl::GetContext() const
+{
+    return m_partitions[g_partition].m_currentContext;
+}
+
+uint64_t
+HybridSimulatorImpl::GetEventCount() const
+{
+    uint64_t eventCount = 0;
+    for (auto& partition : m_partitions)
+    {
+        eventCount += partition.m_eventCount;
+    }
+    return eventCount;
+}
+
+} // namespace ns3
@@ -0,0 +1,240 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::HybridSimulatorImpl.
+ */
+
+#ifndef NS3_HYBRID_SIMULATOR_IMPL_H
+#define NS3_HYBRID_SIMULATOR_IMPL_H
+
+#include "distributed-simulator-impl.h"
+
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/simulator.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief Distributed simulator implementation running several threads
+ * per rank.
+ *
+ * The nodes of this rank are split into partitions of consecutive node
+ * ids, one per thread, each with its own event queue.  All the threads
+ * of all the ranks share the conservative time window of the granted
+ * time window algorithm: the window ends at the smallest of the
+ * smallest next event time of all ranks plus the delay of the shortest
+ * link between ranks, and the smallest next event time of this rank
+ * plus the delay of the shortest link between partitions.
+ *
+ * Events scheduled by one thread for a node of another partition are
+ * appended to an outbox owned by the sending thread and handed over to
+ * the receiving thread at the next window, so they are not locked.  The
+ * point-to-point channels between partitions serialize their packets, so
+ * that the threads never share packet data.  Packets to other ranks are
+ * aggregated and sent through the GrantedTimeWindowMpiInterface by the
+ * first thread between windows, which also runs the LBTS computation.
+ *
+ * More than one thread requires ns-3 built with NS3_MPI_THREADS, which
+ * makes the reference counts, the packet free lists and the packet uids
+ * thread-safe.
+ */
+class HybridSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Default constructor. */
+    HybridSimulatorImpl();
+    /** Destructor. */
+    ~HybridSimulatorImpl() override;
+
+    // virtual from SimulatorImpl
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Add additional bound to lookahead constraints.
+     *
+     * \see DistributedSimulatorImpl::BoundLookAhead()
+     *
+     * \param [in] lookAhead The maximum lookahead; must be > 0.
+     */
+    virtual void BoundLookAhead(const Time lookAhead);
+
+  private:
+    // Inherited from Object
+    void DoDispose() override;
+
+    /** The events and clock of the nodes executed by one thread. */
+    struct alignas(64) Partition
+    {
+        /** The event priority queue. */
+        Ptr<Scheduler> m_events;
+        /** Next event unique id. */
+        uint32_t m_uid{EventId::UID::VALID};
+        /** Unique id of the current event. */
+        uint32_t m_currentUid{EventId::UID::INVALID};
+        /** Timestamp of the current event. */
+        uint64_t m_currentTs{0};
+        /** Execution context of the current event. */
+        uint32_t m_currentContext{Simulator::NO_CONTEXT};
+        /** The event count. */
+        uint64_t m_eventCount{0};
+        /** Events executed in the current window. */
+        uint64_t m_windowEvents{0};
+        /**
+         * Number of events that have been inserted but not yet
+         * scheduled, not counting the "destroy" events.
+         */
+        int m_unscheduledEvents{0};
+        /**
+         * Events scheduled for the other partitions, indexed by the
+         * parity of the window they were scheduled in, then by the
+         * destination partition.
+         */
+        std::vector<std::vector<Scheduler::Event>> m_outbox[2];
+    };
+
+    /**
+     * Split the nodes of this rank into partitions, one per thread, and
+     * move the events scheduled so far to the partition of their node.
+     */
+    void AssignPartitions();
+    /**
+     * Calculate the lookahead between ranks and between partitions
+     * from the delay of the point-to-point links between them.
+     */
+    void CalculateLookAhead();
+    /**
+     * Get the partition of an execution context.
+     *
+     * \param [in] context The context, usually a node id.
+     * \return The partition index; 0 for contexts which are not nodes
+     *         of this rank.
+     */
+    uint32_t GetPartition(uint32_t context) const;
+    /**
+     * Execute the windows of one partition until all the ranks are
+     * finished.
+     *
+     * \param [in] index The partition index.
+     */
+    void RunPartition(uint32_t index);
+    /**
+     * Exchange the packets and the LBTS with the other ranks, and
+     * compute the next window.  Run by the first thread while the other
+     * threads wait between windows.
+     */
+    void Synchronize();
+    /**
+     * Insert the events the other partitions scheduled for a partition
+     * during the previous window into its event queue.
+     *
+     * \param [in] index The partition index.
+     */
+    void DeliverEvents(uint32_t index);
+    /**
+     * Process the next event of a partition.
+     *
+     * \param [in,out] partition The partition.
+     */
+    void ProcessOneEvent(Partition& partition);
+    /** Wait until all the threads reach the barrier. */
+    void Barrier();
+
+    /** Container type for the events to run at Simulator::Destroy(). */
+    typedef std::list<EventId> DestroyEvents;
+
+    /** The container of events to run at Destroy() */
+    DestroyEvents m_destroyEvents;
+    /** Serialize changes to m_destroyEvents from the threads. */
+    std::mutex m_destroyMutex;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Are all parallel instances completed. */
+    bool m_globalFinished;
+    /** Are the threads executing a window. */
+    bool m_inWindow;
+    /** Windows executed; its parity selects the outboxes. */
+    uint32_t m_round;
+
+    /** The partitions, indexed by thread. */
+    std::vector<Partition> m_partitions;
+    /** Partition of each node of this rank, indexed by node id. */
+    std::vector<uint32_t> m_nodePartition;
+    /** Create the event queue of each partition. */
+    ObjectFactory m_schedulerFactory;
+    /** Number of threads, and so partitions, to use for this rank. */
+    uint32_t m_threadCount;
+    /** Size of the shared memory ring to each rank of this host; 0 to disable. */
+    uint32_t m_sharedMemoryRingSize;
+
+    /** Threads which have reached the barrier. */
+    std::atomic<uint32_t> m_barrierCount;
+    /** Incremented each time all threads have reached the barrier. */
+    std::atomic<uint32_t> m_barrierGeneration;
+
+    /** Container for Lbts messages, one per rank. */
+    std::vector<LbtsMessage> m_pLBTS;
+    uint32_t m_myId;           /**< MPI rank. */
+    uint32_t m_systemCount;    /**< MPI communicator size. */
+    Time m_grantedTime;        /**< End of current window. */
+    Time m_lookAhead;          /**< Smallest delay between ranks. */
+    Time m_partitionLookAhead; /**< Smallest delay between partitions. */
+
+    /** Prefix of the files to write the synchronization counters to; empty to disable. */
+    std::string m_telemetryFile;
+};
+
+} // namespace ns3
+
+#endif /* NS3_HYBRID_SIMULATOR_IMPL_H */
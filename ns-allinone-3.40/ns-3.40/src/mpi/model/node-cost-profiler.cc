@@ -0,0 +1,100 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::NodeCostProfiler.
+ */
+
+#include "node-cost-profiler.h"
+
+#include "mpi-interface.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+
+#include <fstream>
+#include <mpi.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NodeCostProfiler");
+
+NodeCostProfiler::NodeCostProfiler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+NodeCostProfiler::Grow(uint32_t context)
+{
+    NS_LOG_FUNCTION(this << context);
+
+    // Nodes may be added during the simulation, so don't rely on the
+    // node count at the start.
+    if (context >= NodeList::GetNNodes())
+    {
+        return false;
+    }
+    m_events.resize(NodeList::GetNNodes(), 0);
+    m_nanoseconds.resize(NodeList::GetNNodes(), 0);
+    return true;
+}
+
+void
+NodeCostProfiler::Write(const std::string& filename) const
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    MPI_Comm comm = MpiInterface::GetCommunicator();
+    uint64_t size = m_events.size();
+    uint64_t maxSize = 0;
+    MPI_Allreduce(&size, &maxSize, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    std::vector<uint64_t> events(m_events);
+    std::vector<uint64_t> nanoseconds(m_nanoseconds);
+    events.resize(maxSize, 0);
+    nanoseconds.resize(maxSize, 0);
+    std::vector<uint64_t> totalEvents(maxSize, 0);
+    std::vector<uint64_t> totalNanoseconds(maxSize, 0);
+    MPI_Reduce(events.data(), totalEvents.data(), maxSize, MPI_UINT64_T, MPI_SUM, 0, comm);
+    MPI_Reduce(nanoseconds.data(),
+               totalNanoseconds.data(),
+               maxSize,
+               MPI_UINT64_T,
+               MPI_SUM,
+               0,
+               comm);
+
+    if (MpiInterface::GetSystemId() != 0)
+    {
+        return;
+    }
+    std::ofstream out(filename);
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Can't open node cost file " << filename);
+    out << "# node events nanoseconds\n";
+    for (uint64_t node = 0; node < maxSize; ++node)
+    {
+        if (totalEvents[node] > 0)
+        {
+            out << node << " " << totalEvents[node] << " " << totalNanoseconds[node] << "\n";
+        }
+    }
+}
+
+} // namespace ns3
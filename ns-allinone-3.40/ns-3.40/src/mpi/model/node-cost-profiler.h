@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::NodeCostProfiler.
+ */
+
+#ifndef NS3_NODE_COST_PROFILER_H
+#define NS3_NODE_COST_PROFILER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Accumulate the number of events and the wall time spent
+ * executing them for each node.
+ *
+ * The distributed simulators record every event under its context,
+ * which is the id of the node it runs on.  At the end of the simulation
+ * the costs of all ranks are summed and rank 0 writes them to a text
+ * file with one line per node:
+ *
+ * \verbatim
+   # node events nanoseconds
+   0 1532 208311
+   1 20871 3120077
+   \endverbatim
+ *
+ * PartitionHelper::LoadNodeCosts() reads this file to weight the nodes
+ * when assigning them to ranks for the next run.
+ */
+class NodeCostProfiler
+{
+  public:
+    NodeCostProfiler();
+
+    /**
+     * Add the cost of one event.
+     *
+     * Events without a node context are not recorded.
+     *
+     * \param [in] context The context of the event.
+     * \param [in] nanoseconds The wall time spent executing it.
+     */
+    void Record(uint32_t context, int64_t nanoseconds)
+    {
+        if (context >= m_events.size() && !Grow(context))
+        {
+            return;
+        }
+        m_events[context]++;
+        m_nanoseconds[context] += nanoseconds;
+    }
+
+    /**
+     * Sum the costs of all ranks and write them to a file on rank 0.
+     *
+     * This is collective over the MPI communicator.
+     *
+     * \param [in] filename The file name.
+     */
+    void Write(const std::string& filename) const;
+
+  private:
+    /**
+     * Make room for a context.
+     *
+     * \param [in] context The context.
+     * \return \c false if the context is not a node id.
+     */
+    bool Grow(uint32_t context);
+
+    std::vector<uint64_t> m_events;      //!< Number of events, by node id.
+    std::vector<uint64_t> m_nanoseconds; //!< Wall time of the events, by node id.
+};
+
+} // namespace ns3
+
+#endif /* NS3_NODE_COST_PROFILER_H */
@@ -21,7 +21,7 @@
 /**
  * \file
  * \ingroup mpi
- * Implementation of classes ns3::NullMessageSentBuffer and ns3::NullMessageMpiInterface.
+ * Implementation of class ns3::NullMessageMpiInterface.
  */
 
 #include "null-message-mpi-interface.h"
@@ -30,6 +30,8 @@
 #include "null-message-simulator-impl.h"
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
+#include "remote-packet-codec.h"
+#include "sync-telemetry.h"
 
 #include "ns3/log.h"
 #include "ns3/net-device.h"
@@ -40,7 +42,6 @@
 
 #include <iomanip>
 #include <iostream>
-#include <list>
 #include <mpi.h>
 
 namespace ns3
@@ -50,78 +51,8 @@ NS_LOG_COMPONENT_DEFINE("NullMessageMpiInterface");
 
 NS_OBJECT_ENSURE_REGISTERED(NullMessageMpiInterface);
 
-/**
- * \ingroup mpi
- *
- * \brief Non-blocking send buffers for Null Message implementation.
- *
- * One buffer is allocated for each non-blocking send.
- */
-class NullMessageSentBuffer
-{
-  public:
-    NullMessageSentBuffer();
-    ~NullMessageSentBuffer();
-
-    /**
-     * \return pointer to sent buffer
-     */
-    uint8_t* GetBuffer();
-    /**
-     * \param buffer pointer to sent buffer
-     */
-    void SetBuffer(uint8_t* buffer);
-    /**
-     * \return MPI request
-     */
-    MPI_Request* GetRequest();
-
-  private:
-    /**
-     * Buffer for send.
-     */
-    uint8_t* m_buffer;
-
-    /**
-     * MPI request posted for the send.
-     */
-    MPI_Request m_request;
-};
-
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
-
-NullMessageSentBuffer::NullMessageSentBuffer()
-{
-    m_buffer = nullptr;
-    m_request = nullptr;
-}
-
-NullMessageSentBuffer::~NullMessageSentBuffer()
-{
-    delete[] m_buffer;
-}
-
-uint8_t*
-NullMessageSentBuffer::GetBuffer()
-{
-    return m_buffer;
-}
-
-void
-NullMessageSentBuffer::SetBuffer(uint8_t* buffer)
-{
-    m_buffer = buffer;
-}
-
-MPI_Request*
-NullMessageSentBuffer::GetRequest()
-{
-    return &m_request;
-}
+/** Destination device of a Null Message which requests a reply. */
+const uint32_t NULL_MESSAGE_REQUEST = 1;
 
 uint32_t NullMessageMpiInterface::g_sid = 0;
 uint32_t NullMessageMpiInterface::g_size = 1;
@@ -129,12 +60,11 @@ uint32_t NullMessageMpiInterface::g_numNeighbors = 0;
 bool NullMessageMpiInterface::g_enabled = false;
 bool NullMessageMpiInterface::g_mpiInitCalled = false;
 
-std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
+SendBufferPool NullMessageMpiInterface::g_pendingTx;
 
 MPI_Comm NullMessageMpiInterface::g_communicator = MPI_COMM_WORLD;
 bool NullMessageMpiInterface::g_freeCommunicator = false;
-MPI_Request* NullMessageMpiInterface::g_requests;
-char** NullMessageMpiInterface::g_pRxBuffers;
+std::vector<uint8_t> NullMessageMpiInterface::g_rxBuffer;
 
 TypeId
 NullMessageMpiInterface::GetTypeId()
@@ -234,27 +164,6 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers()
     NS_ASSERT(g_enabled);
 
     g_numNeighbors = RemoteChannelBundleManager::Size();
-
-    // Post a non-blocking receive for all peers
-    g_requests = new MPI_Request[g_numNeighbors];
-    g_pRxBuffers = new char*[g_numNeighbors];
-    int index = 0;
-    for (uint32_t rank = 0; rank < g_size; ++rank)
-    {
-        Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
-        if (bundle)
-        {
-            g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
-            MPI_Irecv(g_pRxBuffers[index],
-                      NULL_MESSAGE_MAX_MPI_MSG_SIZE,
-                      MPI_CHAR,
-                      rank,
-                      0,
-                      g_communicator,
-                      &g_requests[index]);
-            ++index;
-        }
-    }
 }
 
 void
@@ -268,14 +177,12 @@ NullMessageMpiInterface::SendPacket(Ptr<Packet> p, const Time& rxTime, uint32_t
     Ptr<Node> destNode = NodeList::GetNode(node);
     uint32_t nodeSysId = destNode->GetSystemId();
 
-    NullMessageSentBuffer sendBuf;
-    g_pendingTx.push_back(sendBuf);
-    auto iter = g_pendingTx.rbegin(); // Points to the last element
-
-    uint32_t serializedSize = p->GetSerializedSize();
+    // The fixed prefix distinguishes packets from null messages, only
+    // the packet itself follows the remote packet encoding.
+    uint32_t serializedSize = RemotePacketCodec::GetSerializedSize(p);
     uint32_t bufferSize = serializedSize + (2 * sizeof(uint64_t)) + (2 * sizeof(uint32_t));
-    auto buffer = new uint8_t[bufferSize];
-    iter->SetBuffer(buffer);
+    uint32_t slot = g_pendingTx.Allocate(bufferSize);
+    uint8_t* buffer = g_pendingTx.GetBuffer(slot);
     // Add the time, dest node and dest device
     uint64_t t = rxTime.GetInteger();
     auto pTime = reinterpret_cast<uint64_t*>(buffer);
@@ -284,57 +191,64 @@ NullMessageMpiInterface::SendPacket(Ptr<Packet> p, const Time& rxTime, uint32_t
     Time guarantee_update =
         NullMessageSimulatorImpl::GetInstance()->CalculateGuaranteeTime(nodeSysId);
     *pTime++ = guarantee_update.GetTimeStep();
+    RemoteChannelBundleManager::Find(nodeSysId)->SetSentGuaranteeTime(guarantee_update);
 
     auto pData = reinterpret_cast<uint32_t*>(pTime);
     *pData++ = node;
     *pData++ = dev;
     // Serialize the packet
-    p->Serialize(reinterpret_cast<uint8_t*>(pData), serializedSize);
+    RemotePacketCodec::Serialize(p, reinterpret_cast<uint8_t*>(pData), serializedSize);
 
-    MPI_Isend(reinterpret_cast<void*>(iter->GetBuffer()),
+    MPI_Isend(reinterpret_cast<void*>(buffer),
               bufferSize,
               MPI_CHAR,
               nodeSysId,
               0,
               g_communicator,
-              (iter->GetRequest()));
+              g_pendingTx.GetRequest(slot));
+    SyncTelemetry::RecordTx(nodeSysId, bufferSize);
+    SyncTelemetry::RecordPacketTx(bufferSize);
 
     NullMessageSimulatorImpl::GetInstance()->RescheduleNullMessageEvent(nodeSysId);
 }
 
 void
 NullMessageMpiInterface::SendNullMessage(const Time& guarantee_update,
-                                         Ptr<RemoteChannelBundle> bundle)
+                                         Ptr<RemoteChannelBundle> bundle,
+                                         bool request)
 {
-    NS_LOG_FUNCTION(guarantee_update.GetTimeStep() << bundle);
+    NS_LOG_FUNCTION(guarantee_update.GetTimeStep() << bundle << request);
 
     NS_ASSERT(g_enabled);
 
-    NullMessageSentBuffer sendBuf;
-    g_pendingTx.push_back(sendBuf);
-    auto iter = g_pendingTx.rbegin(); // Points to the last element
-
     uint32_t bufferSize = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
-    auto buffer = new uint8_t[bufferSize];
-    iter->SetBuffer(buffer);
+    uint32_t slot = g_pendingTx.Allocate(bufferSize);
+    uint8_t* buffer = g_pendingTx.GetBuffer(slot);
     // Add the time, dest node and dest device
     auto pTime = reinterpret_cast<uint64_t*>(buffer);
     *pTime++ = 0;
     *pTime++ = guarantee_update.GetInteger();
     auto pData = reinterpret_cast<uint32_t*>(pTime);
     *pData++ = 0;
-    *pData++ = 0;
+    *pData++ = request ? NULL_MESSAGE_REQUEST : 0;
 
     // Find the system id for the destination MPI rank
     uint32_t nodeSysId = bundle->GetSystemId();
 
-    MPI_Isend(reinterpret_cast<void*>(iter->GetBuffer()),
+    MPI_Isend(reinterpret_cast<void*>(buffer),
               bufferSize,
               MPI_CHAR,
               nodeSysId,
               0,
               g_communicator,
-              (iter->GetRequest()));
+              g_pendingTx.GetRequest(slot));
+    SyncTelemetry::RecordTx(nodeSysId, bufferSize);
+    SyncTelemetry::RecordNullTx();
+    if (request)
+    {
+        SyncTelemetry::RecordNullRequest();
+    }
+    bundle->SetSentGuaranteeTime(guarantee_update);
 }
 
 void
@@ -373,27 +287,35 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
     do
     {
         int messageReceived = 0;
-        int index = 0;
+        MPI_Message message;
         MPI_Status status;
 
+        // Only neighbors send to this task, so probing any source matches
+        // the neighbor messages without scanning one request per neighbor.
         if (blocking)
         {
-            MPI_Waitany(g_numNeighbors, g_requests, &index, &status);
-            messageReceived = 1; /* Wait always implies message was received */
+            MPI_Mprobe(MPI_ANY_SOURCE, 0, g_communicator, &message, &status);
+            messageReceived = 1; /* Probe always implies message was received */
             stop = true;
         }
         else
         {
-            MPI_Testany(g_numNeighbors, g_requests, &index, &messageReceived, &status);
+            MPI_Improbe(MPI_ANY_SOURCE, 0, g_communicator, &messageReceived, &message, &status);
         }
 
         if (messageReceived)
         {
             int count;
             MPI_Get_count(&status, MPI_CHAR, &count);
+            if (g_rxBuffer.size() < static_cast<std::size_t>(count))
+            {
+                g_rxBuffer.resize(count);
+            }
+            MPI_Mrecv(g_rxBuffer.data(), count, MPI_CHAR, &message, MPI_STATUS_IGNORE);
+            SyncTelemetry::RecordRx(status.MPI_SOURCE, count);
 
             // Get the meta data first
-            auto pTime = reinterpret_cast<uint64_t*>(g_pRxBuffers[index]);
+            auto pTime = reinterpret_cast<uint64_t*>(g_rxBuffer.data());
             uint64_t time = *pTime++;
             uint64_t guaranteeUpdate = *pTime++;
 
@@ -408,7 +330,8 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
             {
                 count -= sizeof(time) + sizeof(guaranteeUpdate) + sizeof(node) + sizeof(dev);
 
-                Ptr<Packet> p = Create<Packet>(reinterpret_cast<uint8_t*>(pData), count, true);
+                Ptr<Packet> p =
+                    RemotePacketCodec::Deserialize(reinterpret_cast<uint8_t*>(pData), count);
 
                 // Find the correct node/device to schedule receive event
                 Ptr<Node> pNode = NodeList::GetNode(node);
@@ -432,6 +355,10 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
                                                pMpiRec,
                                                p);
             }
+            else
+            {
+                SyncTelemetry::RecordNullRx();
+            }
 
             // Update guarantee time for both packet receives and Null Messages.
             Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(status.MPI_SOURCE);
@@ -439,18 +366,22 @@ NullMessageMpiInterface::ReceiveMessages(bool blocking)
 
             bundle->SetGuaranteeTime(Time(guaranteeUpdate));
 
-            // Re-queue the next read
-            MPI_Irecv(g_pRxBuffers[index],
-                      NULL_MESSAGE_MAX_MPI_MSG_SIZE,
-                      MPI_CHAR,
-                      status.MPI_SOURCE,
-                      0,
-                      g_communicator,
-                      &g_requests[index]);
+            if (rxTime == Time(0) && dev == NULL_MESSAGE_REQUEST)
+            {
+                NullMessageSimulatorImpl::GetInstance()->HandleNullMessageRequest(bundle);
+            }
+            else
+            {
+                // A request of the remote task does not answer the request
+                // of this task, which will get its own reply: clearing the
+                // request there would send a new request for every one
+                // received while both tasks are blocked.
+                bundle->ClearRequestPending();
+            }
         }
         else
         {
-            // if non-blocking and no message received in testany then stop message loop
+            // if non-blocking and no message received in probe then stop message loop
             stop = true;
         }
     } while (!stop);
@@ -463,19 +394,7 @@ NullMessageMpiInterface::TestSendComplete()
 
     NS_ASSERT(g_enabled);
 
-    auto iter = g_pendingTx.begin();
-    while (iter != g_pendingTx.end())
-    {
-        MPI_Status status;
-        int flag = 0;
-        MPI_Test(iter->GetRequest(), &flag, &status);
-        auto current = iter; // Save current for erasing
-        ++iter;              // Advance to next
-        if (flag)
-        { // This message is complete
-            g_pendingTx.erase(current);
-        }
-    }
+    g_pendingTx.TestComplete();
 }
 
 void
@@ -485,26 +404,10 @@ NullMessageMpiInterface::Disable()
 
     if (g_enabled)
     {
-        for (auto iter = g_pendingTx.begin(); iter != g_pendingTx.end(); ++iter)
-        {
-            MPI_Cancel(iter->GetRequest());
-            MPI_Request_free(iter->GetRequest());
-        }
-
-        for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-            MPI_Cancel(&g_requests[i]);
-            MPI_Request_free(&g_requests[i]);
-        }
-
-        for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-            delete[] g_pRxBuffers[i];
-        }
-        delete[] g_pRxBuffers;
-        delete[] g_requests;
-
-        g_pendingTx.clear();
+        g_pendingTx.Cancel();
+        g_pendingTx.Clear();
+        g_rxBuffer.clear();
+        g_rxBuffer.shrink_to_fit();
 
         if (g_freeCommunicator)
         {
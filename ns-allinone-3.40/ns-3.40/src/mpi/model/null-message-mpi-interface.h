@@ -27,18 +27,18 @@
 #define NS3_NULLMESSAGE_MPI_INTERFACE_H
 
 #include "parallel-communication-interface.h"
+#include "send-buffer-pool.h"
 
 #include <ns3/buffer.h>
 #include <ns3/nstime.h>
 
-#include <list>
 #include <mpi.h>
+#include <vector>
 
 namespace ns3
 {
 
 class NullMessageSimulatorImpl;
-class NullMessageSentBuffer;
 class RemoteChannelBundle;
 class Packet;
 
@@ -94,12 +94,18 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      *
      * \param [in] bundle The bundle of links between two ranks.
      *
+     * \param [in] request Ask the remote task to reply with a Null
+     * Message right away.
+     *
      * \internal The Null Message MPI buffer format uses the same packet
      * metadata format as sending a normal packet with the time,
      * destination node, and destination device set to zero.  Using the
-     * same packet metadata simplifies receive logic.
+     * same packet metadata simplifies receive logic.  A request sets the
+     * destination device to one.
      */
-    static void SendNullMessage(const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+    static void SendNullMessage(const Time& guaranteeUpdate,
+                                Ptr<RemoteChannelBundle> bundle,
+                                bool request = false);
     /**
      * Non-blocking check for received messages complete.  Will
      * receive all messages that are queued up locally.
@@ -119,7 +125,8 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      * \brief Initialize send and receive buffers.
      *
      * This method should be called after all links have been added to the RemoteChannelBundle
-     * manager to setup any required send and receive buffers.
+     * manager to setup any required send and receive buffers.  Receives are
+     * probe driven, so only the number of neighbors is recorded here.
      */
     static void InitializeSendReceiveBuffers();
 
@@ -152,14 +159,14 @@ class NullMessageMpiInterface : public ParallelCommunicationInterface, Object
      */
     static bool g_mpiInitCalled;
 
-    /** Pending non-blocking receives. */
-    static MPI_Request* g_requests;
-
-    /** Data buffers for non-blocking receives. */
-    static char** g_pRxBuffers;
+    /**
+     * Reusable receive buffer.  Messages are probed before they are
+     * received, the buffer grows to the largest message seen.
+     */
+    static std::vector<uint8_t> g_rxBuffer;
 
-    /** List of pending non-blocking sends. */
-    static std::list<NullMessageSentBuffer> g_pendingTx;
+    /** Buffers of the pending non-blocking sends. */
+    static SendBufferPool g_pendingTx;
 
     /** MPI communicator being used for ns-3 tasks. */
     static MPI_Comm g_communicator;
@@ -29,18 +29,20 @@
 #include "null-message-mpi-interface.h"
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
+#include "sync-telemetry.h"
 
 #include <ns3/assert.h>
-#include <ns3/channel.h>
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/event-impl.h>
 #include <ns3/log.h>
-#include <ns3/node-container.h>
 #include <ns3/pointer.h>
 #include <ns3/ptr.h>
 #include <ns3/scheduler.h>
 #include <ns3/simulator.h>
+#include <ns3/string.h>
 
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -67,7 +69,25 @@ NullMessageSimulatorImpl::GetTypeId()
                           "Null Message scheduler tuning parameter",
                           DoubleValue(1.0),
                           MakeDoubleAccessor(&NullMessageSimulatorImpl::m_schedulerTune),
-                          MakeDoubleChecker<double>(0.01, 1.0));
+                          MakeDoubleChecker<double>(0.01, 1.0))
+            .AddAttribute("DemandDriven",
+                          "Only send Null Messages in reply to a neighbor task which is "
+                          "blocked waiting for this one, instead of periodically",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NullMessageSimulatorImpl::m_demandDriven),
+                          MakeBooleanChecker())
+            .AddAttribute("NodeCostFile",
+                          "Record the number of events and the wall time of each node, "
+                          "and write them to this file at Destroy; empty to disable",
+                          StringValue(""),
+                          MakeStringAccessor(&NullMessageSimulatorImpl::m_nodeCostFile),
+                          MakeStringChecker())
+            .AddAttribute("TelemetryFile",
+                          "Write the synchronization counters of each rank to "
+                          "<TelemetryFile>-<rank>.csv at Destroy; empty to disable",
+                          StringValue(""),
+                          MakeStringAccessor(&NullMessageSimulatorImpl::m_telemetryFile),
+                          MakeStringChecker());
     return tid;
 }
 
@@ -88,6 +108,10 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl()
     m_events = nullptr;
 
     m_safeTime = Seconds(0);
+    m_roundEventCount = 0;
+    m_demandDriven = false;
+
+    SyncTelemetry::Reset(m_systemCount);
 
     NS_ASSERT(g_instance == nullptr);
     g_instance = this;
@@ -129,6 +153,15 @@ NullMessageSimulatorImpl::Destroy()
     }
 
     RemoteChannelBundleManager::Destroy();
+    if (!m_nodeCostFile.empty())
+    {
+        m_nodeCosts.Write(m_nodeCostFile);
+    }
+    if (!m_telemetryFile.empty())
+    {
+        SyncTelemetry::Write(m_telemetryFile, m_myId);
+    }
+
     MpiInterface::Destroy();
 }
 
@@ -139,62 +172,7 @@ NullMessageSimulatorImpl::CalculateLookAhead()
 
     if (MpiInterface::GetSize() > 1)
     {
-        NodeContainer c = NodeContainer::GetGlobal();
-        for (auto iter = c.Begin(); iter != c.End(); ++iter)
-        {
-            if ((*iter)->GetSystemId() != MpiInterface::GetSystemId())
-            {
-                continue;
-            }
-
-            for (uint32_t i = 0; i < (*iter)->GetNDevices(); ++i)
-            {
-                Ptr<NetDevice> localNetDevice = (*iter)->GetDevice(i);
-                // only works for p2p links currently
-                if (!localNetDevice->IsPointToPoint())
-                {
-                    continue;
-                }
-                Ptr<Channel> channel = localNetDevice->GetChannel();
-                if (!channel)
-                {
-                    continue;
-                }
-
-                // grab the adjacent node
-                Ptr<Node> remoteNode;
-                if (channel->GetDevice(0) == localNetDevice)
-                {
-                    remoteNode = (channel->GetDevice(1))->GetNode();
-                }
-                else
-                {
-                    remoteNode = (channel->GetDevice(0))->GetNode();
-                }
-
-                // if it's not remote, don't consider it
-                if (remoteNode->GetSystemId() == MpiInterface::GetSystemId())
-                {
-                    continue;
-                }
-
-                /**
-                 * Add this channel to the remote channel bundle from this task to MPI task on other
-                 * side of the channel.
-                 */
-                Ptr<RemoteChannelBundle> remoteChannelBundle =
-                    RemoteChannelBundleManager::Find(remoteNode->GetSystemId());
-                if (!remoteChannelBundle)
-                {
-                    remoteChannelBundle =
-                        RemoteChannelBundleManager::Add(remoteNode->GetSystemId());
-                }
-
-                TimeValue delay;
-                channel->GetAttribute("Delay", delay);
-                remoteChannelBundle->AddChannel(channel, delay.Get());
-            }
-        }
+        RemoteChannelBundleManager::AddRemoteChannels();
     }
 
     // Completed setup of remote channel bundles.  Setup send and receive buffers.
@@ -217,6 +195,10 @@ NullMessageSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
         {
             Scheduler::Event next = m_events->RemoveNext();
             scheduler->Insert(next);
+            if (next.impl->IsCancelled())
+            {
+                scheduler->NotifyCancel();
+            }
         }
     }
     m_events = scheduler;
@@ -239,7 +221,22 @@ NullMessageSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (next.impl->IsCancelled())
+    {
+        m_events->NotifyCancelledRemoved();
+    }
+    if (m_nodeCostFile.empty())
+    {
+        next.impl->Invoke();
+    }
+    else
+    {
+        auto start = std::chrono::steady_clock::now();
+        next.impl->Invoke();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        m_nodeCosts.Record(next.key.m_context,
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
     next.impl->Unref();
 }
 
@@ -265,6 +262,13 @@ NullMessageSimulatorImpl::ScheduleNullMessageEvent(Ptr<RemoteChannelBundle> bund
 {
     NS_LOG_FUNCTION(this << bundle);
 
+    if (m_demandDriven)
+    {
+        // The periodic events are only counted
+        bundle->SetPeriodStart(Now());
+        return;
+    }
+
     Time delay(m_schedulerTune * bundle->GetDelay().GetTimeStep());
 
     bundle->SetEventId(Simulator::Schedule(delay,
@@ -278,6 +282,12 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent(Ptr<RemoteChannelBundle> bu
 {
     NS_LOG_FUNCTION(this << bundle);
 
+    if (m_demandDriven)
+    {
+        CountAvoidedNullMessages(bundle);
+        return;
+    }
+
     Simulator::Cancel(bundle->GetEventId());
 
     Time delay(m_schedulerTune * bundle->GetDelay().GetTimeStep());
@@ -299,11 +309,28 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent(uint32_t nodeSysId)
     RescheduleNullMessageEvent(bundle);
 }
 
+void
+NullMessageSimulatorImpl::CountAvoidedNullMessages(Ptr<RemoteChannelBundle> bundle)
+{
+    NS_LOG_FUNCTION(this << bundle);
+
+    // The periodic event runs every period until a packet sent on the
+    // bundle reschedules it.
+    Time period(m_schedulerTune * bundle->GetDelay().GetTimeStep());
+    if (period.IsStrictlyPositive())
+    {
+        SyncTelemetry::RecordNullAvoided((Now() - bundle->GetPeriodStart()).GetTimeStep() /
+                                         period.GetTimeStep());
+    }
+    bundle->SetPeriodStart(Now());
+}
+
 void
 NullMessageSimulatorImpl::Run()
 {
     NS_LOG_FUNCTION(this);
 
+    SyncTelemetry::Clock::time_point runStart = SyncTelemetry::Clock::now();
     CalculateLookAhead();
 
     RemoteChannelBundleManager::InitializeNullMessageEvents();
@@ -325,6 +352,15 @@ NullMessageSimulatorImpl::Run()
             HandleArrivingMessagesBlocking();
         }
     }
+
+    if (m_demandDriven)
+    {
+        RemoteChannelBundleManager::CountAvoidedNullMessages();
+        // Nothing more will be sent, so neighbors must not wait for this task
+        RemoteChannelBundleManager::SendNullMessages(GetMaximumSimulationTime());
+    }
+
+    SyncTelemetry::RecordRun(runStart);
 }
 
 void
@@ -345,9 +381,19 @@ NullMessageSimulatorImpl::HandleArrivingMessagesBlocking()
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_demandDriven)
+    {
+        RemoteChannelBundleManager::RequestNullMessages(Next());
+    }
+
+    SyncTelemetry::Clock::time_point blockStart = SyncTelemetry::Clock::now();
     NullMessageMpiInterface::ReceiveMessagesBlocking();
+    SyncTelemetry::RecordBlocked(blockStart);
 
+    Time previousSafeTime = m_safeTime;
     CalculateSafeTime();
+    SyncTelemetry::RecordRound(m_safeTime - previousSafeTime, m_eventCount - m_roundEventCount);
+    m_roundEventCount = m_eventCount;
 
     // Check for send completes
     NullMessageMpiInterface::TestSendComplete();
@@ -509,6 +555,10 @@ NullMessageSimulatorImpl::Cancel(const EventId& id)
     if (!IsExpired(id))
     {
         id.PeekEventImpl()->Cancel();
+        if (id.GetUid() != EventId::UID::DESTROY)
+        {
+            m_unscheduledEvents -= NotifyCancel(m_events, m_unscheduledEvents);
+        }
     }
 }
 
@@ -571,11 +621,43 @@ NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bundle)
     NS_LOG_FUNCTION(this << bundle);
 
     Time time = Min(Next(), GetSafeTime()) + bundle->GetDelay();
-    NullMessageMpiInterface::SendNullMessage(time, bundle);
+    // A packet or the previous Null Message may already have carried
+    // this guarantee.
+    if (time > bundle->GetSentGuaranteeTime())
+    {
+        NullMessageMpiInterface::SendNullMessage(time, bundle);
+    }
+    else
+    {
+        SyncTelemetry::RecordNullSuppressed();
+    }
 
     ScheduleNullMessageEvent(bundle);
 }
 
+void
+NullMessageSimulatorImpl::HandleNullMessageRequest(Ptr<RemoteChannelBundle> bundle)
+{
+    NS_LOG_FUNCTION(this << bundle);
+
+    // Always reply, the neighbor is blocked until it hears from this task.
+    Time time;
+    if (!m_events->IsEmpty())
+    {
+        time = CalculateGuaranteeTime(bundle->GetSystemId());
+    }
+    else if (GetSafeTime() == GetMaximumSimulationTime())
+    {
+        time = GetMaximumSimulationTime();
+    }
+    else
+    {
+        // Events can only be added by packets arriving after the safe time
+        time = GetSafeTime() + bundle->GetDelay();
+    }
+    NullMessageMpiInterface::SendNullMessage(time, bundle);
+}
+
 NullMessageSimulatorImpl*
 NullMessageSimulatorImpl::GetInstance()
 {
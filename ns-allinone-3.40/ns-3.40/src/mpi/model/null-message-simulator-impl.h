@@ -26,6 +26,8 @@
 #ifndef NULLMESSAGE_SIMULATOR_IMPL_H
 #define NULLMESSAGE_SIMULATOR_IMPL_H
 
+#include "node-cost-profiler.h"
+
 #include <ns3/event-impl.h>
 #include <ns3/ptr.h>
 #include <ns3/scheduler.h>
@@ -160,6 +162,15 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     void RescheduleNullMessageEvent(uint32_t nodeSysId);
 
+    /**
+     * \param bundle Bundle to count the Null Message events of
+     *
+     * In demand-driven mode, count the periodic Null Message events
+     * which would have run for the bundle since it was last scheduled
+     * or rescheduled, and restart the period.
+     */
+    void CountAvoidedNullMessages(Ptr<RemoteChannelBundle> bundle);
+
     /**
      * \param systemId SystemID to compute guarantee time for
      *
@@ -171,6 +182,14 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     Time CalculateGuaranteeTime(uint32_t systemId);
 
+    /**
+     * \param bundle Bundle the request arrived on
+     *
+     * Reply to a Null Message request from the task at the other end
+     * of the bundle with the current guarantee time.
+     */
+    void HandleNullMessageRequest(Ptr<RemoteChannelBundle> bundle);
+
     /**
      * \param bundle remote channel bundle to schedule an event for.
      *
@@ -227,6 +246,22 @@ class NullMessageSimulatorImpl : public SimulatorImpl
      */
     double m_schedulerTune;
 
+    /**
+     * Send Null Messages only when a neighbor task requests one because
+     * it is blocked, rather than periodically.  A blocked task sends a
+     * request to each neighbor whose guarantee time holds it back.
+     */
+    bool m_demandDriven;
+
+    /** File to write the cost of each node to at Destroy; empty to disable. */
+    std::string m_nodeCostFile;
+    /** Event count and wall time of each node. */
+    NodeCostProfiler m_nodeCosts;
+    /** Prefix of the files to write the synchronization counters to; empty to disable. */
+    std::string m_telemetryFile;
+    /** Event count at the end of the previous blocking wait. */
+    uint64_t m_roundEventCount;
+
     /** Singleton instance. */
     static NullMessageSimulatorImpl* g_instance;
 };
@@ -26,9 +26,12 @@
 
 #include "remote-channel-bundle-manager.h"
 
+#include "mpi-interface.h"
 #include "null-message-simulator-impl.h"
 #include "remote-channel-bundle.h"
 
+#include "ns3/channel.h"
+#include "ns3/node-container.h"
 #include "ns3/simulator.h"
 
 namespace ns3
@@ -66,6 +69,67 @@ RemoteChannelBundleManager::Add(uint32_t systemId)
     return remoteChannelBundle;
 }
 
+void
+RemoteChannelBundleManager::AddRemoteChannels()
+{
+    NS_ASSERT(!g_initialized);
+
+    NodeContainer c = NodeContainer::GetGlobal();
+    for (auto iter = c.Begin(); iter != c.End(); ++iter)
+    {
+        if ((*iter)->GetSystemId() != MpiInterface::GetSystemId())
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < (*iter)->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> localNetDevice = (*iter)->GetDevice(i);
+            // only works for p2p links currently
+            if (!localNetDevice->IsPointToPoint())
+            {
+                continue;
+            }
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+
+            // grab the adjacent node
+            Ptr<Node> remoteNode;
+            if (channel->GetDevice(0) == localNetDevice)
+            {
+                remoteNode = (channel->GetDevice(1))->GetNode();
+            }
+            else
+            {
+                remoteNode = (channel->GetDevice(0))->GetNode();
+            }
+
+            // if it's not remote, don't consider it
+            if (remoteNode->GetSystemId() == MpiInterface::GetSystemId())
+            {
+                continue;
+            }
+
+            /**
+             * Add this channel to the remote channel bundle from this task to MPI task on other
+             * side of the channel.
+             */
+            Ptr<RemoteChannelBundle> remoteChannelBundle = Find(remoteNode->GetSystemId());
+            if (!remoteChannelBundle)
+            {
+                remoteChannelBundle = Add(remoteNode->GetSystemId());
+            }
+
+            TimeValue delay;
+            channel->GetAttribute("Delay", delay);
+            remoteChannelBundle->AddChannel(channel, delay.Get());
+        }
+    }
+}
+
 std::size_t
 RemoteChannelBundleManager::Size()
 {
@@ -104,10 +168,46 @@ RemoteChannelBundleManager::GetSafeTime()
 }
 
 void
-RemoteChannelBundleManager::Destroy()
+RemoteChannelBundleManager::RequestNullMessages(Time time)
+{
+    NS_ASSERT(g_initialized);
+
+    for (auto kv = g_remoteChannelBundles.begin(); kv != g_remoteChannelBundles.end(); ++kv)
+    {
+        Ptr<RemoteChannelBundle> bundle = kv->second;
+        if (bundle->GetGuaranteeTime() < time && !bundle->IsRequestPending())
+        {
+            bundle->Request(
+                NullMessageSimulatorImpl::GetInstance()->CalculateGuaranteeTime(kv->first));
+        }
+    }
+}
+
+void
+RemoteChannelBundleManager::SendNullMessages(Time time)
 {
     NS_ASSERT(g_initialized);
 
+    for (auto kv = g_remoteChannelBundles.begin(); kv != g_remoteChannelBundles.end(); ++kv)
+    {
+        kv->second->Send(time);
+    }
+}
+
+void
+RemoteChannelBundleManager::CountAvoidedNullMessages()
+{
+    NS_ASSERT(g_initialized);
+
+    for (auto kv = g_remoteChannelBundles.begin(); kv != g_remoteChannelBundles.end(); ++kv)
+    {
+        NullMessageSimulatorImpl::GetInstance()->CountAvoidedNullMessages(kv->second);
+    }
+}
+
+void
+RemoteChannelBundleManager::Destroy()
+{
     g_remoteChannelBundles.clear();
     g_initialized = false;
 }
@@ -65,6 +65,14 @@ class RemoteChannelBundleManager
      */
     static Ptr<RemoteChannelBundle> Add(uint32_t systemId);
 
+    /**
+     * Add every point-to-point channel from a node on this task to a
+     * node on another task to the bundle for that task, creating the
+     * bundles as needed.
+     * Can not be invoked after InitializeNullMessageEvents has been invoked.
+     */
+    static void AddRemoteChannels();
+
     /**
      * Get the number of ns-3 channels in this bundle
      * \return The number of channels.
@@ -83,6 +91,27 @@ class RemoteChannelBundleManager
      */
     static Time GetSafeTime();
 
+    /**
+     * Send a Null Message request to every bundle whose guarantee time
+     * is before a time and which has no request pending.
+     *
+     * \param [in] time The time of the next event which can't be executed.
+     */
+    static void RequestNullMessages(Time time);
+
+    /**
+     * Send a Null Message with the same guarantee time to every bundle.
+     *
+     * \param [in] time The guarantee time.
+     */
+    static void SendNullMessages(Time time);
+
+    /**
+     * Count the periodic Null Message events of every bundle which the
+     * demand-driven mode did not run up to now.
+     */
+    static void CountAvoidedNullMessages();
+
     /** Destroy the singleton. */
     static void Destroy();
 
@@ -47,6 +47,9 @@ RemoteChannelBundle::GetTypeId()
 RemoteChannelBundle::RemoteChannelBundle()
     : m_remoteSystemId(UINT32_MAX),
       m_guaranteeTime(0),
+      m_sentGuaranteeTime(0),
+      m_requestPending(false),
+      m_periodStart(0),
       m_delay(Time::Max())
 {
 }
@@ -54,6 +57,9 @@ RemoteChannelBundle::RemoteChannelBundle()
 RemoteChannelBundle::RemoteChannelBundle(const uint32_t remoteSystemId)
     : m_remoteSystemId(remoteSystemId),
       m_guaranteeTime(0),
+      m_sentGuaranteeTime(0),
+      m_requestPending(false),
+      m_periodStart(0),
       m_delay(Time::Max())
 {
 }
@@ -85,6 +91,42 @@ RemoteChannelBundle::SetGuaranteeTime(Time time)
     m_guaranteeTime = time;
 }
 
+Time
+RemoteChannelBundle::GetSentGuaranteeTime() const
+{
+    return m_sentGuaranteeTime;
+}
+
+void
+RemoteChannelBundle::SetSentGuaranteeTime(Time time)
+{
+    m_sentGuaranteeTime = time;
+}
+
+bool
+RemoteChannelBundle::IsRequestPending() const
+{
+    return m_requestPending;
+}
+
+void
+RemoteChannelBundle::ClearRequestPending()
+{
+    m_requestPending = false;
+}
+
+Time
+RemoteChannelBundle::GetPeriodStart() const
+{
+    return m_periodStart;
+}
+
+void
+RemoteChannelBundle::SetPeriodStart(Time time)
+{
+    m_periodStart = time;
+}
+
 Time
 RemoteChannelBundle::GetDelay() const
 {
@@ -115,6 +157,13 @@ RemoteChannelBundle::Send(Time time)
     NullMessageMpiInterface::SendNullMessage(time, this);
 }
 
+void
+RemoteChannelBundle::Request(Time time)
+{
+    NullMessageMpiInterface::SendNullMessage(time, this, true);
+    m_requestPending = true;
+}
+
 std::ostream&
 operator<<(std::ostream& out, ns3::RemoteChannelBundle& bundle)
 {
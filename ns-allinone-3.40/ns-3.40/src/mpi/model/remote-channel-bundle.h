@@ -98,6 +98,49 @@ class RemoteChannelBundle : public Object
      */
     void SetGuaranteeTime(Time time);
 
+    /**
+     * Get the last guarantee time sent to the remote task, either in
+     * a packet or in a Null Message.
+     * \return The last guarantee time sent.
+     */
+    Time GetSentGuaranteeTime() const;
+
+    /**
+     * Set the last guarantee time sent to the remote task.
+     *
+     * \param time The guarantee time.
+     */
+    void SetSentGuaranteeTime(Time time);
+
+    /**
+     * Is a Null Message request to the remote task unanswered.
+     * \return \c true if a request was sent and neither a packet nor
+     * a Null Message other than a request was received since.
+     */
+    bool IsRequestPending() const;
+
+    /**
+     * Mark the Null Message request to the remote task as answered.
+     * This should be called after a packet or a Null Message which is
+     * not itself a request is received.
+     */
+    void ClearRequestPending();
+
+    /**
+     * Get when the periodic Null Message event of this bundle was last
+     * scheduled, or would have been in demand-driven mode.
+     * \return The time.
+     */
+    Time GetPeriodStart() const;
+
+    /**
+     * Set when the periodic Null Message event of this bundle was last
+     * scheduled, or would have been in demand-driven mode.
+     *
+     * \param time The time.
+     */
+    void SetPeriodStart(Time time);
+
     /**
      * Get the minimum delay along any channel in this bundle
      * \return The minimum delay.
@@ -133,6 +176,14 @@ class RemoteChannelBundle : public Object
      */
     void Send(Time time);
 
+    /**
+     * Send a Null Message to the remote task which also asks it to
+     * reply with a Null Message right away.
+     *
+     * \param time The guarantee time of this task.
+     */
+    void Request(Time time);
+
     /**
      * Output for debugging purposes.
      *
@@ -161,6 +212,15 @@ class RemoteChannelBundle : public Object
      */
     Time m_guaranteeTime;
 
+    /** Last guarantee time sent to the remote task. */
+    Time m_sentGuaranteeTime;
+
+    /** A Null Message request is unanswered. */
+    bool m_requestPending;
+
+    /** When the periodic Null Message event was last scheduled. */
+    Time m_periodStart;
+
     /**
      * Delay for this Channel bundle, which is
      * the min link delay over all incoming channels;
@@ -0,0 +1,430 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::RemotePacketCodec.
+ */
+
+#include "remote-packet-codec.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/nix-vector.h"
+#include "ns3/packet.h"
+#include "ns3/tag.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RemotePacketCodec");
+
+/** Flag of a compact packet encoded with Packet::Serialize(). */
+const uint8_t CODEC_FULL = 0x01;
+/** Flag of a compact packet followed by its nix-vector. */
+const uint8_t CODEC_NIX_VECTOR = 0x02;
+/** Flag of a compact packet followed by its tags. */
+const uint8_t CODEC_TAGS = 0x04;
+
+/** Largest size of a 32 bit variable length integer. */
+const uint32_t MAX_VARINT32_SIZE = 5;
+
+/** Size of the fixed receive time, node and device prefix. */
+const uint32_t FIXED_HEADER_SIZE = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+bool RemotePacketCodec::g_compact = false;
+bool RemotePacketCodec::g_metadata = false;
+std::vector<TypeId> RemotePacketCodec::g_tagTypes;
+std::vector<Tag*> RemotePacketCodec::g_tags;
+std::vector<uint8_t> RemotePacketCodec::g_staging;
+
+/**
+ * \param [in] value An integer.
+ * \return The size of its variable length encoding, 7 bits per byte.
+ */
+static uint32_t
+GetVarintSize(uint64_t value)
+{
+    uint32_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/**
+ * Write a variable length integer, 7 bits per byte, least significant
+ * bits first, with the high bit set on all bytes but the last.
+ *
+ * \param [in,out] buffer The storage, advanced past the integer.
+ * \param [in] value The integer.
+ */
+static void
+WriteVarint(uint8_t*& buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *buffer++ = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    *buffer++ = static_cast<uint8_t>(value);
+}
+
+/**
+ * Read a variable length integer written by WriteVarint().
+ *
+ * \param [in,out] buffer The storage, advanced past the integer.
+ * \return The integer.
+ */
+static uint64_t
+ReadVarint(const uint8_t*& buffer)
+{
+    uint64_t value = 0;
+    uint32_t shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = *buffer++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+void
+RemotePacketCodec::SetCompact(bool compact)
+{
+    NS_LOG_FUNCTION(compact);
+
+    g_compact = compact;
+}
+
+bool
+RemotePacketCodec::IsCompact()
+{
+    return g_compact;
+}
+
+void
+RemotePacketCodec::SetMetadata(bool metadata)
+{
+    NS_LOG_FUNCTION(metadata);
+
+    g_metadata = metadata;
+}
+
+void
+RemotePacketCodec::CarryTag(TypeId tid)
+{
+    NS_LOG_FUNCTION(tid.GetName());
+
+    if (FindTag(tid) < g_tagTypes.size())
+    {
+        return;
+    }
+    NS_ABORT_MSG_UNLESS(tid.HasConstructor(), "Tag " << tid.GetName() << " has no constructor");
+    auto tag = dynamic_cast<Tag*>(tid.GetConstructor()());
+    NS_ABORT_MSG_UNLESS(tag, tid.GetName() << " is not a Tag");
+    g_tagTypes.push_back(tid);
+    g_tags.push_back(tag);
+}
+
+void
+RemotePacketCodec::ClearTags()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    for (auto tag : g_tags)
+    {
+        delete tag;
+    }
+    g_tags.clear();
+    g_tagTypes.clear();
+}
+
+uint32_t
+RemotePacketCodec::FindTag(TypeId tid)
+{
+    uint32_t index = 0;
+    while (index < g_tagTypes.size() && g_tagTypes[index] != tid)
+    {
+        index++;
+    }
+    return index;
+}
+
+uint32_t
+RemotePacketCodec::GetHeaderSize(uint64_t time, uint32_t node, uint32_t dev)
+{
+    if (!g_compact)
+    {
+        return FIXED_HEADER_SIZE;
+    }
+    return GetVarintSize(time) + GetVarintSize(node) + GetVarintSize(dev);
+}
+
+uint8_t*
+RemotePacketCodec::SerializeHeader(uint8_t* buffer, uint64_t time, uint32_t node, uint32_t dev)
+{
+    if (!g_compact)
+    {
+        std::memcpy(buffer, &time, sizeof(time));
+        buffer += sizeof(time);
+        std::memcpy(buffer, &node, sizeof(node));
+        buffer += sizeof(node);
+        std::memcpy(buffer, &dev, sizeof(dev));
+        return buffer + sizeof(dev);
+    }
+    WriteVarint(buffer, time);
+    WriteVarint(buffer, node);
+    WriteVarint(buffer, dev);
+    return buffer;
+}
+
+const uint8_t*
+RemotePacketCodec::DeserializeHeader(const uint8_t* buffer,
+                                     uint64_t* time,
+                                     uint32_t* node,
+                                     uint32_t* dev)
+{
+    if (!g_compact)
+    {
+        std::memcpy(time, buffer, sizeof(*time));
+        buffer += sizeof(*time);
+        std::memcpy(node, buffer, sizeof(*node));
+        buffer += sizeof(*node);
+        std::memcpy(dev, buffer, sizeof(*dev));
+        return buffer + sizeof(*dev);
+    }
+    *time = ReadVarint(buffer);
+    *node = static_cast<uint32_t>(ReadVarint(buffer));
+    *dev = static_cast<uint32_t>(ReadVarint(buffer));
+    return buffer;
+}
+
+uint32_t
+RemotePacketCodec::GetSerializedSize(Ptr<const Packet> p)
+{
+    if (!g_compact)
+    {
+        return p->GetSerializedSize();
+    }
+    if (g_metadata)
+    {
+        uint32_t size = p->GetSerializedSize();
+        g_staging.resize(1 + size);
+        g_staging[0] = CODEC_FULL;
+        p->Serialize(g_staging.data() + 1, size);
+        return g_staging.size();
+    }
+
+    // Flags and payload.  The packet bytes are copied in full, and the
+    // zeros at their end, usually the payload of an application which
+    // did not fill it, are then replaced by their count.
+    uint32_t payloadSize = p->GetSize();
+    uint32_t maxSize = 1 + 2 * GetVarintSize(payloadSize) + payloadSize;
+    g_staging.resize(maxSize);
+    uint8_t* data = g_staging.data() + 1 + GetVarintSize(payloadSize);
+    p->CopyData(data, payloadSize);
+    uint32_t dataSize = payloadSize;
+    while (dataSize > 0 && data[dataSize - 1] == 0)
+    {
+        dataSize--;
+    }
+    uint8_t* buffer = g_staging.data();
+    uint8_t* flags = buffer++;
+    *flags = 0;
+    WriteVarint(buffer, dataSize);
+    // The size may take fewer bytes than reserved for the payload size
+    std::memmove(buffer, data, dataSize);
+    buffer += dataSize;
+    WriteVarint(buffer, payloadSize - dataSize);
+    g_staging.resize(buffer - g_staging.data());
+
+    Ptr<NixVector> nixVector = p->GetNixVector();
+    if (nixVector)
+    {
+        // NixVector serializes to words, the staging may not be aligned
+        uint32_t nixSize = nixVector->GetSerializedSize();
+        std::vector<uint32_t> words(nixSize / sizeof(uint32_t));
+        nixVector->Serialize(words.data(), nixSize);
+        std::size_t offset = g_staging.size();
+        g_staging.resize(offset + GetVarintSize(nixSize) + nixSize);
+        buffer = g_staging.data() + offset;
+        WriteVarint(buffer, nixSize);
+        std::memcpy(buffer, words.data(), nixSize);
+        g_staging[0] |= CODEC_NIX_VECTOR;
+    }
+    if (g_tagTypes.empty())
+    {
+        return g_staging.size();
+    }
+
+    // Each tag: its index and kind, its byte range, its size and data
+    std::size_t countOffset = g_staging.size();
+    uint32_t count = 0;
+    ByteTagIterator byteTags = p->GetByteTagIterator();
+    while (byteTags.HasNext())
+    {
+        ByteTagIterator::Item item = byteTags.Next();
+        uint32_t index = FindTag(item.GetTypeId());
+        if (index < g_tags.size())
+        {
+            Tag* tag = g_tags[index];
+            item.GetTag(*tag);
+            WriteTag(tag, 2 * index + 1, item.GetStart(), item.GetEnd());
+            count++;
+        }
+    }
+    PacketTagIterator packetTags = p->GetPacketTagIterator();
+    while (packetTags.HasNext())
+    {
+        PacketTagIterator::Item item = packetTags.Next();
+        uint32_t index = FindTag(item.GetTypeId());
+        if (index < g_tags.size())
+        {
+            Tag* tag = g_tags[index];
+            item.GetTag(*tag);
+            WriteTag(tag, 2 * index, 0, 0);
+            count++;
+        }
+    }
+    if (count > 0)
+    {
+        // Insert the tag count before the tags
+        uint8_t varint[MAX_VARINT32_SIZE];
+        uint8_t* end = varint;
+        WriteVarint(end, count);
+        g_staging.insert(g_staging.begin() + countOffset, varint, end);
+        g_staging[0] |= CODEC_TAGS;
+    }
+    return g_staging.size();
+}
+
+void
+RemotePacketCodec::WriteTag(Tag* tag, uint32_t key, uint32_t start, uint32_t end)
+{
+    uint32_t tagSize = tag->GetSerializedSize();
+    std::size_t offset = g_staging.size();
+    // Key, byte range and size
+    g_staging.resize(offset + 4 * MAX_VARINT32_SIZE + tagSize);
+    uint8_t* buffer = g_staging.data() + offset;
+    WriteVarint(buffer, key);
+    if (key % 2)
+    {
+        WriteVarint(buffer, start);
+        WriteVarint(buffer, end);
+    }
+    WriteVarint(buffer, tagSize);
+    tag->Serialize(TagBuffer(buffer, buffer + tagSize));
+    buffer += tagSize;
+    g_staging.resize(buffer - g_staging.data());
+}
+
+void
+RemotePacketCodec::Serialize(Ptr<const Packet> p, uint8_t* buffer, uint32_t size)
+{
+    NS_LOG_FUNCTION(p << size);
+
+    if (!g_compact)
+    {
+        p->Serialize(buffer, size);
+        return;
+    }
+    NS_ASSERT(size == g_staging.size());
+    std::memcpy(buffer, g_staging.data(), size);
+}
+
+Ptr<Packet>
+RemotePacketCodec::Deserialize(const uint8_t* buffer, uint32_t size)
+{
+    NS_LOG_FUNCTION(size);
+
+    if (!g_compact)
+    {
+        return Create<Packet>(buffer, size, true);
+    }
+    const uint8_t* end = buffer + size;
+    uint8_t flags = *buffer++;
+    if (flags & CODEC_FULL)
+    {
+        return Create<Packet>(buffer, end - buffer, true);
+    }
+
+    auto dataSize = static_cast<uint32_t>(ReadVarint(buffer));
+    NS_ASSERT(buffer + dataSize <= end);
+    Ptr<Packet> p = Create<Packet>(buffer, dataSize);
+    buffer += dataSize;
+    auto zeros = static_cast<uint32_t>(ReadVarint(buffer));
+    if (zeros > 0)
+    {
+        // Appending a packet of zeros keeps them as a virtual zero area
+        p->AddAtEnd(Create<Packet>(zeros));
+    }
+
+    if (flags & CODEC_NIX_VECTOR)
+    {
+        auto nixSize = static_cast<uint32_t>(ReadVarint(buffer));
+        std::vector<uint32_t> words(nixSize / sizeof(uint32_t));
+        std::memcpy(words.data(), buffer, nixSize);
+        buffer += nixSize;
+        Ptr<NixVector> nixVector = Create<NixVector>();
+        // As in Packet::Deserialize(), the size includes a length word
+        nixVector->Deserialize(words.data(), nixSize + sizeof(uint32_t));
+        p->SetNixVector(nixVector);
+    }
+
+    if (flags & CODEC_TAGS)
+    {
+        uint64_t count = ReadVarint(buffer);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t key = ReadVarint(buffer);
+            uint64_t index = key / 2;
+            NS_ABORT_MSG_UNLESS(index < g_tags.size(), "Tag " << index << " is not carried");
+            Tag* tag = g_tags[index];
+            uint32_t start = 0;
+            uint32_t stop = 0;
+            if (key % 2)
+            {
+                start = static_cast<uint32_t>(ReadVarint(buffer));
+                stop = static_cast<uint32_t>(ReadVarint(buffer));
+            }
+            auto tagSize = static_cast<uint32_t>(ReadVarint(buffer));
+            // Deserialize only reads the buffer
+            auto data = const_cast<uint8_t*>(buffer);
+            tag->Deserialize(TagBuffer(data, data + tagSize));
+            buffer += tagSize;
+            if (key % 2)
+            {
+                p->AddByteTag(*tag, start, stop);
+            }
+            else
+            {
+                p->AddPacketTag(*tag);
+            }
+        }
+    }
+    NS_ASSERT(buffer == end);
+    return p;
+}
+
+} // namespace ns3
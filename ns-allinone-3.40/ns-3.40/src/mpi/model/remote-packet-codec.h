@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::RemotePacketCodec.
+ */
+
+#ifndef NS3_REMOTE_PACKET_CODEC_H
+#define NS3_REMOTE_PACKET_CODEC_H
+
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class Tag;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Encoding of the packets sent to other ranks.
+ *
+ * A packet sent on a remote point-to-point channel is prefixed by its
+ * receive time, destination node and device.  By default the prefix
+ * takes 16 bytes and the packet is encoded with Packet::Serialize(),
+ * which carries its metadata and all its byte and packet tags.
+ *
+ * The compact encoding writes the prefix as variable length integers
+ * and only carries the packet bytes, with the zeros at their end
+ * replaced by their count, its nix-vector if any, and the tags whose
+ * type was registered with CarryTag().  Tags are identified
+ * by their index in the registry, so all ranks must register the same
+ * tags in the same order.  The metadata can be kept with SetMetadata(),
+ * in which case the packet is encoded with Packet::Serialize() as by
+ * default.
+ *
+ * The encoding must be configured identically on all ranks before
+ * Simulator::Run().  The methods encoding and decoding packets reuse
+ * one instance of each registered tag and must not be called
+ * concurrently.
+ */
+class RemotePacketCodec
+{
+  public:
+    /**
+     * Select the compact encoding.
+     *
+     * \param [in] compact \c true for the compact encoding.
+     */
+    static void SetCompact(bool compact);
+    /**
+     * \return \c true if the compact encoding is selected.
+     */
+    static bool IsCompact();
+    /**
+     * Keep the packet metadata in the compact encoding.
+     *
+     * \param [in] metadata \c true to carry the metadata and all tags.
+     */
+    static void SetMetadata(bool metadata);
+    /**
+     * Carry the tags of a type in the compact encoding.
+     *
+     * \param [in] tid The TypeId of a Tag with a constructor.
+     */
+    static void CarryTag(TypeId tid);
+    /**
+     * Stop carrying tags in the compact encoding.
+     */
+    static void ClearTags();
+
+    /**
+     * \param [in] time The receive time step.
+     * \param [in] node The destination node id.
+     * \param [in] dev The destination device index.
+     * \return The size of the encoded message prefix.
+     */
+    static uint32_t GetHeaderSize(uint64_t time, uint32_t node, uint32_t dev);
+    /**
+     * Encode a message prefix.
+     *
+     * \param [in] buffer The storage of GetHeaderSize() bytes.
+     * \param [in] time The receive time step.
+     * \param [in] node The destination node id.
+     * \param [in] dev The destination device index.
+     * \return The end of the encoded prefix.
+     */
+    static uint8_t* SerializeHeader(uint8_t* buffer, uint64_t time, uint32_t node, uint32_t dev);
+    /**
+     * Decode a message prefix.
+     *
+     * \param [in] buffer The start of the message.
+     * \param [out] time The receive time step.
+     * \param [out] node The destination node id.
+     * \param [out] dev The destination device index.
+     * \return The end of the prefix.
+     */
+    static const uint8_t* DeserializeHeader(const uint8_t* buffer,
+                                            uint64_t* time,
+                                            uint32_t* node,
+                                            uint32_t* dev);
+
+    /**
+     * Get the size of an encoded packet.
+     *
+     * The compact encoding of the packet is prepared by this method and
+     * copied by the next call to Serialize(), which must be for the same
+     * packet.
+     *
+     * \param [in] p A packet.
+     * \return The size of the encoded packet.
+     */
+    static uint32_t GetSerializedSize(Ptr<const Packet> p);
+    /**
+     * Encode the packet passed to the last call to GetSerializedSize().
+     *
+     * \param [in] p The packet.
+     * \param [in] buffer The storage.
+     * \param [in] size The size returned by GetSerializedSize().
+     */
+    static void Serialize(Ptr<const Packet> p, uint8_t* buffer, uint32_t size);
+    /**
+     * Decode a packet.
+     *
+     * \param [in] buffer The encoded packet.
+     * \param [in] size The size of the encoded packet.
+     * \return The packet.
+     */
+    static Ptr<Packet> Deserialize(const uint8_t* buffer, uint32_t size);
+
+  private:
+    /**
+     * \param [in] tid The TypeId of a tag.
+     * \return The index of the tag in the registry, or the registry
+     *         size if the tag is not carried.
+     */
+    static uint32_t FindTag(TypeId tid);
+    /**
+     * Append a tag to the compact encoding being prepared.
+     *
+     * \param [in] tag The tag.
+     * \param [in] key Twice the index of the tag, plus 1 for a byte tag.
+     * \param [in] start The start of the bytes tagged by a byte tag.
+     * \param [in] end The end of the bytes tagged by a byte tag.
+     */
+    static void WriteTag(Tag* tag, uint32_t key, uint32_t start, uint32_t end);
+
+    static bool g_compact;                 //!< Is the compact encoding used.
+    static bool g_metadata;                //!< Is the metadata kept.
+    static std::vector<TypeId> g_tagTypes; //!< The tags carried.
+    static std::vector<Tag*> g_tags;       //!< An instance of each tag carried.
+    static std::vector<uint8_t> g_staging; //!< The compact encoding being prepared.
+};
+
+} // namespace ns3
+
+#endif /* NS3_REMOTE_PACKET_CODEC_H */
@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::SendBufferPool.
+ */
+
+#include "send-buffer-pool.h"
+
+#include "sync-telemetry.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SendBufferPool");
+
+/** Smallest storage allocated for a slot. */
+const uint32_t MIN_SLOT_CAPACITY = 256;
+
+SendBufferPool::SendBufferPool()
+    : m_pending(0)
+{
+}
+
+SendBufferPool::~SendBufferPool()
+{
+}
+
+uint32_t
+SendBufferPool::Allocate(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+
+    uint32_t slot;
+    if (m_free.empty())
+    {
+        slot = m_slots.size();
+        m_slots.push_back({nullptr, 0});
+        m_requests.push_back(MPI_REQUEST_NULL);
+    }
+    else
+    {
+        slot = m_free.back();
+        m_free.pop_back();
+    }
+
+    Slot& s = m_slots[slot];
+    if (s.m_capacity < size)
+    {
+        // Round up to a power of two so a slot settles on the largest
+        // message size after a few sends.
+        uint32_t capacity = MIN_SLOT_CAPACITY;
+        while (capacity < size)
+        {
+            capacity <<= 1;
+        }
+        s.m_data.reset(new uint8_t[capacity]);
+        s.m_capacity = capacity;
+        SyncTelemetry::RecordSendBufferAllocation();
+    }
+    else
+    {
+        SyncTelemetry::RecordSendBufferReuse();
+    }
+    ++m_pending;
+    return slot;
+}
+
+uint8_t*
+SendBufferPool::GetBuffer(uint32_t slot)
+{
+    NS_ASSERT(slot < m_slots.size());
+    return m_slots[slot].m_data.get();
+}
+
+MPI_Request*
+SendBufferPool::GetRequest(uint32_t slot)
+{
+    NS_ASSERT(slot < m_requests.size());
+    return &m_requests[slot];
+}
+
+void
+SendBufferPool::TestComplete()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_pending == 0)
+    {
+        return;
+    }
+
+    m_completed.resize(m_requests.size());
+    int outCount = 0;
+    MPI_Testsome(m_requests.size(),
+                 m_requests.data(),
+                 &outCount,
+                 m_completed.data(),
+                 MPI_STATUSES_IGNORE);
+    if (outCount == MPI_UNDEFINED)
+    {
+        return;
+    }
+    // Completed requests were set to MPI_REQUEST_NULL by MPI_Testsome.
+    for (int i = 0; i < outCount; ++i)
+    {
+        m_free.push_back(m_completed[i]);
+    }
+    m_pending -= outCount;
+}
+
+void
+SendBufferPool::Cancel()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto& request : m_requests)
+    {
+        if (request != MPI_REQUEST_NULL)
+        {
+            MPI_Cancel(&request);
+            MPI_Request_free(&request);
+        }
+    }
+    m_free.clear();
+    for (uint32_t slot = 0; slot < m_slots.size(); ++slot)
+    {
+        m_free.push_back(slot);
+    }
+    m_pending = 0;
+}
+
+void
+SendBufferPool::Clear()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_slots.clear();
+    m_requests.clear();
+    m_free.clear();
+    m_completed.clear();
+    m_pending = 0;
+}
+
+uint32_t
+SendBufferPool::GetPendingCount() const
+{
+    return m_pending;
+}
+
+} // namespace ns3
@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::SendBufferPool.
+ */
+
+#ifndef NS3_SEND_BUFFER_POOL_H
+#define NS3_SEND_BUFFER_POOL_H
+
+#include <memory>
+#include <mpi.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Pool of reusable buffers for non-blocking MPI sends.
+ *
+ * Each send occupies a slot holding the message storage and the MPI
+ * request of the posted send.  The requests are kept in one contiguous
+ * array so all pending sends are tested with a single MPI_Testsome.
+ * Completed slots go back on a free list and keep their storage, so
+ * once the pool has grown to the peak number of sends in flight no
+ * more memory is allocated.  The allocations and reuses are counted by
+ * SyncTelemetry.
+ */
+class SendBufferPool
+{
+  public:
+    SendBufferPool();
+    ~SendBufferPool();
+
+    /**
+     * Get a free slot with room for a message.
+     *
+     * The slot stays in use until the send posted on its request completes.
+     *
+     * \param [in] size The message size in bytes.
+     * \return The slot index.
+     */
+    uint32_t Allocate(uint32_t size);
+    /**
+     * \param [in] slot The slot index.
+     * \return The message storage of the slot.
+     */
+    uint8_t* GetBuffer(uint32_t slot);
+    /**
+     * \param [in] slot The slot index.
+     * \return The MPI request to post the send on.
+     */
+    MPI_Request* GetRequest(uint32_t slot);
+    /**
+     * Test the pending sends and release the slots of completed sends.
+     */
+    void TestComplete();
+    /**
+     * Cancel and free the requests of all pending sends.
+     */
+    void Cancel();
+    /**
+     * Release all slots and their storage.
+     */
+    void Clear();
+
+    /**
+     * \return The number of sends in flight.
+     */
+    uint32_t GetPendingCount() const;
+
+  private:
+    /** Storage of one slot. */
+    struct Slot
+    {
+        std::unique_ptr<uint8_t[]> m_data; //!< Message storage.
+        uint32_t m_capacity;               //!< Size of the storage.
+    };
+
+    /** Storage, indexed by slot. */
+    std::vector<Slot> m_slots;
+    /** Requests of the posted sends, indexed by slot; MPI_REQUEST_NULL when free. */
+    std::vector<MPI_Request> m_requests;
+    /** Indices of the free slots. */
+    std::vector<uint32_t> m_free;
+    /** Completed slot indices returned by MPI_Testsome. */
+    std::vector<int> m_completed;
+    /** Number of sends in flight. */
+    uint32_t m_pending;
+};
+
+} // namespace ns3
+
+#endif /* NS3_SEND_BUFFER_POOL_H */
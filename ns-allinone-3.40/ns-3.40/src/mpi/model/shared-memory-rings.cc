@@ -0,0 +1,285 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::SharedMemoryRings.
+ */
+
+#include "shared-memory-rings.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <cstring>
+#include <new>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SharedMemoryRings");
+
+/** Size of the frame before each message: its size and LBTS round. */
+const uint32_t FRAME_SIZE = 2 * sizeof(uint32_t);
+
+/** Frame size marking the rest of the ring as unused. */
+const uint32_t SKIP_MARKER = 0xffffffff;
+
+/**
+ * Get the room taken by a message in a ring.
+ *
+ * \param [in] size The message size.
+ * \return The size of the framed message, padded to 8 bytes.
+ */
+static uint64_t
+GetRecordSize(uint32_t size)
+{
+    return (FRAME_SIZE + static_cast<uint64_t>(size) + 7) & ~static_cast<uint64_t>(7);
+}
+
+SharedMemoryRings::SharedMemoryRings()
+    : m_window(MPI_WIN_NULL),
+      m_hostCommunicator(MPI_COMM_NULL),
+      m_hostRank(0),
+      m_stride(0),
+      m_capacity(0),
+      m_reservedTail(0),
+      m_current(0),
+      m_currentHead(0),
+      m_nextSource(0),
+      m_full(0)
+{
+}
+
+SharedMemoryRings::~SharedMemoryRings()
+{
+}
+
+void
+SharedMemoryRings::Create(MPI_Comm communicator, uint32_t capacity)
+{
+    NS_LOG_FUNCTION(this << capacity);
+    NS_ASSERT(!IsEnabled());
+
+    MPI_Comm_split_type(communicator,
+                        MPI_COMM_TYPE_SHARED,
+                        0,
+                        MPI_INFO_NULL,
+                        &m_hostCommunicator);
+    int hostRank;
+    int hostSize;
+    int size;
+    MPI_Comm_rank(m_hostCommunicator, &hostRank);
+    MPI_Comm_size(m_hostCommunicator, &hostSize);
+    MPI_Comm_size(communicator, &size);
+    if (hostSize <= 1 || capacity == 0)
+    {
+        MPI_Comm_free(&m_hostCommunicator);
+        return;
+    }
+    m_hostRank = hostRank;
+
+    // Map the ranks of the communicator to the ranks of this host
+    MPI_Group group;
+    MPI_Group hostGroup;
+    MPI_Comm_group(communicator, &group);
+    MPI_Comm_group(m_hostCommunicator, &hostGroup);
+    std::vector<int> hostRanks(hostSize);
+    std::vector<int> ranks(hostSize);
+    for (int i = 0; i < hostSize; ++i)
+    {
+        hostRanks[i] = i;
+    }
+    MPI_Group_translate_ranks(hostGroup, hostSize, hostRanks.data(), group, ranks.data());
+    MPI_Group_free(&group);
+    MPI_Group_free(&hostGroup);
+    m_hostRanks.assign(size, -1);
+    m_ranks.resize(hostSize);
+    for (int i = 0; i < hostSize; ++i)
+    {
+        m_hostRanks[ranks[i]] = i;
+        m_ranks[i] = ranks[i];
+    }
+
+    // Keep the positions of each ring on their own cache lines
+    m_capacity = (static_cast<uint64_t>(capacity) + 63) & ~static_cast<uint64_t>(63);
+    m_stride = sizeof(Ring) + m_capacity;
+
+    // Separate segments can be placed close to the receiver
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+    uint8_t* base;
+    MPI_Win_allocate_shared(hostSize * m_stride,
+                            1,
+                            info,
+                            m_hostCommunicator,
+                            &base,
+                            &m_window);
+    MPI_Info_free(&info);
+
+    m_segments.resize(hostSize);
+    for (int i = 0; i < hostSize; ++i)
+    {
+        MPI_Aint segmentSize;
+        int unit;
+        MPI_Win_shared_query(m_window, i, &segmentSize, &unit, &m_segments[i]);
+    }
+    for (int i = 0; i < hostSize; ++i)
+    {
+        new (GetRing(m_hostRank, i)) Ring{{0}, {0}};
+    }
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window);
+    MPI_Barrier(m_hostCommunicator);
+    NS_LOG_INFO("rings with " << hostSize - 1 << " ranks of this host");
+}
+
+void
+SharedMemoryRings::Free()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!IsEnabled())
+    {
+        return;
+    }
+    NS_LOG_INFO(m_full << " messages did not fit in a ring");
+    MPI_Win_unlock_all(m_window);
+    MPI_Win_free(&m_window);
+    MPI_Comm_free(&m_hostCommunicator);
+    m_hostRanks.clear();
+    m_ranks.clear();
+    m_segments.clear();
+}
+
+bool
+SharedMemoryRings::IsEnabled() const
+{
+    return !m_segments.empty();
+}
+
+bool
+SharedMemoryRings::IsLocal(uint32_t rank) const
+{
+    return rank < m_hostRanks.size() && m_hostRanks[rank] >= 0 &&
+           static_cast<uint32_t>(m_hostRanks[rank]) != m_hostRank;
+}
+
+SharedMemoryRings::Ring*
+SharedMemoryRings::GetRing(uint32_t owner, uint32_t source) const
+{
+    return reinterpret_cast<Ring*>(m_segments[owner] + source * m_stride);
+}
+
+uint8_t*
+SharedMemoryRings::GetData(Ring* ring) const
+{
+    return reinterpret_cast<uint8_t*>(ring) + sizeof(Ring);
+}
+
+uint8_t*
+SharedMemoryRings::Reserve(uint32_t rank, uint32_t size, uint32_t epoch)
+{
+    NS_LOG_FUNCTION(this << rank << size << epoch);
+    NS_ASSERT(IsLocal(rank));
+
+    Ring* ring = GetRing(m_hostRanks[rank], m_hostRank);
+    uint64_t record = GetRecordSize(size);
+    // Only this rank writes the tail
+    uint64_t tail = ring->m_tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->m_head.load(std::memory_order_acquire);
+    uint64_t offset = tail % m_capacity;
+    uint64_t skip = offset + record > m_capacity ? m_capacity - offset : 0;
+    if (record > m_capacity || tail + skip + record - head > m_capacity)
+    {
+        m_full++;
+        return nullptr;
+    }
+
+    uint8_t* data = GetData(ring);
+    if (skip > 0)
+    {
+        std::memcpy(data + offset, &SKIP_MARKER, sizeof(SKIP_MARKER));
+        tail += skip;
+        offset = 0;
+    }
+    std::memcpy(data + offset, &size, sizeof(size));
+    std::memcpy(data + offset + sizeof(size), &epoch, sizeof(epoch));
+    m_reservedTail = tail + record;
+    return data + offset + FRAME_SIZE;
+}
+
+void
+SharedMemoryRings::Commit(uint32_t rank)
+{
+    Ring* ring = GetRing(m_hostRanks[rank], m_hostRank);
+    ring->m_tail.store(m_reservedTail, std::memory_order_release);
+}
+
+const uint8_t*
+SharedMemoryRings::Next(uint32_t* rank, uint32_t* size, uint32_t* epoch)
+{
+    uint32_t hostSize = m_segments.size();
+    for (uint32_t i = 0; i < hostSize; ++i)
+    {
+        uint32_t source = (m_nextSource + i) % hostSize;
+        if (source == m_hostRank)
+        {
+            continue;
+        }
+        Ring* ring = GetRing(m_hostRank, source);
+        // Only this rank writes the head
+        uint64_t head = ring->m_head.load(std::memory_order_relaxed);
+        uint64_t tail = ring->m_tail.load(std::memory_order_acquire);
+        if (head == tail)
+        {
+            continue;
+        }
+
+        uint8_t* data = GetData(ring);
+        uint64_t offset = head % m_capacity;
+        std::memcpy(size, data + offset, sizeof(*size));
+        if (*size == SKIP_MARKER)
+        {
+            // A marker is always followed by a message at the start
+            head += m_capacity - offset;
+            offset = 0;
+            std::memcpy(size, data, sizeof(*size));
+        }
+        std::memcpy(epoch, data + offset + sizeof(*size), sizeof(*epoch));
+        *rank = m_ranks[source];
+        m_current = source;
+        m_currentHead = head + GetRecordSize(*size);
+        m_nextSource = (source + 1) % hostSize;
+        return data + offset + FRAME_SIZE;
+    }
+    return nullptr;
+}
+
+void
+SharedMemoryRings::Release()
+{
+    Ring* ring = GetRing(m_hostRank, m_current);
+    ring->m_head.store(m_currentHead, std::memory_order_release);
+}
+
+uint64_t
+SharedMemoryRings::GetFullCount() const
+{
+    return m_full;
+}
+
+} // namespace ns3
@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::SharedMemoryRings.
+ */
+
+#ifndef NS3_SHARED_MEMORY_RINGS_H
+#define NS3_SHARED_MEMORY_RINGS_H
+
+#include <atomic>
+#include <mpi.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Message rings in memory shared by the ranks of one host.
+ *
+ * Each rank owns a segment of an MPI-3 shared memory window holding
+ * one single producer, single consumer ring per rank of its host.  A
+ * sender writes its message directly into the ring it owns in the
+ * segment of the receiver and publishes it by advancing the tail of
+ * the ring; the receiver polls its rings and advances their heads once
+ * it has consumed a message.  No MPI call is involved once the window
+ * exists, and a message is copied only by the sender and the receiver.
+ *
+ * Each message is framed by its size and the LBTS round it was sent
+ * in, and padded to 8 bytes.  A message which does not fit before the
+ * end of the ring is written at its start, after a marker skipping the
+ * end.
+ */
+class SharedMemoryRings
+{
+  public:
+    SharedMemoryRings();
+    ~SharedMemoryRings();
+
+    /**
+     * Create the rings between the ranks of a communicator which share
+     * this host.  Collective over the communicator.
+     *
+     * \param [in] communicator The communicator of the ranks.
+     * \param [in] capacity The size in bytes of each ring.
+     */
+    void Create(MPI_Comm communicator, uint32_t capacity);
+    /**
+     * Release the rings.  Collective over the communicator the rings
+     * were created with.
+     */
+    void Free();
+
+    /**
+     * \return \c true if some rank shares this host with this one.
+     */
+    bool IsEnabled() const;
+    /**
+     * \param [in] rank The rank in the communicator.
+     * \return \c true if the rings can carry messages to this rank.
+     */
+    bool IsLocal(uint32_t rank) const;
+
+    /**
+     * Reserve room for a message to a rank.
+     *
+     * The message is not visible to the receiver until Commit().
+     *
+     * \param [in] rank The destination rank, which must be local.
+     * \param [in] size The message size in bytes.
+     * \param [in] epoch The LBTS round the message is sent in.
+     * \return The storage to write the message to, or \c nullptr if the
+     *         ring is full.
+     */
+    uint8_t* Reserve(uint32_t rank, uint32_t size, uint32_t epoch);
+    /**
+     * Publish the message reserved last.
+     *
+     * \param [in] rank The destination rank passed to Reserve().
+     */
+    void Commit(uint32_t rank);
+
+    /**
+     * Get the next message received from any rank.
+     *
+     * The message stays in the ring until Release().
+     *
+     * \param [out] rank The source rank.
+     * \param [out] size The message size in bytes.
+     * \param [out] epoch The LBTS round the message was sent in.
+     * \return The message, or \c nullptr if no message is pending.
+     */
+    const uint8_t* Next(uint32_t* rank, uint32_t* size, uint32_t* epoch);
+    /**
+     * Release the message returned by the last call to Next().
+     */
+    void Release();
+
+    /**
+     * \return The number of messages which did not fit in a ring.
+     */
+    uint64_t GetFullCount() const;
+
+  private:
+    /**
+     * Positions of a ring, on separate cache lines since they are
+     * written by different ranks.  Positions increase monotonically;
+     * their offset in the ring is modulo the capacity.
+     */
+    struct Ring
+    {
+        alignas(64) std::atomic<uint64_t> m_head; //!< Consumed position, written by the receiver.
+        alignas(64) std::atomic<uint64_t> m_tail; //!< Produced position, written by the sender.
+    };
+
+    /**
+     * Get a ring.
+     *
+     * \param [in] owner The host rank owning the segment, the receiver.
+     * \param [in] source The host rank writing to the ring, the sender.
+     * \return The ring.
+     */
+    Ring* GetRing(uint32_t owner, uint32_t source) const;
+    /**
+     * \param [in] ring A ring.
+     * \return The message storage of the ring.
+     */
+    uint8_t* GetData(Ring* ring) const;
+
+    /** The MPI shared memory window. */
+    MPI_Win m_window;
+    /** The communicator of the ranks of this host. */
+    MPI_Comm m_hostCommunicator;
+    /** Rank of this task in m_hostCommunicator. */
+    uint32_t m_hostRank;
+    /** Host rank of each rank of the communicator, or -1 for another host. */
+    std::vector<int> m_hostRanks;
+    /** Communicator rank of each host rank. */
+    std::vector<uint32_t> m_ranks;
+    /** Start of the segment of each host rank. */
+    std::vector<uint8_t*> m_segments;
+    /** Size of a ring, positions included. */
+    uint64_t m_stride;
+    /** Bytes of message storage in each ring. */
+    uint64_t m_capacity;
+    /** Tail of the message reserved last, to publish at Commit(). */
+    uint64_t m_reservedTail;
+    /** Host rank the last message from Next() came from. */
+    uint32_t m_current;
+    /** Position after the last message from Next(), to publish at Release(). */
+    uint64_t m_currentHead;
+    /** Host rank to poll first in Next(), so the senders are served in turn. */
+    uint32_t m_nextSource;
+    /** Messages which did not fit in a ring. */
+    uint64_t m_full;
+};
+
+} // namespace ns3
+
+#endif /* NS3_SHARED_MEMORY_RINGS_H */
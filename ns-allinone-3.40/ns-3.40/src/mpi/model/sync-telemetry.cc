@@ -0,0 +1,270 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Implementation of class ns3::SyncTelemetry.
+ */
+
+#include "sync-telemetry.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SyncTelemetry");
+
+/** Number of window size histogram buckets, one per bit of a time step. */
+const uint32_t WINDOW_HISTOGRAM_BUCKETS = 64;
+
+uint64_t SyncTelemetry::g_rounds = 0;
+uint64_t SyncTelemetry::g_events = 0;
+uint64_t SyncTelemetry::g_maxRoundEvents = 0;
+std::vector<uint64_t> SyncTelemetry::g_windowHistogram(WINDOW_HISTOGRAM_BUCKETS, 0);
+SyncTelemetry::Clock::duration SyncTelemetry::g_blocked{0};
+SyncTelemetry::Clock::duration SyncTelemetry::g_run{0};
+uint64_t SyncTelemetry::g_nullTx = 0;
+uint64_t SyncTelemetry::g_nullRx = 0;
+uint64_t SyncTelemetry::g_nullRequests = 0;
+uint64_t SyncTelemetry::g_nullSuppressed = 0;
+uint64_t SyncTelemetry::g_nullAvoided = 0;
+uint64_t SyncTelemetry::g_packetsTx = 0;
+uint64_t SyncTelemetry::g_packetBytesTx = 0;
+uint64_t SyncTelemetry::g_sendBufferAllocations = 0;
+uint64_t SyncTelemetry::g_sendBufferReuses = 0;
+std::vector<uint64_t> SyncTelemetry::g_txBytes;
+std::vector<uint64_t> SyncTelemetry::g_rxBytes;
+
+void
+SyncTelemetry::Reset(uint32_t systemCount)
+{
+    NS_LOG_FUNCTION(systemCount);
+
+    g_rounds = 0;
+    g_events = 0;
+    g_maxRoundEvents = 0;
+    g_windowHistogram.assign(WINDOW_HISTOGRAM_BUCKETS, 0);
+    g_blocked = Clock::duration::zero();
+    g_run = Clock::duration::zero();
+    g_nullTx = 0;
+    g_nullRx = 0;
+    g_nullRequests = 0;
+    g_nullSuppressed = 0;
+    g_nullAvoided = 0;
+    g_packetsTx = 0;
+    g_packetBytesTx = 0;
+    g_sendBufferAllocations = 0;
+    g_sendBufferReuses = 0;
+    g_txBytes.assign(systemCount, 0);
+    g_rxBytes.assign(systemCount, 0);
+}
+
+void
+SyncTelemetry::RecordRound(const Time& window, uint64_t events)
+{
+    g_rounds++;
+    g_events += events;
+    g_maxRoundEvents = std::max(g_maxRoundEvents, events);
+
+    uint64_t steps = window.IsStrictlyPositive() ? window.GetTimeStep() : 0;
+    uint32_t bucket = 0;
+    while (steps > 1)
+    {
+        steps >>= 1;
+        bucket++;
+    }
+    g_windowHistogram[bucket]++;
+}
+
+void
+SyncTelemetry::RecordBlocked(Clock::time_point start)
+{
+    g_blocked += Clock::now() - start;
+}
+
+void
+SyncTelemetry::RecordRun(Clock::time_point start)
+{
+    g_run += Clock::now() - start;
+}
+
+uint64_t
+SyncTelemetry::GetRounds()
+{
+    return g_rounds;
+}
+
+uint64_t
+SyncTelemetry::GetEvents()
+{
+    return g_events;
+}
+
+uint64_t
+SyncTelemetry::GetMaxRoundEvents()
+{
+    return g_maxRoundEvents;
+}
+
+double
+SyncTelemetry::GetEventsPerRound()
+{
+    return g_rounds ? static_cast<double>(g_events) / g_rounds : 0;
+}
+
+const std::vector<uint64_t>&
+SyncTelemetry::GetWindowHistogram()
+{
+    return g_windowHistogram;
+}
+
+Time
+SyncTelemetry::GetBlockedTime()
+{
+    return NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(g_blocked).count());
+}
+
+Time
+SyncTelemetry::GetExecutionTime()
+{
+    return NanoSeconds(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(g_run - g_blocked).count());
+}
+
+uint64_t
+SyncTelemetry::GetNullMessagesSent()
+{
+    return g_nullTx;
+}
+
+uint64_t
+SyncTelemetry::GetNullMessagesReceived()
+{
+    return g_nullRx;
+}
+
+uint64_t
+SyncTelemetry::GetNullMessageRequests()
+{
+    return g_nullRequests;
+}
+
+uint64_t
+SyncTelemetry::GetNullMessagesSuppressed()
+{
+    return g_nullSuppressed;
+}
+
+uint64_t
+SyncTelemetry::GetNullMessagesAvoided()
+{
+    return g_nullAvoided;
+}
+
+uint64_t
+SyncTelemetry::GetPacketsSent()
+{
+    return g_packetsTx;
+}
+
+uint64_t
+SyncTelemetry::GetPacketBytesSent()
+{
+    return g_packetBytesTx;
+}
+
+double
+SyncTelemetry::GetBytesPerPacket()
+{
+    return g_packetsTx > 0 ? static_cast<double>(g_packetBytesTx) / g_packetsTx : 0;
+}
+
+uint64_t
+SyncTelemetry::GetSendBufferAllocations()
+{
+    return g_sendBufferAllocations;
+}
+
+uint64_t
+SyncTelemetry::GetSendBufferReuses()
+{
+    return g_sendBufferReuses;
+}
+
+uint64_t
+SyncTelemetry::GetTxBytes(uint32_t rank)
+{
+    NS_ASSERT(rank < g_txBytes.size());
+    return g_txBytes[rank];
+}
+
+uint64_t
+SyncTelemetry::GetRxBytes(uint32_t rank)
+{
+    NS_ASSERT(rank < g_rxBytes.size());
+    return g_rxBytes[rank];
+}
+
+void
+SyncTelemetry::Write(const std::string& prefix, uint32_t rank)
+{
+    NS_LOG_FUNCTION(prefix << rank);
+
+    std::ostringstream filename;
+    filename << prefix << "-" << rank << ".csv";
+    std::ofstream out(filename.str());
+    NS_ABORT_MSG_UNLESS(out.is_open(), "Can't open telemetry file " << filename.str());
+
+    out << "name,index,value\n";
+    out << "rounds,," << g_rounds << "\n";
+    out << "events,," << g_events << "\n";
+    out << "max_round_events,," << g_maxRoundEvents << "\n";
+    out << "blocked_ns,," << GetBlockedTime().GetNanoSeconds() << "\n";
+    out << "execution_ns,," << GetExecutionTime().GetNanoSeconds() << "\n";
+    out << "null_tx,," << g_nullTx << "\n";
+    out << "null_rx,," << g_nullRx << "\n";
+    out << "null_requests,," << g_nullRequests << "\n";
+    out << "null_suppressed,," << g_nullSuppressed << "\n";
+    out << "null_avoided,," << g_nullAvoided << "\n";
+    out << "packets_tx,," << g_packetsTx << "\n";
+    out << "packet_bytes_tx,," << g_packetBytesTx << "\n";
+    out << "send_buffer_allocations,," << g_sendBufferAllocations << "\n";
+    out << "send_buffer_reuses,," << g_sendBufferReuses << "\n";
+    for (uint32_t bucket = 0; bucket < g_windowHistogram.size(); ++bucket)
+    {
+        if (g_windowHistogram[bucket] > 0)
+        {
+            out << "window_log2," << bucket << "," << g_windowHistogram[bucket] << "\n";
+        }
+    }
+    for (uint32_t peer = 0; peer < g_txBytes.size(); ++peer)
+    {
+        if (g_txBytes[peer] > 0 || g_rxBytes[peer] > 0)
+        {
+            out << "tx_bytes," << peer << "," << g_txBytes[peer] << "\n";
+            out << "rx_bytes," << peer << "," << g_rxBytes[peer] << "\n";
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,286 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ * Declaration of class ns3::SyncTelemetry.
+ */
+
+#ifndef NS3_SYNC_TELEMETRY_H
+#define NS3_SYNC_TELEMETRY_H
+
+#include "ns3/nstime.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Synchronization counters of the distributed simulators.
+ *
+ * DistributedSimulatorImpl and NullMessageSimulatorImpl count the
+ * synchronization rounds, the events executed and the simulated time
+ * advanced in each round, the wall time spent blocked waiting for other
+ * ranks, the null messages sent, received, requested, suppressed and,
+ * in demand-driven mode, avoided,
+ * the packets sent and their encoded size, the send buffers allocated
+ * and reused, and the bytes exchanged with each peer rank.
+ * For the granted time window algorithm a round is one LBTS computation;
+ * for the null message algorithm it is one blocking wait for a message.
+ *
+ * The counters are updated a few times per round or per message, so
+ * they are always on.  They cover the current rank and are reset when
+ * the simulator is created.  Setting the TelemetryFile attribute of the
+ * simulator writes them at Simulator::Destroy() to one CSV file per
+ * rank, named `<TelemetryFile>-<rank>.csv`, with `name,index,value`
+ * rows where the index is the peer rank or histogram bucket, if any.
+ */
+class SyncTelemetry
+{
+  public:
+    /** Clock used to measure the wall time. */
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Reset all the counters.
+     *
+     * \param [in] systemCount The number of ranks.
+     */
+    static void Reset(uint32_t systemCount);
+
+    /**
+     * Record the end of a synchronization round.
+     *
+     * \param [in] window The simulated time granted by the round.
+     * \param [in] events The events executed since the previous round.
+     */
+    static void RecordRound(const Time& window, uint64_t events);
+    /**
+     * Record wall time spent blocked waiting for other ranks.
+     *
+     * \param [in] start When the wait started.
+     */
+    static void RecordBlocked(Clock::time_point start);
+    /**
+     * Record the wall time of a Simulator::Run().
+     *
+     * \param [in] start When the run started.
+     */
+    static void RecordRun(Clock::time_point start);
+    /**
+     * Record a message sent to a peer rank.
+     *
+     * \param [in] rank The peer rank.
+     * \param [in] bytes The message size.
+     */
+    static void RecordTx(uint32_t rank, uint32_t bytes)
+    {
+        g_txBytes[rank] += bytes;
+    }
+    /**
+     * Record a message received from a peer rank.
+     *
+     * \param [in] rank The peer rank.
+     * \param [in] bytes The message size.
+     */
+    static void RecordRx(uint32_t rank, uint32_t bytes)
+    {
+        g_rxBytes[rank] += bytes;
+    }
+    /**
+     * Record a packet sent to another rank.
+     *
+     * \param [in] bytes The size of the encoded packet and its prefix.
+     */
+    static void RecordPacketTx(uint32_t bytes)
+    {
+        g_packetsTx++;
+        g_packetBytesTx += bytes;
+    }
+    /** Record a null message sent. */
+    static void RecordNullTx()
+    {
+        g_nullTx++;
+    }
+    /** Record a null message received. */
+    static void RecordNullRx()
+    {
+        g_nullRx++;
+    }
+    /** Record a null message sent as a request for a reply. */
+    static void RecordNullRequest()
+    {
+        g_nullRequests++;
+    }
+    /** Record a null message not sent because it carried no new guarantee. */
+    static void RecordNullSuppressed()
+    {
+        g_nullSuppressed++;
+    }
+    /**
+     * Record a non-blocking send which needed new buffer storage.
+     */
+    static void RecordSendBufferAllocation()
+    {
+        g_sendBufferAllocations++;
+    }
+    /**
+     * Record a non-blocking send which reused the storage of a completed one.
+     */
+    static void RecordSendBufferReuse()
+    {
+        g_sendBufferReuses++;
+    }
+    /**
+     * Record periodic null message events not run in demand-driven mode.
+     *
+     * \param [in] count The number of events.
+     */
+    static void RecordNullAvoided(uint64_t count)
+    {
+        g_nullAvoided += count;
+    }
+
+    /**
+     * \return The number of synchronization rounds.
+     */
+    static uint64_t GetRounds();
+    /**
+     * \return The number of events counted by the rounds.
+     */
+    static uint64_t GetEvents();
+    /**
+     * \return The largest number of events executed in a round.
+     */
+    static uint64_t GetMaxRoundEvents();
+    /**
+     * \return The average number of events executed per round.
+     */
+    static double GetEventsPerRound();
+    /**
+     * Get the histogram of the simulated time granted by each round.
+     *
+     * Bucket \c i counts the windows of [2^i, 2^(i+1)) time steps;
+     * bucket 0 also counts empty windows.
+     *
+     * \return The number of windows in each bucket.
+     */
+    static const std::vector<uint64_t>& GetWindowHistogram();
+    /**
+     * \return The wall time spent blocked waiting for other ranks.
+     */
+    static Time GetBlockedTime();
+    /**
+     * \return The wall time of Simulator::Run() not spent blocked.
+     */
+    static Time GetExecutionTime();
+    /**
+     * \return The number of null messages sent.
+     */
+    static uint64_t GetNullMessagesSent();
+    /**
+     * \return The number of null messages received.
+     */
+    static uint64_t GetNullMessagesReceived();
+    /**
+     * \return The number of null messages sent as requests, which are
+     *         included in GetNullMessagesSent().
+     */
+    static uint64_t GetNullMessageRequests();
+    /**
+     * \return The number of periodic null messages not sent because a
+     *         packet or an earlier null message already carried the same
+     *         guarantee time.
+     */
+    static uint64_t GetNullMessagesSuppressed();
+    /**
+     * \return The number of periodic null message events the demand-driven
+     *         mode did not run.  Each would have sent a null message or
+     *         counted as suppressed.
+     */
+    static uint64_t GetNullMessagesAvoided();
+    /**
+     * \param [in] rank The peer rank.
+     * \return The bytes sent to the rank.
+     */
+    static uint64_t GetTxBytes(uint32_t rank);
+    /**
+     * \param [in] rank The peer rank.
+     * \return The bytes received from the rank.
+     */
+    static uint64_t GetRxBytes(uint32_t rank);
+
+    /**
+     * \return The number of packets sent to other ranks.
+     */
+    static uint64_t GetPacketsSent();
+    /**
+     * \return The bytes of the packets sent to other ranks, prefixes
+     *         included and MPI framing excluded.
+     */
+    static uint64_t GetPacketBytesSent();
+    /**
+     * \return The average encoded size of a packet sent to another rank.
+     */
+    static double GetBytesPerPacket();
+
+    /**
+     * \return The number of non-blocking sends which allocated buffer storage.
+     */
+    static uint64_t GetSendBufferAllocations();
+    /**
+     * \return The number of non-blocking sends which reused the buffer
+     *         storage of a completed send.
+     */
+    static uint64_t GetSendBufferReuses();
+
+    /**
+     * Write the counters of this rank to `<prefix>-<rank>.csv`.
+     *
+     * \param [in] prefix The file name prefix.
+     * \param [in] rank This rank.
+     */
+    static void Write(const std::string& prefix, uint32_t rank);
+
+  private:
+    static uint64_t g_rounds;                       //!< Synchronization rounds.
+    static uint64_t g_events;                       //!< Events counted by the rounds.
+    static uint64_t g_maxRoundEvents;               //!< Most events in a round.
+    static std::vector<uint64_t> g_windowHistogram; //!< Windows by log2 of their size.
+    static Clock::duration g_blocked;               //!< Wall time blocked.
+    static Clock::duration g_run;                   //!< Wall time in Run().
+    static uint64_t g_nullTx;                       //!< Null messages sent.
+    static uint64_t g_nullRx;                       //!< Null messages received.
+    static uint64_t g_nullRequests;                 //!< Null message requests sent.
+    static uint64_t g_nullSuppressed;               //!< Null messages not sent.
+    static uint64_t g_nullAvoided;                  //!< Null message events not run.
+    static uint64_t g_packetsTx;                    //!< Packets sent.
+    static uint64_t g_packetBytesTx;                //!< Bytes of the packets sent.
+    static uint64_t g_sendBufferAllocations;        //!< Send buffers allocated.
+    static uint64_t g_sendBufferReuses;             //!< Send buffers reused.
+    static std::vector<uint64_t> g_txBytes;         //!< Bytes sent, by rank.
+    static std::vector<uint64_t> g_rxBytes;         //!< Bytes received, by rank.
+};
+
+} // namespace ns3
+
+#endif /* NS3_SYNC_TELEMETRY_H */
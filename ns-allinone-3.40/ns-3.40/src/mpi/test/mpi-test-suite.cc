@@ -154,6 +154,81 @@ static MpiTestSuite g_mpiSimple2("mpi-example-simple-2",
                                  NS_TEST_SOURCEDIR,
                                  2);
 static MpiTestSuite g_mpiThird2("mpi-example-third-2", "third-distributed", NS_TEST_SOURCEDIR, 2);
+static MpiTestSuite g_mpiSimple2Aggregate("mpi-example-simple-2-aggregate",
+                                          "simple-distributed",
+                                          NS_TEST_SOURCEDIR,
+                                          2,
+                                          "--aggregate");
+static MpiTestSuite g_mpiSimple2NonBlocking("mpi-example-simple-2-nonblocking",
+                                            "simple-distributed",
+                                            NS_TEST_SOURCEDIR,
+                                            2,
+                                            "--nonblocking");
+static MpiTestSuite g_mpiSimple2Neighbor("mpi-example-simple-2-neighbor",
+                                         "simple-distributed",
+                                         NS_TEST_SOURCEDIR,
+                                         2,
+                                         "--neighbor");
+static MpiTestSuite g_mpiSimple2Partition("mpi-example-simple-2-partition",
+                                          "simple-distributed",
+                                          NS_TEST_SOURCEDIR,
+                                          2,
+                                          "--partition");
+static MpiTestSuite g_mpiSimple2Ring("mpi-example-simple-2-ring",
+                                     "simple-distributed",
+                                     NS_TEST_SOURCEDIR,
+                                     2,
+                                     "--ring=640");
+static MpiTestSuite g_mpiSimple2Compact("mpi-example-simple-2-compact",
+                                        "simple-distributed",
+                                        NS_TEST_SOURCEDIR,
+                                        2,
+                                        "--compact --ring=0");
+static MpiTestSuite g_mpiSimple2Hybrid1("mpi-example-simple-2-hybrid-1",
+                                        "simple-distributed",
+                                        NS_TEST_SOURCEDIR,
+                                        2,
+                                        "--threads=1 --packets=100");
+#ifdef NS3_MPI_THREADS
+static MpiTestSuite g_mpiSimple2Hybrid("mpi-example-simple-2-hybrid",
+                                       "simple-distributed",
+                                       NS_TEST_SOURCEDIR,
+                                       2,
+                                       "--threads=2 --nix=0");
+// Most links of the dumbbell are between threads
+static MpiTestSuite g_mpiSimple2Hybrid4("mpi-example-simple-2-hybrid-4",
+                                        "simple-distributed",
+                                        NS_TEST_SOURCEDIR,
+                                        2,
+                                        "--threads=4 --nix=0 --packets=500");
+#endif
+static MpiTestSuite g_mpiSimple2Flowmon("mpi-example-simple-2-flowmon",
+                                        "simple-distributed",
+                                        NS_TEST_SOURCEDIR,
+                                        2,
+                                        "--flowmon");
+// The packets of one flow leave rank 0 and are received back on it
+static MpiTestSuite g_mpiSimple2FlowmonDetour("mpi-example-simple-2-flowmon-detour",
+                                              "simple-distributed",
+                                              NS_TEST_SOURCEDIR,
+                                              2,
+                                              "--flowmon --detour --packets=10");
+// Without the shared memory rings, so that the packets are sent with MPI
+static MpiTestSuite g_mpiSimple2Pool("mpi-example-simple-2-pool",
+                                     "simple-distributed",
+                                     NS_TEST_SOURCEDIR,
+                                     2,
+                                     "--ring=0 --packets=100 --pool");
+static MpiTestSuite g_mpiSimple2NullmsgPool("mpi-example-simple-2-nullmsg-pool",
+                                            "simple-distributed",
+                                            NS_TEST_SOURCEDIR,
+                                            2,
+                                            "--nullmsg --packets=100 --pool");
+static MpiTestSuite g_mpiSimple2Ghost("mpi-example-simple-2-ghost",
+                                      "simple-distributed",
+                                      NS_TEST_SOURCEDIR,
+                                      2,
+                                      "--ghost");
 
 /* Tests using NullMessageSimulatorImpl */
 static MpiTestSuite g_mpiSimple2NullMsg("mpi-example-simple-2-nullmsg",
@@ -161,6 +236,11 @@ static MpiTestSuite g_mpiSimple2NullMsg("mpi-example-simple-2-nullmsg",
                                         NS_TEST_SOURCEDIR,
                                         2,
                                         "--nullmsg");
+static MpiTestSuite g_mpiSimple2NullMsgDemand("mpi-example-simple-2-nullmsg-demand",
+                                              "simple-distributed",
+                                              NS_TEST_SOURCEDIR,
+                                              2,
+                                              "--nullmsg --demand");
 static MpiTestSuite g_mpiEmpty2NullMsg("mpi-example-empty-2-nullmsg",
                                        "simple-distributed-empty-node",
                                        NS_TEST_SOURCEDIR,
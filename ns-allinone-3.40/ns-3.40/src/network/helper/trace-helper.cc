@@ -35,6 +35,21 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("TraceHelper");
 
+/**
+ * In a distributed simulation, the devices of the nodes of the other systems
+ * are not traced, so that each rank writes the trace files of its own devices
+ * only.
+ *
+ * \param nd the device
+ * \returns true if the node of the device is simulated by this system
+ */
+static bool
+IsLocalDevice(Ptr<NetDevice> nd)
+{
+    Ptr<Node> node = nd->GetNode();
+    return !node || node->GetSystemId() == Simulator::GetSystemId();
+}
+
 PcapHelper::PcapHelper()
 {
     NS_LOG_FUNCTION_NOARGS();
@@ -314,7 +329,7 @@ AsciiTraceHelper::DefaultEnqueueSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << *p << '\n';
 }
 
 void
@@ -324,7 +339,7 @@ AsciiTraceHelper::DefaultEnqueueSinkWithContext(Ptr<OutputStreamWrapper> stream,
 {
     NS_LOG_FUNCTION(stream << p);
     *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+                         << '\n';
 }
 
 //
@@ -344,7 +359,7 @@ AsciiTraceHelper::DefaultDropSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << '\n';
 }
 
 void
@@ -354,7 +369,7 @@ AsciiTraceHelper::DefaultDropSinkWithContext(Ptr<OutputStreamWrapper> stream,
 {
     NS_LOG_FUNCTION(stream << p);
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+                         << '\n';
 }
 
 //
@@ -375,7 +390,7 @@ AsciiTraceHelper::DefaultDequeueSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << *p << '\n';
 }
 
 void
@@ -385,7 +400,7 @@ AsciiTraceHelper::DefaultDequeueSinkWithContext(Ptr<OutputStreamWrapper> stream,
 {
     NS_LOG_FUNCTION(stream << p);
     *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+                         << '\n';
 }
 
 //
@@ -403,7 +418,7 @@ AsciiTraceHelper::DefaultReceiveSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *p << '\n';
 }
 
 void
@@ -413,7 +428,7 @@ AsciiTraceHelper::DefaultReceiveSinkWithContext(Ptr<OutputStreamWrapper> stream,
 {
     NS_LOG_FUNCTION(stream << p);
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+                         << '\n';
 }
 
 void
@@ -422,6 +437,10 @@ PcapHelperForDevice::EnablePcap(std::string prefix,
                                 bool promiscuous,
                                 bool explicitFilename)
 {
+    if (!IsLocalDevice(nd))
+    {
+        return;
+    }
     EnablePcapInternal(prefix, nd, promiscuous, explicitFilename);
 }
 
@@ -496,6 +515,10 @@ PcapHelperForDevice::EnablePcap(std::string prefix,
 void
 AsciiTraceHelperForDevice::EnableAscii(std::string prefix, Ptr<NetDevice> nd, bool explicitFilename)
 {
+    if (!IsLocalDevice(nd))
+    {
+        return;
+    }
     EnableAsciiInternal(Ptr<OutputStreamWrapper>(), prefix, nd, explicitFilename);
 }
 
@@ -505,6 +528,10 @@ AsciiTraceHelperForDevice::EnableAscii(std::string prefix, Ptr<NetDevice> nd, bo
 void
 AsciiTraceHelperForDevice::EnableAscii(Ptr<OutputStreamWrapper> stream, Ptr<NetDevice> nd)
 {
+    if (!IsLocalDevice(nd))
+    {
+        return;
+    }
     EnableAsciiInternal(stream, std::string(), nd, false);
 }
 
@@ -538,6 +565,10 @@ AsciiTraceHelperForDevice::EnableAsciiImpl(Ptr<OutputStreamWrapper> stream,
                                            bool explicitFilename)
 {
     Ptr<NetDevice> nd = Names::Find<NetDevice>(ndName);
+    if (!IsLocalDevice(nd))
+    {
+        return;
+    }
     EnableAsciiInternal(stream, prefix, nd, explicitFilename);
 }
 
@@ -570,6 +601,10 @@ AsciiTraceHelperForDevice::EnableAsciiImpl(Ptr<OutputStreamWrapper> stream,
     for (auto i = d.Begin(); i != d.End(); ++i)
     {
         Ptr<NetDevice> dev = *i;
+        if (!IsLocalDevice(dev))
+        {
+            continue;
+        }
         EnableAsciiInternal(stream, prefix, dev, false);
     }
 }
@@ -679,6 +714,10 @@ AsciiTraceHelperForDevice::EnableAsciiImpl(Ptr<OutputStreamWrapper> stream,
 
         Ptr<NetDevice> nd = node->GetDevice(deviceid);
 
+        if (!IsLocalDevice(nd))
+        {
+            return;
+        }
         EnableAsciiInternal(stream, prefix, nd, explicitFilename);
         return;
     }
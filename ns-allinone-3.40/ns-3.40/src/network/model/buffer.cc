@@ -54,7 +54,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+#ifdef NS3_MPI_THREADS
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -79,9 +83,15 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED(x) && !IS_DESTROYED(x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
+#ifdef NS3_MPI_THREADS
+thread_local uint32_t Buffer::g_maxSize = 0;
+thread_local Buffer::FreeList* Buffer::g_freeList = nullptr;
+thread_local Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+#else
 uint32_t Buffer::g_maxSize = 0;
 Buffer::FreeList* Buffer::g_freeList = nullptr;
 Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+#endif
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor()
 {
@@ -102,10 +112,14 @@ Buffer::Recycle(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
+    // With threads, the data may come from another thread before this one
+    // has created its free list
+#ifndef NS3_MPI_THREADS
     NS_ASSERT(!IS_UNINITIALIZED(g_freeList));
+#endif
     g_maxSize = std::max(g_maxSize, data->m_size);
     /* feed into free list */
-    if (data->m_size < g_maxSize || IS_DESTROYED(g_freeList) || g_freeList->size() > 1000)
+    if (data->m_size < g_maxSize || !IS_INITIALIZED(g_freeList) || g_freeList->size() > 1000)
     {
         Buffer::Deallocate(data);
     }
@@ -124,6 +138,10 @@ Buffer::Create(uint32_t dataSize)
     if (IS_UNINITIALIZED(g_freeList))
     {
         g_freeList = new Buffer::FreeList();
+#ifdef NS3_MPI_THREADS
+        // Use the destructor of this thread so that it frees the list
+        (void)g_localStaticDestructor;
+#endif
     }
     else if (IS_INITIALIZED(g_freeList))
     {
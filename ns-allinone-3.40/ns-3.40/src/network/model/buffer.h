@@ -767,9 +767,13 @@ class Buffer
     /**
      * location in a newly-allocated buffer where you should start
      * writing data. i.e., m_start should be initialized to this
-     * value.
+     * value.  With NS3_MPI_THREADS, each thread keeps its own.
      */
+#ifdef NS3_MPI_THREADS
+    static thread_local uint32_t g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -802,10 +806,18 @@ class Buffer
         ~LocalStaticDestructor();
     };
 
+#ifdef NS3_MPI_THREADS
+    // Each thread of HybridSimulatorImpl keeps its own free list
+    static thread_local uint32_t g_maxSize;   //!< Max observed data size
+    static thread_local FreeList* g_freeList; //!< Buffer data container
+    /// Local static destructor, run when the thread exits
+    static thread_local LocalStaticDestructor g_localStaticDestructor;
+#else
     static uint32_t g_maxSize;                            //!< Max observed data size
     static FreeList* g_freeList;                          //!< Buffer data container
     static LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
+#endif
 };
 
 } // namespace ns3
@@ -51,6 +51,19 @@ static GlobalValue g_checksumEnabled =
                 BooleanValue(false),
                 MakeBooleanChecker());
 
+/**
+ * \relates Node
+ * \anchor GlobalValueGhostNodes
+ * \brief A global switch to make the nodes of the other systems of a
+ * distributed simulation lightweight ghost nodes.
+ */
+static GlobalValue g_ghostNodes =
+    GlobalValue("GhostNodes",
+                "A global switch to make the nodes of the other systems of a distributed "
+                "simulation ghost nodes, without the state they only need to run events",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
 TypeId
 Node::GetTypeId()
 {
@@ -290,6 +303,22 @@ Node::ChecksumEnabled()
     return val.Get();
 }
 
+bool
+Node::GhostNodesEnabled()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    BooleanValue val;
+    g_ghostNodes.GetValue(val);
+    return val.Get();
+}
+
+bool
+Node::IsGhost() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_sid != Simulator::GetSystemId() && GhostNodesEnabled();
+}
+
 bool
 Node::PromiscReceiveFromDevice(Ptr<NetDevice> device,
                                Ptr<const Packet> packet,
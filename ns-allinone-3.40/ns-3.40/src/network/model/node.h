@@ -94,6 +94,18 @@ class Node : public Object
      */
     uint32_t GetSystemId() const;
 
+    /**
+     * A ghost node is a node of another system of a distributed simulation,
+     * when the GhostNodes global value is set.  It never runs any event on
+     * this system, so the helpers only give it the state needed for routing
+     * and for the wiring of the remote channels: its devices, their
+     * channels and their addresses, but neither queues nor transport
+     * protocols.
+     *
+     * \returns true if this node is a ghost node
+     */
+    bool IsGhost() const;
+
     /**
      * \brief Associate a NetDevice to this node.
      *
@@ -213,6 +225,12 @@ class Node : public Object
      */
     static bool ChecksumEnabled();
 
+    /**
+     * \returns true if the nodes of the other systems of a distributed
+     *          simulation are ghost nodes, false otherwise.
+     */
+    static bool GhostNodesEnabled();
+
   protected:
     /**
      * The dispose method. Subclasses must override this method
@@ -36,10 +36,18 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
+#ifdef NS3_MPI_THREADS
+thread_local bool PacketMetadata::m_metadataSkipped = false;
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local bool PacketMetadata::m_freeListDestroyed = false;
+#else
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+#endif
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -48,7 +56,12 @@ PacketMetadata::DataFreeList::~DataFreeList()
     {
         PacketMetadata::Deallocate(*i);
     }
+#ifdef NS3_MPI_THREADS
+    // The other threads may still be using the metadata
+    PacketMetadata::m_freeListDestroyed = true;
+#else
     PacketMetadata::m_enable = false;
+#endif
 }
 
 void
@@ -598,6 +611,13 @@ PacketMetadata::Recycle(PacketMetadata::Data* data)
         PacketMetadata::Deallocate(data);
         return;
     }
+#ifdef NS3_MPI_THREADS
+    if (m_freeListDestroyed)
+    {
+        PacketMetadata::Deallocate(data);
+        return;
+    }
+#endif
     NS_LOG_LOGIC("recycle size=" << data->m_size << ", list=" << m_freeList.size());
     NS_ASSERT(data->m_count == 0);
     if (m_freeList.size() > 1000 || data->m_size < m_maxSize)
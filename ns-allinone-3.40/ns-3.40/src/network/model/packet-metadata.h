@@ -675,9 +675,23 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
+    static bool m_enable;         //!< Enable the packet metadata
+    static bool m_enableChecking; //!< Enable the packet metadata checking
+
+#ifdef NS3_MPI_THREADS
+    // Each thread of HybridSimulatorImpl keeps its own free list and counters
+    static thread_local DataFreeList m_freeList;  //!< the metadata data storage
+    static thread_local bool m_freeListDestroyed; //!< m_freeList of this thread is destroyed
+    /**
+     * Set to true when adding metadata to a packet is skipped because
+     * m_enable is false; used to detect enabling of metadata in the
+     * middle of a simulation, which isn't allowed.
+     */
+    static thread_local bool m_metadataSkipped;
+    static thread_local uint32_t m_maxSize;  //!< maximum metadata size
+    static thread_local uint16_t m_chunkUid; //!< Chunk Uid
+#else
     static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
 
     /**
      * Set to true when adding metadata to a packet is skipped because
@@ -688,6 +702,7 @@ class PacketMetadata
 
     static uint32_t m_maxSize;  //!< maximum metadata size
     static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
     Data* m_data; //!< Metadata storage
     /*
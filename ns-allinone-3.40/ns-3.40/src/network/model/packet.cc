@@ -30,7 +30,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MPI_THREADS
+std::atomic<uint32_t> Packet::m_globalUid{0};
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -146,10 +150,9 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
@@ -186,10 +189,9 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -213,10 +215,9 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
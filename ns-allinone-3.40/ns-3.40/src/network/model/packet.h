@@ -35,6 +35,10 @@
 
 #include <stdint.h>
 
+#ifdef NS3_MPI_THREADS
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -795,7 +799,11 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MPI_THREADS
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -27,6 +27,14 @@
 #include <limits> // std:numeric_limits
 #include <string>
 
+#ifdef NS3_MPI_THREADS
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#endif
+
 using namespace ns3;
 
 //-----------------------------------------------------------------------------
@@ -1264,6 +1272,141 @@ PacketTagListTest::DoRun()
 } // Timing
 }
 
+#ifdef NS3_MPI_THREADS
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packets created, copied and destroyed by several threads at once, which
+ * pass serialized copies to each other as the threads of
+ * HybridSimulatorImpl do.
+ */
+class PacketThreadsTest : public TestCase
+{
+  public:
+    PacketThreadsTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * Create packets, send serialized copies of them to the next thread,
+     * and check those received from the previous thread.
+     * \param index The thread index.
+     */
+    void RunThread(uint32_t index);
+    /**
+     * Check the packets received by a thread.
+     * \param index The thread index.
+     * \return The number of packets received.
+     */
+    uint32_t Receive(uint32_t index);
+
+    static const uint32_t THREADS = 4;    //!< Number of threads
+    static const uint32_t PACKETS = 5000; //!< Packets created by each thread
+
+    std::mutex m_mutex;                                 //!< Protects m_inbox
+    std::vector<std::vector<uint8_t>> m_inbox[THREADS]; //!< Serialized packets to each thread
+    std::vector<uint64_t> m_uids[THREADS];              //!< Uids of the packets of each thread
+    std::atomic<uint32_t> m_errors;                     //!< Packets received damaged
+    Ptr<Packet> m_shared;                               //!< Packet referenced by all threads
+};
+
+PacketThreadsTest::PacketThreadsTest()
+    : TestCase("Packets used by several threads"),
+      m_errors(0)
+{
+}
+
+uint32_t
+PacketThreadsTest::Receive(uint32_t index)
+{
+    std::vector<std::vector<uint8_t>> inbox;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        inbox.swap(m_inbox[index]);
+    }
+    for (auto& buffer : inbox)
+    {
+        Ptr<Packet> p = Create<Packet>(buffer.data(), buffer.size(), true);
+        ATestHeader<4> outer;
+        ATestHeader<10> inner;
+        ATestTag<4> tag;
+        p->RemoveHeader(outer);
+        p->RemoveHeader(inner);
+        if (outer.m_error || inner.m_error || !p->PeekPacketTag(tag) ||
+            tag.GetData() != static_cast<int>((index + THREADS - 1) % THREADS) ||
+            p->GetSize() < 100 || p->GetSize() >= 500)
+        {
+            m_errors++;
+        }
+    }
+    return inbox.size();
+}
+
+void
+PacketThreadsTest::RunThread(uint32_t index)
+{
+    uint32_t received = 0;
+    for (uint32_t i = 0; i < PACKETS; ++i)
+    {
+        Ptr<Packet> p = Create<Packet>(100 + i % 400);
+        p->AddHeader(ATestHeader<10>());
+        p->AddPacketTag(ATestTag<4>(index));
+        p->AddByteTag(ATestTag<2>(i % 256));
+        m_uids[index].push_back(p->GetUid());
+
+        // The copy shares the data of p until it gets its own header
+        Ptr<Packet> copy = p->Copy();
+        copy->AddHeader(ATestHeader<4>());
+        std::vector<uint8_t> buffer(copy->GetSerializedSize());
+        copy->Serialize(buffer.data(), buffer.size());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_inbox[(index + 1) % THREADS].push_back(std::move(buffer));
+        }
+
+        Ptr<Packet> shared = m_shared;
+        received += Receive(index);
+    }
+    while (received < PACKETS)
+    {
+        std::this_thread::yield();
+        received += Receive(index);
+    }
+}
+
+void
+PacketThreadsTest::DoRun()
+{
+    // Register the types and create the simulator before the threads use them
+    m_shared = Create<Packet>(10);
+    ATestHeader<4>::GetTypeId();
+    ATestHeader<10>::GetTypeId();
+    ATestTag<2>::GetTypeId();
+    ATestTag<4>::GetTypeId();
+
+    std::vector<std::thread> threads;
+    for (uint32_t index = 0; index < THREADS; ++index)
+    {
+        threads.emplace_back(&PacketThreadsTest::RunThread, this, index);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(m_errors.load(), 0, "Packets were damaged");
+    NS_TEST_EXPECT_MSG_EQ(m_shared->GetReferenceCount(), 1, "Wrong reference count");
+    std::set<uint64_t> uids;
+    for (auto& threadUids : m_uids)
+    {
+        uids.insert(threadUids.begin(), threadUids.end());
+    }
+    NS_TEST_EXPECT_MSG_EQ(uids.size(), THREADS * PACKETS, "Packet uids are not unique");
+    m_shared = nullptr;
+}
+#endif
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1281,6 +1424,9 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
+#ifdef NS3_MPI_THREADS
+    AddTestCase(new PacketThreadsTest, TestCase::QUICK);
+#endif
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
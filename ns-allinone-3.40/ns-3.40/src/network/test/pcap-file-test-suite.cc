@@ -15,6 +15,7 @@
  * Author:  Craig Dowell (craigdo@ee.washington.edu)
  */
 
+#include "ns3/async-trace-writer.h"
 #include "ns3/log.h"
 #include "ns3/pcap-file.h"
 #include "ns3/test.h"
@@ -22,6 +23,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -1375,6 +1377,107 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the packets written by batches on a
+ * background thread make the same file as the packets written one by one,
+ * and that flushing a batched stream writes its file.
+ */
+class BatchWriteTestCase : public TestCase
+{
+  public:
+    BatchWriteTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write the known packets to a file.
+     *
+     * \param filename the name of the file
+     * \param batchSize the size of the batches, 0 to write the packets one by one
+     */
+    void WriteKnownPackets(std::string filename, uint32_t batchSize);
+};
+
+BatchWriteTestCase::BatchWriteTestCase()
+    : TestCase("Check that PcapFile writes the same file by batches")
+{
+}
+
+void
+BatchWriteTestCase::WriteKnownPackets(std::string filename, uint32_t batchSize)
+{
+    PcapFile f;
+    f.Open(filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(),
+                          false,
+                          "Open (" << filename << ", \"std::ios::out\") returns error");
+    f.SetBatchSize(batchSize);
+    f.Init(1, N_PACKET_BYTES);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Init (1, " << N_PACKET_BYTES << ") returns error");
+
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+    }
+    f.Close();
+    NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Writing " << filename << " must not fail");
+}
+
+void
+BatchWriteTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("unbatched.pcap");
+    WriteKnownPackets(filename, 0);
+
+    // A batch size which is not a multiple of the size of the records
+    std::string filename2 = CreateTempDirFilename("batched.pcap");
+    WriteKnownPackets(filename2, 20);
+
+    uint32_t sec(0);
+    uint32_t usec(0);
+    uint32_t packets(0);
+    bool diff = PcapFile::Diff(filename, filename2, sec, usec, packets);
+    NS_TEST_EXPECT_MSG_EQ(diff, false, "Files written by batches must not differ");
+    NS_TEST_EXPECT_MSG_EQ(packets, N_KNOWN_PACKETS, "Files must hold all the packets");
+
+    // A packet truncated when it was captured keeps its original length
+    std::string filename3 = CreateTempDirFilename("truncated.pcap");
+    PcapFile f;
+    f.Open(filename3, std::ios::out);
+    f.SetBatchSize(20);
+    f.Init(1, N_PACKET_BYTES);
+    uint8_t data[10] = {};
+    f.Write(2, 3, data, sizeof(data), 100);
+    f.Close();
+    f.Open(filename3, std::ios::in);
+    uint8_t readData[N_PACKET_BYTES];
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+    uint32_t readLen;
+    f.Read(readData, sizeof(readData), tsSec, tsUsec, inclLen, origLen, readLen);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Reading " << filename3 << " must not fail");
+    NS_TEST_EXPECT_MSG_EQ(inclLen, sizeof(data), "Wrong included length");
+    NS_TEST_EXPECT_MSG_EQ(origLen, 100, "Wrong original length");
+    f.Close();
+
+    // Flushing a batched stream, as FatalImpl does, writes the file
+    std::string filename4 = CreateTempDirFilename("flushed.txt");
+    std::ofstream file(filename4);
+    AsyncTraceStream stream(&file, 1024);
+    stream << "a record" << std::endl;
+    std::ifstream in(filename4);
+    std::string line;
+    std::getline(in, line);
+    NS_TEST_EXPECT_MSG_EQ(line, "a record", "The flushed record must be in the file");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1398,6 +1501,7 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::QUICK);
     AddTestCase(new DiffTestCase, TestCase::QUICK);
+    AddTestCase(new BatchWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,256 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-trace-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/global-value.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AsyncTraceWriter");
+
+/**
+ * \relates AsyncTraceWriter
+ * \anchor GlobalValueAsyncTraceBatchSize
+ * The number of bytes of the trace files written together on a background
+ * thread.
+ */
+static GlobalValue g_asyncTraceBatchSize =
+    GlobalValue("AsyncTraceBatchSize",
+                "The number of bytes of the pcap and ascii trace files written together "
+                "on a background thread, or 0 to write them in the simulation thread",
+                UintegerValue(0),
+                MakeUintegerChecker<uint32_t>());
+
+namespace
+{
+
+/**
+ * \ingroup network
+ * The background thread of the AsyncTraceWriter and its queue of batches.
+ */
+class WriterThread
+{
+  public:
+    /// Write the batches still queued and stop the thread
+    ~WriterThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_queued.notify_one();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /**
+     * \param os the stream
+     * \param batch the bytes to write to it
+     */
+    void Push(std::ostream* os, std::string batch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_thread.joinable())
+            {
+                m_thread = std::thread(&WriterThread::Run, this);
+            }
+            m_batches.emplace_back(os, std::move(batch));
+            m_pending[os]++;
+        }
+        m_queued.notify_one();
+    }
+
+    /**
+     * \param os the stream whose batches are waited for
+     */
+    void Wait(const std::ostream* os)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_written.wait(lock, [this, os] { return m_pending.find(os) == m_pending.end(); });
+    }
+
+  private:
+    /// The body of the thread
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_queued.wait(lock, [this] { return m_stop || !m_batches.empty(); });
+            if (m_batches.empty())
+            {
+                return;
+            }
+            std::pair<std::ostream*, std::string> batch = std::move(m_batches.front());
+            m_batches.pop_front();
+            lock.unlock();
+            batch.first->write(batch.second.data(), batch.second.size());
+            lock.lock();
+            auto it = m_pending.find(batch.first);
+            if (--it->second == 0)
+            {
+                m_pending.erase(it);
+                m_written.notify_all();
+            }
+        }
+    }
+
+    std::mutex m_mutex;                //!< protects the members below
+    std::condition_variable m_queued;  //!< notified when a batch is queued
+    std::condition_variable m_written; //!< notified when a stream has no batch left
+    std::deque<std::pair<std::ostream*, std::string>> m_batches; //!< the queued batches
+    std::unordered_map<const std::ostream*, uint32_t> m_pending; //!< the batches left per stream
+    std::thread m_thread;                                        //!< the background thread
+    bool m_stop{false};                                          //!< whether the thread must stop
+};
+
+/**
+ * \returns the background thread, created on first use
+ */
+WriterThread&
+GetWriterThread()
+{
+    static WriterThread writer;
+    return writer;
+}
+
+} // namespace
+
+uint32_t
+AsyncTraceWriter::GetBatchSize()
+{
+    UintegerValue batchSize;
+    g_asyncTraceBatchSize.GetValue(batchSize);
+    return batchSize.Get();
+}
+
+void
+AsyncTraceWriter::Write(std::ostream* os, std::string batch)
+{
+    NS_LOG_FUNCTION(os << batch.size());
+    GetWriterThread().Push(os, std::move(batch));
+}
+
+void
+AsyncTraceWriter::Wait(const std::ostream* os)
+{
+    NS_LOG_FUNCTION(os);
+    GetWriterThread().Wait(os);
+}
+
+AsyncTraceStream::AsyncTraceStream(std::ostream* os, uint32_t batchSize)
+    : std::ostream(nullptr),
+      m_buffer(os, batchSize)
+{
+    NS_LOG_FUNCTION(this << os << batchSize);
+    rdbuf(&m_buffer);
+}
+
+AsyncTraceStream::~AsyncTraceStream()
+{
+    NS_LOG_FUNCTION(this);
+    Sync();
+}
+
+void
+AsyncTraceStream::Sync()
+{
+    NS_LOG_FUNCTION(this);
+    m_buffer.pubsync();
+}
+
+AsyncTraceStream::BatchBuffer::BatchBuffer(std::ostream* os, uint32_t batchSize)
+    : m_os(os),
+      m_batch(std::max<uint32_t>(batchSize, 1))
+{
+    setp(m_batch.data(), m_batch.data() + m_batch.size());
+}
+
+void
+AsyncTraceStream::BatchBuffer::Queue()
+{
+    if (pptr() != pbase())
+    {
+        AsyncTraceWriter::Write(m_os, std::string(pbase(), pptr()));
+        setp(m_batch.data(), m_batch.data() + m_batch.size());
+    }
+}
+
+void
+AsyncTraceStream::BatchBuffer::Wait()
+{
+    AsyncTraceWriter::Wait(m_os);
+}
+
+AsyncTraceStream::BatchBuffer::int_type
+AsyncTraceStream::BatchBuffer::overflow(int_type c)
+{
+    Queue();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+AsyncTraceStream::BatchBuffer::xsputn(const char* s, std::streamsize n)
+{
+    std::streamsize left = n;
+    while (left > 0)
+    {
+        if (pptr() == epptr())
+        {
+            Queue();
+        }
+        std::streamsize count = std::min<std::streamsize>(left, epptr() - pptr());
+        std::memcpy(pptr(), s, count);
+        pbump(static_cast<int>(count));
+        s += count;
+        left -= count;
+    }
+    return n;
+}
+
+int
+AsyncTraceStream::BatchBuffer::sync()
+{
+    Queue();
+    Wait();
+    // The background thread is done with the target stream until the next
+    // batch is queued, so it can be flushed here.
+    m_os->flush();
+    return m_os->fail() ? -1 : 0;
+}
+
+} // namespace ns3
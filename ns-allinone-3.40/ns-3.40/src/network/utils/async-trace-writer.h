@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_TRACE_WRITER_H
+#define ASYNC_TRACE_WRITER_H
+
+#include <ostream>
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief Writes the trace files on a background thread.
+ *
+ * The trace sinks run in the simulation thread.  With the
+ * \ref GlobalValueAsyncTraceBatchSize "AsyncTraceBatchSize" global value
+ * set, the pcap and ascii trace files do not write each record to their
+ * file stream: they append it to a buffer in memory and hand the buffer,
+ * once it holds that many bytes, to a single background thread which writes
+ * it to the file.  The batches of a stream are written in the order they
+ * were queued.
+ */
+class AsyncTraceWriter
+{
+  public:
+    /**
+     * \returns the value of the AsyncTraceBatchSize global value, i.e. the
+     * number of bytes written together, or 0 to write the trace files in the
+     * simulation thread
+     */
+    static uint32_t GetBatchSize();
+
+    /**
+     * Queue a batch of bytes to be written to a stream.
+     *
+     * \param os the stream, which must not be used by the caller until
+     *           Wait(os) returns
+     * \param batch the bytes
+     */
+    static void Write(std::ostream* os, std::string batch);
+
+    /**
+     * Wait until all the batches queued for a stream are written.
+     *
+     * \param os the stream
+     */
+    static void Wait(const std::ostream* os);
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief An output stream whose bytes are written to another stream by the
+ * AsyncTraceWriter.
+ *
+ * The bytes are handed to the background thread by batches of a fixed size.
+ * Flushing this stream, e.g. by FatalImpl on a fatal error, hands the bytes
+ * written so far to the background thread and waits until the target stream
+ * is written and flushed.  Since std::endl flushes the stream, trace sinks
+ * should end their records with '\n' to keep the batches.
+ */
+class AsyncTraceStream : public std::ostream
+{
+  public:
+    /**
+     * \param os the stream the batches are written to
+     * \param batchSize the number of bytes of a batch
+     */
+    AsyncTraceStream(std::ostream* os, uint32_t batchSize);
+    /// Write the remaining bytes and wait until they are written
+    ~AsyncTraceStream() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    AsyncTraceStream(const AsyncTraceStream&) = delete;
+    AsyncTraceStream& operator=(const AsyncTraceStream&) = delete;
+
+    /**
+     * Queue the bytes written so far, wait until all of them are written
+     * to the target stream and flush it, so that it can be used again by the
+     * caller.  This is what flushing the stream does.
+     */
+    void Sync();
+
+  private:
+    /// The buffer of the bytes of the batch being written
+    class BatchBuffer : public std::streambuf
+    {
+      public:
+        /**
+         * \param os the stream the batches are written to
+         * \param batchSize the number of bytes of a batch
+         */
+        BatchBuffer(std::ostream* os, uint32_t batchSize);
+
+        /// Queue the bytes written so far to the AsyncTraceWriter
+        void Queue();
+        /// Wait until the queued bytes are written
+        void Wait();
+
+      protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        /**
+         * Queue the bytes written so far, wait until they are written and
+         * flush the target stream
+         * \returns 0 on success, -1 if the target stream failed
+         */
+        int sync() override;
+
+      private:
+        std::ostream* m_os;        //!< the stream the batches are written to
+        std::vector<char> m_batch; //!< the bytes of the batch
+    };
+
+    BatchBuffer m_buffer; //!< the buffer of the stream
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_TRACE_WRITER_H */
@@ -17,6 +17,8 @@
 
 #include "output-stream-wrapper.h"
 
+#include "async-trace-writer.h"
+
 #include "ns3/abort.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/log.h"
@@ -29,12 +31,19 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE("OutputStreamWrapper");
 
 OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmode filemode)
-    : m_destroyable(true)
+    : m_file(nullptr),
+      m_destroyable(true)
 {
     NS_LOG_FUNCTION(this << filename << filemode);
     auto os = new std::ofstream();
     os->open(filename, filemode);
     m_ostream = os;
+    uint32_t batchSize = AsyncTraceWriter::GetBatchSize();
+    if (batchSize > 0)
+    {
+        m_file = os;
+        m_ostream = new AsyncTraceStream(m_file, batchSize);
+    }
     FatalImpl::RegisterStream(m_ostream);
     NS_ABORT_MSG_UNLESS(os->is_open(),
                         "AsciiTraceHelper::CreateFileStream():  "
@@ -43,6 +52,7 @@ OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmod
 
 OutputStreamWrapper::OutputStreamWrapper(std::ostream* os)
     : m_ostream(os),
+      m_file(nullptr),
       m_destroyable(false)
 {
     NS_LOG_FUNCTION(this << os);
@@ -57,8 +67,10 @@ OutputStreamWrapper::~OutputStreamWrapper()
     if (m_destroyable)
     {
         delete m_ostream;
+        delete m_file;
     }
     m_ostream = nullptr;
+    m_file = nullptr;
 }
 
 std::ostream*
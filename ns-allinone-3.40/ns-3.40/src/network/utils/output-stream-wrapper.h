@@ -73,6 +73,10 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
   public:
     /**
      * Constructor
+     *
+     * The file is written on a background thread when the
+     * AsyncTraceBatchSize global value is set (see AsyncTraceWriter).
+     *
      * \param filename file name
      * \param filemode std::ios::openmode flags
      */
@@ -95,6 +99,7 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 
   private:
     std::ostream* m_ostream; //!< The output stream
+    std::ofstream* m_file;   //!< The file written on a background thread, if any
     bool m_destroyable;      //!< Can be destroyed
 };
 
@@ -17,6 +17,8 @@
 
 #include "pcap-file-wrapper.h"
 
+#include "async-trace-writer.h"
+
 #include "ns3/boolean.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
@@ -96,6 +98,10 @@ PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
     m_file.Open(filename, mode);
+    if (mode & std::ios::out)
+    {
+        m_file.SetBatchSize(AsyncTraceWriter::GetBatchSize());
+    }
 }
 
 void
@@ -75,6 +75,8 @@ class PcapFileWrapper : public Object
      *
      * \param mode String containing the access mode for the file.
      *
+     * A file opened for writing writes its packets on a background thread
+     * when the AsyncTraceBatchSize global value is set (see AsyncTraceWriter).
      */
     void Open(const std::string& filename, std::ios::openmode mode);
 
@@ -19,6 +19,8 @@
 
 #include "pcap-file.h"
 
+#include "async-trace-writer.h"
+
 #include "ns3/assert.h"
 #include "ns3/buffer.h"
 #include "ns3/build-profile.h"
@@ -53,6 +55,7 @@ const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file form
 
 PcapFile::PcapFile()
     : m_file(),
+      m_out(&m_file),
       m_swapMode(false),
       m_nanosecMode(false)
 {
@@ -63,14 +66,20 @@ PcapFile::PcapFile()
 PcapFile::~PcapFile()
 {
     NS_LOG_FUNCTION(this);
-    FatalImpl::UnregisterStream(&m_file);
     Close();
+    FatalImpl::UnregisterStream(&m_file);
 }
 
 bool
 PcapFile::Fail() const
 {
     NS_LOG_FUNCTION(this);
+    // The background thread writes to m_file; the state of m_file can be read
+    // once it is done with the batches queued so far.
+    if (m_batchStream)
+    {
+        AsyncTraceWriter::Wait(&m_file);
+    }
     return m_file.fail();
 }
 
@@ -78,6 +87,10 @@ bool
 PcapFile::Eof() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_batchStream)
+    {
+        AsyncTraceWriter::Wait(&m_file);
+    }
     return m_file.eof();
 }
 
@@ -85,6 +98,10 @@ void
 PcapFile::Clear()
 {
     NS_LOG_FUNCTION(this);
+    if (m_batchStream)
+    {
+        AsyncTraceWriter::Wait(&m_file);
+    }
     m_file.clear();
 }
 
@@ -92,9 +109,39 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    StopBatches();
     m_file.close();
 }
 
+void
+PcapFile::SetBatchSize(uint32_t batchSize)
+{
+    NS_LOG_FUNCTION(this << batchSize);
+    StopBatches();
+    if (batchSize > 0)
+    {
+        m_batchStream = std::make_unique<AsyncTraceStream>(&m_file, batchSize);
+        m_out = m_batchStream.get();
+        // On a fatal error, the batch stream hands its bytes to the background
+        // thread and flushes the file once they are written.
+        FatalImpl::UnregisterStream(&m_file);
+        FatalImpl::RegisterStream(m_out);
+    }
+}
+
+void
+PcapFile::StopBatches()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_batchStream)
+    {
+        FatalImpl::UnregisterStream(m_out);
+        FatalImpl::RegisterStream(&m_file);
+        m_batchStream.reset();
+        m_out = &m_file;
+    }
+}
+
 uint32_t
 PcapFile::GetMagic()
 {
@@ -211,6 +258,10 @@ PcapFile::WriteFileHeader()
     // If we're initializing the file, we need to write the pcap file header
     // at the start of the file.
     //
+    if (m_batchStream)
+    {
+        m_batchStream->Sync();
+    }
     m_file.seekp(0, std::ios::beg);
 
     //
@@ -410,10 +461,10 @@ PcapFile::Init(uint32_t dataLinkType,
 }
 
 uint32_t
-PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
+PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t origLen)
 {
-    NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
-    NS_ASSERT(m_file.good());
+    NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen << origLen);
+    NS_ASSERT(m_out->good());
 
     uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -421,7 +472,7 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     header.m_tsSec = tsSec;
     header.m_tsUsec = tsUsec;
     header.m_inclLen = inclLen;
-    header.m_origLen = totalLen;
+    header.m_origLen = origLen;
 
     if (m_swapMode)
     {
@@ -432,11 +483,12 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
-    m_file.write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
-    m_file.write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
-    m_file.write((const char*)&header.m_origLen, sizeof(header.m_origLen));
-    NS_BUILD_DEBUG(m_file.flush());
+    m_out->write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
+    m_out->write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
+    m_out->write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
+    m_out->write((const char*)&header.m_origLen, sizeof(header.m_origLen));
+    // Flushing a batched stream would queue a batch per packet
+    NS_BUILD_DEBUG(if (!m_batchStream) { m_file.flush(); });
     return inclLen;
 }
 
@@ -444,18 +496,32 @@ void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint32_t totalLen)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
-    m_file.write((const char*)data, inclLen);
-    NS_BUILD_DEBUG(m_file.flush());
+    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen, totalLen);
+    m_out->write((const char*)data, inclLen);
+    NS_BUILD_DEBUG(if (!m_batchStream) { m_file.flush(); });
+}
+
+void
+PcapFile::Write(uint32_t tsSec,
+                uint32_t tsUsec,
+                const uint8_t* const data,
+                uint32_t inclLen,
+                uint32_t origLen)
+{
+    NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << inclLen << origLen);
+    NS_ASSERT_MSG(inclLen <= origLen, "More bytes than in the original packet");
+    inclLen = WritePacketHeader(tsSec, tsUsec, inclLen, origLen);
+    m_out->write((const char*)data, inclLen);
+    NS_BUILD_DEBUG(if (!m_batchStream) { m_file.flush(); });
 }
 
 void
 PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
-    p->CopyData(&m_file, inclLen);
-    NS_BUILD_DEBUG(m_file.flush());
+    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize(), p->GetSize());
+    p->CopyData(m_out, inclLen);
+    NS_BUILD_DEBUG(if (!m_batchStream) { m_file.flush(); });
 }
 
 void
@@ -464,15 +530,15 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &header << p);
     uint32_t headerSize = header.GetSerializedSize();
     uint32_t totalSize = headerSize + p->GetSize();
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalSize);
+    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalSize, totalSize);
 
     Buffer headerBuffer;
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
     uint32_t toCopy = std::min(headerSize, inclLen);
-    headerBuffer.CopyData(&m_file, toCopy);
+    headerBuffer.CopyData(m_out, toCopy);
     inclLen -= toCopy;
-    p->CopyData(&m_file, inclLen);
+    p->CopyData(m_out, inclLen);
 }
 
 void
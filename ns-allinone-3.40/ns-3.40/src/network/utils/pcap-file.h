@@ -23,6 +23,7 @@
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -31,6 +32,7 @@ namespace ns3
 
 class Packet;
 class Header;
+class AsyncTraceStream;
 
 /**
  * \brief A class representing a pcap file
@@ -86,6 +88,17 @@ class PcapFile
      */
     void Close();
 
+    /**
+     * Write the packets to the file on a background thread, by batches of
+     * batchSize bytes (see AsyncTraceWriter), until the file is closed.
+     * The file must have been opened with write permissions.  Fail(), Eof()
+     * and Clear() wait until the batches queued so far are written.
+     *
+     * \param batchSize the number of bytes of a batch, or 0 to write each
+     * packet to the file when it is written
+     */
+    void SetBatchSize(uint32_t batchSize);
+
     /**
      * Initialize the pcap file associated with this object.  This file must have
      * been previously opened with write permissions.
@@ -132,6 +145,23 @@ class PcapFile
      */
     void Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint32_t totalLen);
 
+    /**
+     * \brief Write next packet to file, keeping the original length of a
+     * packet which was truncated when it was captured
+     *
+     * \param tsSec       Packet timestamp, seconds
+     * \param tsUsec      Packet timestamp, microseconds
+     * \param data        Data buffer
+     * \param inclLen     Length of the data buffer
+     * \param origLen     Original length of the packet
+     *
+     */
+    void Write(uint32_t tsSec,
+               uint32_t tsUsec,
+               const uint8_t* const data,
+               uint32_t inclLen,
+               uint32_t origLen);
+
     /**
      * \brief Write next packet to file
      *
@@ -364,20 +394,33 @@ class PcapFile
      * \param tsSec Time stamp (seconds part)
      * \param tsUsec Time stamp (microseconds part)
      * \param totalLen total packet length
+     * \param origLen original packet length, which differs from totalLen if the
+     * packet was truncated before
      * \returns the length of the packet to write in the Pcap file
      */
-    uint32_t WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+    uint32_t WritePacketHeader(uint32_t tsSec,
+                               uint32_t tsUsec,
+                               uint32_t totalLen,
+                               uint32_t origLen);
 
     /**
      * \brief Read and verify a Pcap file header
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    /**
+     * \brief Write the remaining batches, if any, and write the next packets
+     * to the file directly
+     */
+    void StopBatches();
+
+    std::string m_filename;                          //!< file name
+    std::fstream m_file;                             //!< file stream
+    std::unique_ptr<AsyncTraceStream> m_batchStream; //!< stream of the batches, if any
+    std::ostream* m_out;                             //!< stream the packets are written to
+    PcapFileHeader m_fileHeader;                     //!< file header
+    bool m_swapMode;                                 //!< swap mode
+    bool m_nanosecMode;                              //!< nanosecond timestamp mode
 };
 
 } // namespace ns3
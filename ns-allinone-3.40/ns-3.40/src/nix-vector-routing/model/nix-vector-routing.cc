@@ -25,12 +25,14 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
 
 #include <iomanip>
+#include <limits>
 #include <queue>
 
 namespace ns3
@@ -55,6 +57,22 @@ template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap
     NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+std::vector<uint32_t> NixVectorRouting<T>::g_adjacencyOffset;
+
+template <typename T>
+std::vector<std::pair<uint32_t, uint32_t>> NixVectorRouting<T>::g_adjacency;
+
+template <typename T>
+std::vector<uint32_t> NixVectorRouting<T>::g_totalNeighbors;
+
+template <typename T>
+std::unordered_map<uint32_t, typename NixVectorRouting<T>::BfsTree>
+    NixVectorRouting<T>::g_bfsTrees;
+
+/// Parent of the nodes not reachable in a NixVectorRouting::BfsTree
+static const uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
 template <typename T>
 TypeId
 NixVectorRouting<T>::GetTypeId()
@@ -71,13 +89,20 @@ NixVectorRouting<T>::GetTypeId()
     static TypeId tid = TypeId(("ns3::" + name + "NixVectorRouting"))
                             .SetParent<T>()
                             .SetGroupName("NixVectorRouting")
-                            .template AddConstructor<NixVectorRouting<T>>();
+                            .template AddConstructor<NixVectorRouting<T>>()
+                            .AddAttribute("BfsTreeCache",
+                                          "Build the nix-vectors from one breadth first search "
+                                          "tree per source node, shared by all destinations.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&NixVectorRouting<T>::m_bfsTreeCache),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting()
-    : m_totalNeighbors(0)
+    : m_totalNeighbors(0),
+      m_bfsTreeCache(false)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -168,6 +193,12 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
+
+    // Same for the adjacency and the search trees built from it.
+    g_adjacencyOffset.clear();
+    g_adjacency.clear();
+    g_totalNeighbors.clear();
+    g_bfsTrees.clear();
 }
 
 template <typename T>
@@ -213,6 +244,15 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
         NS_LOG_DEBUG("Do not process packets to self");
         return nullptr;
     }
+    else if (m_bfsTreeCache && !oif)
+    {
+        if (BuildNixVectorFromTree(source->GetId(), destNode->GetId(), nixVector))
+        {
+            return nixVector;
+        }
+        NS_LOG_ERROR("No routing path exists");
+        return nullptr;
+    }
     else
     {
         // otherwise proceed as normal
@@ -1018,7 +1058,9 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
     {
         *os << std::setw(30) << "Destination";
         *os << "NixVector" << std::endl;
-        for (auto it = m_nixCache.begin(); it != m_nixCache.end(); it++)
+        // Print the destinations in order, the cache being a hash table
+        std::map<IpAddress, Ptr<NixVector>> nixCache(m_nixCache.begin(), m_nixCache.end());
+        for (auto it = nixCache.begin(); it != nixCache.end(); it++)
         {
             std::ostringstream dest;
             dest << it->first;
@@ -1041,7 +1083,9 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
         *os << std::setw(30) << "Gateway";
         *os << std::setw(30) << "Source";
         *os << "OutputDevice" << std::endl;
-        for (auto it = m_ipRouteCache.begin(); it != m_ipRouteCache.end(); it++)
+        std::map<IpAddress, Ptr<IpRoute>> ipRouteCache(m_ipRouteCache.begin(),
+                                                       m_ipRouteCache.end());
+        for (auto it = ipRouteCache.begin(); it != ipRouteCache.end(); it++)
         {
             std::ostringstream dest;
             std::ostringstream gw;
@@ -1282,6 +1326,150 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
     return false;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::BuildAdjacency() const
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t numberOfNodes = NodeList::GetNNodes();
+    g_adjacencyOffset.assign(1, 0);
+    g_adjacency.clear();
+    g_totalNeighbors.assign(numberOfNodes, 0);
+    g_bfsTrees.clear();
+
+    for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+        Ptr<Node> node = NodeList::GetNode(id);
+
+        // Number the neighbors as BuildNixVector() does, a node reachable
+        // through several devices keeping the index of the last one
+        std::unordered_map<uint32_t, uint32_t> neighborIndex;
+        uint32_t totalNeighbors = 0;
+        for (uint32_t i = 0; i < node->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (localNetDevice->IsBridge() || !channel)
+            {
+                continue;
+            }
+            NetDeviceContainer netDeviceContainer;
+            GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+            for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+            {
+                neighborIndex[(*iter)->GetNode()->GetId()] = totalNeighbors++;
+            }
+        }
+        g_totalNeighbors[id] = totalNeighbors;
+
+        // Keep the edges BFS() follows, in the order it follows them
+        Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol>();
+        for (uint32_t i = 0; i < node->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+            if (ip && !ip->IsUp(ip->GetInterfaceForDevice(localNetDevice)))
+            {
+                continue;
+            }
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!localNetDevice->IsLinkUp() || !channel)
+            {
+                continue;
+            }
+            NetDeviceContainer netDeviceContainer;
+            GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+            for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+            {
+                Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
+                if (!remoteIpInterface || !(remoteIpInterface->IsUp()))
+                {
+                    continue;
+                }
+                uint32_t remoteId = (*iter)->GetNode()->GetId();
+                auto index = neighborIndex.find(remoteId);
+                g_adjacency.emplace_back(remoteId,
+                                         index != neighborIndex.end() ? index->second : 0);
+            }
+        }
+        g_adjacencyOffset.push_back(g_adjacency.size());
+    }
+    NS_LOG_LOGIC("Adjacency of " << numberOfNodes << " nodes with " << g_adjacency.size()
+                                 << " edges");
+}
+
+template <typename T>
+const typename NixVectorRouting<T>::BfsTree&
+NixVectorRouting<T>::GetBfsTree(uint32_t source) const
+{
+    NS_LOG_FUNCTION(this << source);
+
+    if (g_totalNeighbors.size() != NodeList::GetNNodes())
+    {
+        BuildAdjacency();
+    }
+
+    auto iter = g_bfsTrees.find(source);
+    if (iter != g_bfsTrees.end())
+    {
+        return iter->second;
+    }
+
+    NS_LOG_LOGIC("Searching from Node " << source);
+    uint32_t numberOfNodes = g_totalNeighbors.size();
+    BfsTree& tree = g_bfsTrees[source];
+    tree.parent.assign(numberOfNodes, NO_PARENT);
+    tree.index.assign(numberOfNodes, 0);
+
+    // The queue holds every node once, so a vector and its head will do
+    std::vector<uint32_t> greyNodeList;
+    greyNodeList.reserve(numberOfNodes);
+    greyNodeList.push_back(source);
+    tree.parent[source] = source;
+    for (std::size_t head = 0; head < greyNodeList.size(); head++)
+    {
+        uint32_t currNode = greyNodeList[head];
+        for (uint32_t edge = g_adjacencyOffset[currNode]; edge < g_adjacencyOffset[currNode + 1];
+             edge++)
+        {
+            uint32_t remoteNode = g_adjacency[edge].first;
+            if (tree.parent[remoteNode] == NO_PARENT)
+            {
+                tree.parent[remoteNode] = currNode;
+                tree.index[remoteNode] = g_adjacency[edge].second;
+                greyNodeList.push_back(remoteNode);
+            }
+        }
+    }
+    return tree;
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::BuildNixVectorFromTree(uint32_t source,
+                                            uint32_t dest,
+                                            Ptr<NixVector> nixVector) const
+{
+    NS_LOG_FUNCTION(this << source << dest << nixVector);
+
+    const BfsTree& tree = GetBfsTree(source);
+    if (dest >= tree.parent.size() || tree.parent[dest] == NO_PARENT)
+    {
+        return false;
+    }
+
+    for (uint32_t node = dest; node != source; node = tree.parent[node])
+    {
+        uint32_t parentNode = tree.parent[node];
+        NS_LOG_LOGIC("Adding Nix: " << tree.index[node] << " with "
+                                    << nixVector->BitCount(g_totalNeighbors[parentNode])
+                                    << " bits, for node " << parentNode);
+        nixVector->AddNeighborIndex(tree.index[node],
+                                    nixVector->BitCount(g_totalNeighbors[parentNode]));
+    }
+    return true;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::PrintRoutingPath(Ptr<Node> source,
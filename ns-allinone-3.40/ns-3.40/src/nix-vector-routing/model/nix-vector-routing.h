@@ -271,6 +271,40 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
              std::vector<Ptr<Node>>& parentVector,
              Ptr<NetDevice> oif) const;
 
+    /**
+     * Breadth first search tree from a source node to all the nodes,
+     * shared by all the destinations of the source.
+     */
+    struct BfsTree
+    {
+        std::vector<uint32_t> parent; //!< Parent of each node, or UINT32_MAX if unreachable.
+        std::vector<uint32_t> index;  //!< Neighbor index of each node at its parent.
+    };
+
+    /**
+     * Build the adjacency of all the nodes, as followed by BFS() and
+     * numbered by BuildNixVector().
+     */
+    void BuildAdjacency() const;
+
+    /**
+     * Get the breadth first search tree of a source node, searching
+     * the adjacency if the tree is not in the cache.
+     * \param [in] source Source Node index
+     * \returns The tree.
+     */
+    const BfsTree& GetBfsTree(uint32_t source) const;
+
+    /**
+     * Build a nix-vector from the breadth first search tree of the
+     * source; the same as BFS() followed by BuildNixVector().
+     * \param [in] source Source Node index
+     * \param [in] dest Destination Node index
+     * \param [out] nixVector the NixVector to be used for routing
+     * \returns false if dest is not reachable, true o.w.
+     */
+    bool BuildNixVectorFromTree(uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const;
+
     /**
      * \sa Ipv4RoutingProtocol::DoInitialize
      * \sa Ipv6RoutingProtocol::DoInitialize
@@ -284,9 +318,9 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     void DoDispose();
 
     /// Map of IpAddress to NixVector
-    typedef std::map<IpAddress, Ptr<NixVector>> NixMap_t;
+    typedef std::unordered_map<IpAddress, Ptr<NixVector>, IpAddressHash> NixMap_t;
     /// Map of IpAddress to IpRoute
-    typedef std::map<IpAddress, Ptr<IpRoute>> IpRouteMap_t;
+    typedef std::unordered_map<IpAddress, Ptr<IpRoute>, IpAddressHash> IpRouteMap_t;
 
     /// Callback for IPv4 unicast packets to be forwarded
     typedef Callback<void, Ptr<IpRoute>, Ptr<const Packet>, const IpHeader&>
@@ -503,6 +537,21 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     /** Total neighbors used for nix-vector to determine number of bits */
     uint32_t m_totalNeighbors;
 
+    /** Build the nix-vectors from the shared breadth first search trees */
+    bool m_bfsTreeCache;
+
+    /**
+     * Start of the neighbors of each node in g_adjacency, followed by
+     * the end of the neighbors of the last node.
+     */
+    static std::vector<uint32_t> g_adjacencyOffset;
+    /** Node index and neighbor index of the neighbors of all the nodes. */
+    static std::vector<std::pair<uint32_t, uint32_t>> g_adjacency;
+    /** Total neighbors of each node, as numbered by BuildNixVector(). */
+    static std::vector<uint32_t> g_totalNeighbors;
+    /** Breadth first search tree of each source node index. */
+    static std::unordered_map<uint32_t, BfsTree> g_bfsTrees;
+
     /**
      * Mapping of IP address to ns-3 node.
      *
@@ -17,6 +17,7 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -25,6 +26,7 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -60,11 +62,15 @@ using namespace ns3;
  * (Set down the interface of nC on nB-nC channel.)
  * - Test that routing is not possible from nSrc to nDst.
  *
+ * The test is run with the nix-vectors built by a search per
+ * destination, and from the search trees shared by all destinations.
+ *
  * \brief IPv4 Nix-Vector Routing Test
  */
 class NixVectorRoutingTest : public TestCase
 {
     Ptr<Packet> m_receivedPacket; //!< Received packet
+    bool m_bfsTreeCache;          //!< Use the shared search trees
 
     /**
      * \brief Send data immediately after being called.
@@ -98,7 +104,11 @@ class NixVectorRoutingTest : public TestCase
 
   public:
     void DoRun() override;
-    NixVectorRoutingTest();
+    /**
+     * Constructor.
+     * \param bfsTreeCache Value of the BfsTreeCache attribute of the routing.
+     */
+    NixVectorRoutingTest(bool bfsTreeCache);
 
     /**
      * \brief Receive data.
@@ -109,8 +119,10 @@ class NixVectorRoutingTest : public TestCase
     std::vector<uint32_t> m_receivedPacketSizes; //!< Received packet sizes
 };
 
-NixVectorRoutingTest::NixVectorRoutingTest()
-    : TestCase("three router, two path test")
+NixVectorRoutingTest::NixVectorRoutingTest(bool bfsTreeCache)
+    : TestCase(std::string("three router, two path test") +
+               (bfsTreeCache ? ", shared search trees" : "")),
+      m_bfsTreeCache(bfsTreeCache)
 {
 }
 
@@ -212,6 +224,13 @@ NixVectorRoutingTest::DoRun()
     stack.SetRoutingHelper(ipv4NixRouting); // has effect on the next Install ()
     stack.SetRoutingHelper(ipv6NixRouting); // has effect on the next Install ()
     stack.Install(allNodes);
+    for (auto i = allNodes.Begin(); i != allNodes.End(); i++)
+    {
+        (*i)->GetObject<Ipv4NixVectorRouting>()->SetAttribute("BfsTreeCache",
+                                                             BooleanValue(m_bfsTreeCache));
+        (*i)->GetObject<Ipv6NixVectorRouting>()->SetAttribute("BfsTreeCache",
+                                                             BooleanValue(m_bfsTreeCache));
+    }
 
     NetDeviceContainer dSrcdA;
     NetDeviceContainer dAdB;
@@ -405,7 +424,8 @@ class NixVectorRoutingTestSuite : public TestSuite
     NixVectorRoutingTestSuite()
         : TestSuite("nix-vector-routing", UNIT)
     {
-        AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingTest(false), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingTest(true), TestCase::QUICK);
     }
 };
 
@@ -239,25 +239,43 @@ PointToPointHelper::Install(Ptr<Node> a, Ptr<Node> b)
 {
     NetDeviceContainer container;
 
+    // The devices of ghost nodes never send packets, so they get no queue
+    bool ghostA = a->IsGhost();
+    bool ghostB = b->IsGhost();
+
     Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice>();
     devA->SetAddress(Mac48Address::Allocate());
     a->AddDevice(devA);
-    Ptr<Queue<Packet>> queueA = m_queueFactory.Create<Queue<Packet>>();
-    devA->SetQueue(queueA);
+    Ptr<Queue<Packet>> queueA;
+    if (!ghostA)
+    {
+        queueA = m_queueFactory.Create<Queue<Packet>>();
+        devA->SetQueue(queueA);
+    }
     Ptr<PointToPointNetDevice> devB = m_deviceFactory.Create<PointToPointNetDevice>();
     devB->SetAddress(Mac48Address::Allocate());
     b->AddDevice(devB);
-    Ptr<Queue<Packet>> queueB = m_queueFactory.Create<Queue<Packet>>();
-    devB->SetQueue(queueB);
+    Ptr<Queue<Packet>> queueB;
+    if (!ghostB)
+    {
+        queueB = m_queueFactory.Create<Queue<Packet>>();
+        devB->SetQueue(queueB);
+    }
     if (m_enableFlowControl)
     {
         // Aggregate NetDeviceQueueInterface objects
-        Ptr<NetDeviceQueueInterface> ndqiA = CreateObject<NetDeviceQueueInterface>();
-        ndqiA->GetTxQueue(0)->ConnectQueueTraces(queueA);
-        devA->AggregateObject(ndqiA);
-        Ptr<NetDeviceQueueInterface> ndqiB = CreateObject<NetDeviceQueueInterface>();
-        ndqiB->GetTxQueue(0)->ConnectQueueTraces(queueB);
-        devB->AggregateObject(ndqiB);
+        if (!ghostA)
+        {
+            Ptr<NetDeviceQueueInterface> ndqiA = CreateObject<NetDeviceQueueInterface>();
+            ndqiA->GetTxQueue(0)->ConnectQueueTraces(queueA);
+            devA->AggregateObject(ndqiA);
+        }
+        if (!ghostB)
+        {
+            Ptr<NetDeviceQueueInterface> ndqiB = CreateObject<NetDeviceQueueInterface>();
+            ndqiB->GetTxQueue(0)->ConnectQueueTraces(queueB);
+            devB->AggregateObject(ndqiB);
+        }
     }
 
     Ptr<PointToPointChannel> channel = nullptr;
@@ -286,12 +304,19 @@ PointToPointHelper::Install(Ptr<Node> a, Ptr<Node> b)
     {
         m_channelFactory.SetTypeId("ns3::PointToPointRemoteChannel");
         channel = m_channelFactory.Create<PointToPointRemoteChannel>();
-        Ptr<MpiReceiver> mpiRecA = CreateObject<MpiReceiver>();
-        Ptr<MpiReceiver> mpiRecB = CreateObject<MpiReceiver>();
-        mpiRecA->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devA));
-        mpiRecB->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devB));
-        devA->AggregateObject(mpiRecA);
-        devB->AggregateObject(mpiRecB);
+        // Only the devices of the local nodes receive packets from the other ranks
+        if (!ghostA)
+        {
+            Ptr<MpiReceiver> mpiRecA = CreateObject<MpiReceiver>();
+            mpiRecA->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devA));
+            devA->AggregateObject(mpiRecA);
+        }
+        if (!ghostB)
+        {
+            Ptr<MpiReceiver> mpiRecB = CreateObject<MpiReceiver>();
+            mpiRecB->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, devB));
+            devB->AggregateObject(mpiRecB);
+        }
     }
 #else
     channel = m_channelFactory.Create<PointToPointChannel>();
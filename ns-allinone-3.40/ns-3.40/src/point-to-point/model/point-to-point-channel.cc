@@ -19,11 +19,14 @@
 
 #include "point-to-point-net-device.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -44,6 +47,13 @@ PointToPointChannel::GetTypeId()
                           TimeValue(Seconds(0)),
                           MakeTimeAccessor(&PointToPointChannel::m_delay),
                           MakeTimeChecker())
+            .AddAttribute("DeepCopy",
+                          "Serialize each packet for the receiver, so that it shares no data "
+                          "with the copies held by the sender; HybridSimulatorImpl sets it on "
+                          "the links between its threads",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PointToPointChannel::m_deepCopy),
+                          MakeBooleanChecker())
             .AddTraceSource("TxRxPointToPoint",
                             "Trace source indicating transmission of packet "
                             "from the PointToPointChannel, used by the Animation "
@@ -59,7 +69,8 @@ PointToPointChannel::GetTypeId()
 PointToPointChannel::PointToPointChannel()
     : Channel(),
       m_delay(Seconds(0.)),
-      m_nDevices(0)
+      m_nDevices(0),
+      m_deepCopy(false)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -96,14 +107,27 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+    Ptr<Packet> copy;
+    if (m_deepCopy)
+    {
+        // The receiver may run on another thread, which must not share
+        // the buffers, metadata and tags of the packet with this one
+        std::vector<uint8_t> buffer(p->GetSerializedSize());
+        p->Serialize(buffer.data(), buffer.size());
+        copy = Create<Packet>(buffer.data(), buffer.size(), true);
+    }
+    else
+    {
+        copy = p->Copy();
+    }
     Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
                                    m_link[wire].m_dst,
-                                   p->Copy());
+                                   copy);
 
     // Call the tx anim callback on the net device
-    m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    NS_TRACE(m_txrxPointToPoint, p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
     return true;
 }
 
@@ -153,6 +153,7 @@ class PointToPointChannel : public Channel
 
     Time m_delay;           //!< Propagation delay
     std::size_t m_nDevices; //!< Devices of this channel
+    bool m_deepCopy;        //!< Serialize the packets for the receiver
 
     /**
      * The trace source for the packet transmission animation events that the
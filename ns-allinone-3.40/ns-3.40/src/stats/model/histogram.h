@@ -102,6 +102,14 @@ class Histogram
      */
     void AddValue(double value);
 
+    /**
+     * \brief Add a number of data to a bin, e.g., to merge two histograms
+     * with the same bin width
+     * \param index the bin index
+     * \param count the number of data to add to the bin
+     */
+    void AddBinCount(uint32_t index, uint32_t count);
+
     /**
      * Clear the histogram content.
      */
@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the configuration of the devices
+// of a large topology through the Config paths: one path per node, all
+// the paths in a batch, a wildcard path, and a resolved wildcard path
+// applied repeatedly.
+// Sample usage:  ./ns3 run 'bench-config --nodes=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/// The number of packets dropped, as seen by the trace sinks.
+static uint64_t g_drops = 0;
+
+/**
+ * Trace sink of the PhyRxDrop trace source of the devices.
+ *
+ * \param context The context of the trace source.
+ * \param packet The packet dropped.
+ */
+static void
+DropWithContext(std::string context, Ptr<const Packet> packet)
+{
+    g_drops++;
+}
+
+/**
+ * Print the duration of an operation.
+ *
+ * \param what The operation.
+ * \param count The number of paths it handled.
+ * \param ms The duration, in milliseconds.
+ */
+static void
+Report(std::string what, uint32_t count, int64_t ms)
+{
+    std::cout << what << ": " << count << " paths in " << ms << " ms";
+    if (ms > 0)
+    {
+        std::cout << " (" << (1000 * static_cast<uint64_t>(count) / ms) << " per second)";
+    }
+    std::cout << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nodes = 10000;
+    uint32_t repeat = 10;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the configuration of the devices of many nodes through Config paths");
+    cmd.AddValue("nodes", "number of nodes", nodes);
+    cmd.AddValue("repeat", "number of times the resolved wildcard path is applied", repeat);
+    cmd.Parse(argc, argv);
+
+    if (nodes < 1 || nodes > 1000000)
+    {
+        std::cerr << "Error-- the number of nodes must be between 1 and 1000000" << std::endl;
+        exit(1);
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < nodes; i++)
+    {
+        Ptr<Node> node = CreateObject<Node>();
+        node->AddDevice(CreateObject<SimpleNetDevice>());
+    }
+    std::cout << "created " << nodes << " nodes in " << time.End() << " ms" << std::endl;
+
+    std::vector<std::string> rates;
+    std::vector<std::string> drops;
+    for (uint32_t i = 0; i < nodes; i++)
+    {
+        std::string device = "/NodeList/" + std::to_string(i) + "/DeviceList/0/";
+        rates.push_back(device + "$ns3::SimpleNetDevice/DataRate");
+        drops.push_back(device + "$ns3::SimpleNetDevice/PhyRxDrop");
+    }
+
+    time.Start();
+    for (uint32_t i = 0; i < nodes; i++)
+    {
+        Config::Set(rates[i], DataRateValue(DataRate("1Gb/s")));
+    }
+    Report("Config::Set", nodes, time.End());
+
+    time.Start();
+    Config::SetBatch(rates, DataRateValue(DataRate("10Gb/s")));
+    Report("Config::SetBatch", nodes, time.End());
+
+    time.Start();
+    Config::Set("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/DataRate",
+                DataRateValue(DataRate("1Gb/s")));
+    Report("Config::Set (wildcard)", nodes, time.End());
+
+    time.Start();
+    Config::MatchContainer devices =
+        Config::LookupMatches("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice");
+    for (uint32_t i = 0; i < repeat; i++)
+    {
+        devices.Set("DataRate", DataRateValue(DataRate(i % 2 ? "1Gb/s" : "10Gb/s")));
+    }
+    Report("Config::LookupMatches (wildcard, " + std::to_string(repeat) + " sets)",
+           nodes,
+           time.End());
+
+    time.Start();
+    for (uint32_t i = 0; i < nodes; i++)
+    {
+        Config::Connect(drops[i], MakeCallback(&DropWithContext));
+    }
+    Report("Config::Connect", nodes, time.End());
+
+    time.Start();
+    Config::ConnectBatch(drops, MakeCallback(&DropWithContext));
+    Report("Config::ConnectBatch", nodes, time.End());
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the demultiplexing of the packets
+// received by a node to its IPv4 and IPv6 end points, as on a server with
+// many connections on a same port and many listening ports.
+// Sample usage:  ./ns3 run 'bench-end-point-demux --endpoints=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \returns an IPv4 peer address
+ * \param i The index of the peer
+ */
+static Ipv4Address
+MakeAddress4(uint32_t i)
+{
+    return Ipv4Address(0x0a010000 + i);
+}
+
+/**
+ * \returns an IPv6 peer address
+ * \param i The index of the peer
+ */
+static Ipv6Address
+MakeAddress6(uint32_t i)
+{
+    uint8_t address[16] = {0x20, 0x01, 0x00, 0x01};
+    address[12] = (i >> 24) & 0xff;
+    address[13] = (i >> 16) & 0xff;
+    address[14] = (i >> 8) & 0xff;
+    address[15] = i & 0xff;
+    return Ipv6Address(address);
+}
+
+/**
+ * Benchmark a demultiplexer: half of the end points are listening on
+ * their own port, and the other half are connections to port 80, which
+ * also has a listener.
+ *
+ * \tparam Demux The type of the demultiplexer.
+ * \tparam Address The type of the addresses.
+ * \tparam Interface The type of the interfaces.
+ * \param name The name of the demultiplexer.
+ * \param local The local address.
+ * \param makeAddress The function making the address of a peer.
+ * \param endPoints The number of end points.
+ * \param lookups The number of lookups.
+ */
+template <typename Demux, typename Address, typename Interface>
+static void
+Bench(std::string name,
+      Address local,
+      Address (*makeAddress)(uint32_t),
+      uint32_t endPoints,
+      uint32_t lookups)
+{
+    Demux demux;
+    Ptr<Interface> iface = CreateObject<Interface>();
+    uint32_t connections = endPoints / 2;
+    uint32_t listeners = endPoints - connections;
+
+    SystemWallClockMs time;
+    time.Start();
+    demux.Allocate(nullptr, 80);
+    for (uint32_t i = 1; i < listeners; i++)
+    {
+        demux.Allocate(nullptr, 1000 + i);
+    }
+    for (uint32_t i = 0; i < connections; i++)
+    {
+        demux.Allocate(nullptr, local, 80, makeAddress(i), 10000 + i % 50000);
+    }
+    std::cout << name << ": allocated " << endPoints << " end points in " << time.End() << " ms"
+              << std::endl;
+
+    std::vector<Address> peers;
+    for (uint32_t i = 0; i < connections + 1; i++)
+    {
+        peers.push_back(makeAddress(i));
+    }
+    uint64_t found = 0;
+    time.Start();
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        // A packet of a connection (or, from the last peer, a connection
+        // request to port 80), or a packet to another listening port
+        uint32_t peer = (i * 7919) % peers.size();
+        switch (i % 3)
+        {
+        case 0:
+        case 1:
+            found += demux.Lookup(local, 80, peers[peer], 10000 + peer % 50000, iface).size();
+            break;
+        default:
+            found += demux.Lookup(local, 1000 + peer % listeners, peers[peer], 5, iface).size();
+            break;
+        }
+    }
+    int64_t ms = time.End();
+    std::cout << name << ": " << lookups << " lookups (" << found << " found) in " << ms << " ms";
+    if (ms > 0)
+    {
+        std::cout << " (" << (1000 * static_cast<uint64_t>(lookups) / ms) << " per second)";
+    }
+    std::cout << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t endPoints = 10000;
+    uint32_t lookups = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the demultiplexing of packets to the end points of a node");
+    cmd.AddValue("endpoints", "number of end points", endPoints);
+    cmd.AddValue("lookups", "number of lookups", lookups);
+    cmd.Parse(argc, argv);
+
+    if (endPoints < 2 || endPoints > 100000)
+    {
+        std::cerr << "Error-- the number of end points must be between 2 and 100000" << std::endl;
+        exit(1);
+    }
+
+    Bench<Ipv4EndPointDemux, Ipv4Address, Ipv4Interface>("IPv4",
+                                                         Ipv4Address("10.0.0.1"),
+                                                         MakeAddress4,
+                                                         endPoints,
+                                                         lookups);
+    Bench<Ipv6EndPointDemux, Ipv6Address, Ipv6Interface>("IPv6",
+                                                         Ipv6Address("2001:2::1"),
+                                                         MakeAddress6,
+                                                         endPoints,
+                                                         lookups);
+    return 0;
+}
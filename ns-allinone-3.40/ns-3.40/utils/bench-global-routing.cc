@@ -0,0 +1,142 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the startup time of global routing,
+// i.e. Ipv4GlobalRoutingHelper::PopulateRoutingTables (), on a k-ary fat tree
+// of (5/4) k^2 switches and k^3/4 hosts.
+// Sample usage:  ./ns3 run 'bench-global-routing --k=16 --threads=0'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Connect two nodes with a point-to-point link on a new /30 network.
+ *
+ * \param a One node.
+ * \param b The other node.
+ * \param devHelper The device helper.
+ * \param ipv4 The address helper.
+ */
+static void
+Connect(Ptr<Node> a, Ptr<Node> b, SimpleNetDeviceHelper& devHelper, Ipv4AddressHelper& ipv4)
+{
+    ipv4.Assign(devHelper.Install(NodeContainer(a, b)));
+    ipv4.NewNetwork();
+}
+
+/**
+ * Build a k-ary fat tree.
+ *
+ * \param k The number of ports of the switches.
+ * \returns The number of links.
+ */
+static uint32_t
+BuildFatTree(uint32_t k)
+{
+    uint32_t half = k / 2;
+    NodeContainer core;
+    core.Create(half * half);
+    NodeContainer aggregation;
+    aggregation.Create(k * half);
+    NodeContainer edge;
+    edge.Create(k * half);
+    NodeContainer hosts;
+    hosts.Create(k * half * half);
+
+    InternetStackHelper internet;
+    internet.Install(NodeContainer(core, aggregation, edge, hosts));
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+
+    uint32_t links = 0;
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        for (uint32_t i = 0; i < half; i++)
+        {
+            Ptr<Node> agg = aggregation.Get(pod * half + i);
+            for (uint32_t j = 0; j < half; j++)
+            {
+                Connect(core.Get(i * half + j), agg, devHelper, ipv4);
+                Connect(agg, edge.Get(pod * half + j), devHelper, ipv4);
+                links += 2;
+            }
+            Ptr<Node> sw = edge.Get(pod * half + i);
+            for (uint32_t j = 0; j < half; j++)
+            {
+                Connect(sw, hosts.Get((pod * half + i) * half + j), devHelper, ipv4);
+                links++;
+            }
+        }
+    }
+    return links;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t k = 8;
+    uint32_t threads = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the global routing startup time");
+    cmd.AddValue("k", "number of ports of the fat tree switches", k);
+    cmd.AddValue("threads", "number of threads, 0 for one per hardware thread", threads);
+    cmd.Parse(argc, argv);
+
+    if (k < 2 || k % 2)
+    {
+        std::cerr << "Error-- the number of ports must be even, by --k=(ports)" << std::endl;
+        exit(1);
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    uint32_t links = BuildFatTree(k);
+    std::cout << "Built a fat tree of " << (5 * k * k / 4) << " switches, " << (k * k * k / 4)
+              << " hosts and " << links << " links in " << time.End() << " ms" << std::endl;
+
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(1));
+    time.Start();
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::cout << "Computed the routes on 1 thread in " << time.End() << " ms" << std::endl;
+
+    if (threads != 1)
+    {
+        Config::SetGlobal("GlobalRoutingThreads", UintegerValue(threads));
+        time.Start();
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+        std::cout << "Computed the routes on " << (threads ? std::to_string(threads) : "all")
+                  << " threads in " << time.End() << " ms" << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
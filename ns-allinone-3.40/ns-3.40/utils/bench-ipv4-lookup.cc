@@ -0,0 +1,213 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the route lookup of the global and
+// static routing protocols, i.e. the cost of forwarding a packet, with and
+// without the compiled lookup tables.  The routing table holds host routes,
+// as global routing computes on a fat tree, and network routes.
+// Sample usage:  ./ns3 run 'bench-ipv4-lookup --hosts=4096 --networks=256'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Add the routes of the benchmark to a routing protocol.
+ *
+ * \tparam Routing The type of the routing protocol.
+ * \param routing The routing protocol.
+ * \param hosts The number of host routes.
+ * \param networks The number of network routes.
+ * \param interfaces The number of interfaces the routes go through.
+ */
+template <typename Routing>
+static void
+AddRoutes(Ptr<Routing> routing, uint32_t hosts, uint32_t networks, uint32_t interfaces)
+{
+    for (uint32_t i = 0; i < hosts; i++)
+    {
+        uint32_t interface = 1 + i % interfaces;
+        routing->AddHostRouteTo(Ipv4Address(0x0b000000 + i),
+                                Ipv4Address(0x0a000002 + (interface << 8)),
+                                interface);
+    }
+    for (uint32_t i = 0; i < networks; i++)
+    {
+        uint32_t interface = 1 + i % interfaces;
+        routing->AddNetworkRouteTo(Ipv4Address(0x0c000000 + (i << 8)),
+                                   Ipv4Mask("255.255.255.0"),
+                                   Ipv4Address(0x0a000002 + (interface << 8)),
+                                   interface);
+    }
+}
+
+/**
+ * Look the routes to the destinations up.
+ *
+ * \tparam Routing The type of the routing protocol.
+ * \param routing The routing protocol.
+ * \param destinations The destinations.
+ * \param lookups The number of lookups.
+ * \param devices The output device of the route to each destination.
+ * \returns The time of the lookups, in ms.
+ */
+template <typename Routing>
+static int64_t
+Lookup(Ptr<Routing> routing,
+       const std::vector<Ipv4Address>& destinations,
+       uint32_t lookups,
+       std::vector<Ptr<NetDevice>>& devices)
+{
+    devices.assign(destinations.size(), nullptr);
+    Ipv4Header header;
+    Socket::SocketErrno error;
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        uint32_t j = i % destinations.size();
+        header.SetDestination(destinations[j]);
+        Ptr<Ipv4Route> route = routing->RouteOutput(nullptr, header, nullptr, error);
+        devices[j] = route ? route->GetOutputDevice() : nullptr;
+    }
+    return time.End();
+}
+
+/**
+ * Benchmark a routing protocol with the scan of its routes and with the
+ * compiled lookup tables.
+ *
+ * \tparam Routing The type of the routing protocol.
+ * \param name The name of the routing protocol.
+ * \param ipv4 The IPv4 stack.
+ * \param hosts The number of host routes.
+ * \param networks The number of network routes.
+ * \param interfaces The number of interfaces the routes go through.
+ * \param destinations The destinations.
+ * \param lookups The number of lookups.
+ */
+template <typename Routing>
+static void
+Bench(std::string name,
+      Ptr<Ipv4> ipv4,
+      uint32_t hosts,
+      uint32_t networks,
+      uint32_t interfaces,
+      const std::vector<Ipv4Address>& destinations,
+      uint32_t lookups)
+{
+    std::vector<Ptr<NetDevice>> expected;
+    std::vector<Ptr<NetDevice>> devices;
+    for (bool compiled : {false, true})
+    {
+        Ptr<Routing> routing = CreateObject<Routing>();
+        routing->SetAttribute("CompiledLookup", BooleanValue(compiled));
+        routing->SetIpv4(ipv4);
+        AddRoutes(routing, hosts, networks, interfaces);
+        int64_t ms = Lookup(routing, destinations, lookups, compiled ? devices : expected);
+        std::cout << name << (compiled ? " compiled" : " scan") << ": " << lookups
+                  << " lookups in " << ms << " ms";
+        if (ms > 0)
+        {
+            std::cout << " (" << (1000 * static_cast<uint64_t>(lookups) / ms) << " per second)";
+        }
+        std::cout << std::endl;
+        routing->Dispose();
+    }
+    if (devices != expected)
+    {
+        std::cerr << "Error-- " << name << " routes differ" << std::endl;
+        exit(1);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t hosts = 4096;
+    uint32_t networks = 256;
+    uint32_t interfaces = 8;
+    uint32_t lookups = 10000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the route lookup of the global and static routing protocols");
+    cmd.AddValue("hosts", "number of host routes", hosts);
+    cmd.AddValue("networks", "number of /24 network routes", networks);
+    cmd.AddValue("interfaces", "number of interfaces", interfaces);
+    cmd.AddValue("lookups", "number of lookups", lookups);
+    cmd.Parse(argc, argv);
+
+    if (interfaces < 1 || interfaces > 250 || hosts > (1 << 24) || networks > (1 << 16))
+    {
+        std::cerr << "Error-- too many routes or interfaces" << std::endl;
+        exit(1);
+    }
+
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.1.0", "255.255.255.0");
+    for (uint32_t i = 0; i < interfaces; i++)
+    {
+        ipv4.Assign(devHelper.Install(node));
+        ipv4.NewNetwork();
+    }
+
+    // Destinations with a host route, with a network route, and without route
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    std::vector<Ipv4Address> destinations;
+    for (uint32_t i = 0; i < 1024; i++)
+    {
+        uint32_t kind = random->GetInteger(0, 9);
+        if (kind < 6 && hosts > 0)
+        {
+            destinations.emplace_back(0x0b000000 + random->GetInteger(0, hosts - 1));
+        }
+        else if (kind < 9 && networks > 0)
+        {
+            destinations.emplace_back(0x0c000000 + (random->GetInteger(0, networks - 1) << 8) +
+                                      random->GetInteger(1, 254));
+        }
+        else
+        {
+            destinations.emplace_back(0x0d000000 + random->GetInteger(0, 0xffff));
+        }
+    }
+
+    Ptr<Ipv4> ip = node->GetObject<Ipv4>();
+    Bench<Ipv4GlobalRouting>("global", ip, hosts, networks, interfaces, destinations, lookups);
+    Bench<Ipv4StaticRouting>("static", ip, hosts, networks, interfaces, destinations, lookups);
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -22,9 +22,11 @@
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
 #include "ns3/command-line.h"
+#include "ns3/drop-tail-queue.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
 #include "ns3/system-wall-clock-ms.h"
+#include "ns3/traced-callback.h"
 
 #include <algorithm>
 #include <iostream>
@@ -350,6 +352,47 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchQueue(uint32_t n)
+{
+    Ptr<DropTailQueue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+    Ptr<Packet> p = Create<Packet>(2000);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        queue->Enqueue(p);
+        queue->Dequeue();
+    }
+}
+
+static uint32_t g_sinkCalls = 0; //!< Number of calls of TraceSink
+
+/**
+ * Trace sink counting its calls
+ * \param p The traced packet
+ */
+static void
+TraceSink(Ptr<const Packet> p)
+{
+    g_sinkCalls++;
+}
+
+static void
+benchTraceSources(uint32_t n)
+{
+    // The trace sources a packet fires on its way through a point-to-point
+    // device; only the last one has a sink
+    TracedCallback<Ptr<const Packet>> traces[4];
+    traces[3].ConnectWithoutContext(MakeCallback(&TraceSink));
+    Ptr<Packet> p = Create<Packet>(2000);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (auto& trace : traces)
+        {
+            NS_TRACE(trace, p);
+        }
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -407,6 +450,8 @@ main(int argc, char* argv[])
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchQueue, n, minIterations, "Enqueue and dequeue");
+    runBench(&benchTraceSources, n, minIterations, "Fire trace sources");
 
     return 0;
 }
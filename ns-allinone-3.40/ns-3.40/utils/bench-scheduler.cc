@@ -283,6 +283,9 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
         m_scheduler += " (default)";
     }
 
+    uint64_t allocated = EventImpl::GetAllocatedCount();
+    uint64_t recycled = EventImpl::GetRecycledCount();
+
     Bench bench(pop, total);
     bench.SetRandomStream(eventStream);
     bench.SetPopulation(pop);
@@ -304,6 +307,9 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
         m_results.back().Log(i);
     }
 
+    LOG("Events allocated: " << EventImpl::GetAllocatedCount() - allocated
+                             << ", recycled: " << EventImpl::GetRecycledCount() - recycled);
+
     Simulator::Destroy();
 
 } // BenchSuite::Run
@@ -457,6 +463,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -466,6 +473,7 @@ main(int argc, char* argv[])
     uint64_t runs = 1;
     std::string filename = "";
     bool calRev = false;
+    bool pool = true;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
@@ -482,9 +490,11 @@ main(int argc, char* argv[])
     cmd.AddValue("cal", "use CalendarSheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListSheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
+    cmd.AddValue("pool", "reuse the memory of executed events", pool);
     cmd.AddValue("debug", "enable debugging output", g_debug);
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
@@ -501,14 +511,17 @@ main(int argc, char* argv[])
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
     LOG("  Number of runs per scheduler: " << runs);
+    LOG("  Event memory reuse:           " << (pool ? "on" : "off"));
     DEB("debugging is ON");
 
+    EventImpl::EnablePool(pool);
+
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
@@ -532,6 +545,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::HeapScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+    }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
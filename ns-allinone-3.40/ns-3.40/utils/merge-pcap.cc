@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program merges pcap files, e.g. the files written by the ranks of a
+// distributed simulation, into a single file whose packets are ordered by
+// time.  Packets with the same time are written in the order of the input
+// files.  All the files must have the same data link type; the files of the
+// devices of a link, or the files of a whole run on a same kind of link, can
+// be merged together.
+// Sample usage:  ./ns3 run 'merge-pcap --output=link.pcap dist-0-1.pcap dist-1-1.pcap'
+
+#include "ns3/command-line.h"
+#include "ns3/pcap-file.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <stdlib.h> // for exit ()
+#include <tuple>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * An input file and its next packet.
+ */
+struct MergeInput
+{
+    PcapFile file;             //!< The file
+    std::vector<uint8_t> data; //!< The data of the next packet
+    uint32_t inclLen{0};       //!< The length of the data of the next packet
+    uint32_t origLen{0};       //!< The original length of the next packet
+    uint64_t time{0};          //!< The time of the next packet, in nanoseconds
+    bool nanosecMode{false};   //!< Whether the timestamps are in nanoseconds
+
+    /**
+     * Read the next packet of the file.
+     *
+     * \returns false at the end of the file
+     */
+    bool Next()
+    {
+        uint32_t tsSec;
+        uint32_t tsUsec;
+        uint32_t readLen;
+        file.Read(data.data(), data.size(), tsSec, tsUsec, inclLen, origLen, readLen);
+        if (file.Fail())
+        {
+            return false;
+        }
+        time = tsSec * 1000000000ULL + (nanosecMode ? tsUsec : tsUsec * 1000ULL);
+        return true;
+    }
+};
+
+int
+main(int argc, char* argv[])
+{
+    std::string output = "merged.pcap";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Merge pcap files into a single file ordered by time.\n"
+              "The input files are given after the options.");
+    cmd.AddValue("output", "name of the merged file", output);
+    cmd.Parse(argc, argv);
+
+    std::vector<std::unique_ptr<MergeInput>> inputs;
+    bool nanosecMode = false;
+    uint32_t snapLen = 0;
+    for (std::size_t i = 0; i < cmd.GetNExtraNonOptions(); i++)
+    {
+        std::string filename = cmd.GetExtraNonOption(i);
+        auto input = std::make_unique<MergeInput>();
+        input->file.Open(filename, std::ios::in);
+        if (input->file.Fail())
+        {
+            std::cerr << "Error-- unable to read " << filename << std::endl;
+            exit(1);
+        }
+        if (!inputs.empty() &&
+            input->file.GetDataLinkType() != inputs.front()->file.GetDataLinkType())
+        {
+            std::cerr << "Error-- " << filename << " has data link type "
+                      << input->file.GetDataLinkType() << " instead of "
+                      << inputs.front()->file.GetDataLinkType() << std::endl;
+            exit(1);
+        }
+        input->nanosecMode = input->file.IsNanoSecMode();
+        input->data.resize(input->file.GetSnapLen());
+        nanosecMode |= input->nanosecMode;
+        snapLen = std::max(snapLen, input->file.GetSnapLen());
+        inputs.push_back(std::move(input));
+    }
+    if (inputs.empty())
+    {
+        std::cerr << "Error-- no input file" << std::endl;
+        exit(1);
+    }
+
+    PcapFile merged;
+    merged.Open(output, std::ios::out);
+    if (merged.Fail())
+    {
+        std::cerr << "Error-- unable to write " << output << std::endl;
+        exit(1);
+    }
+    merged.Init(inputs.front()->file.GetDataLinkType(),
+                snapLen,
+                inputs.front()->file.GetTimeZoneOffset(),
+                false,
+                nanosecMode);
+
+    // The next packet of each input, ordered by time and then by input.
+    using Next = std::tuple<uint64_t, std::size_t>;
+    std::priority_queue<Next, std::vector<Next>, std::greater<Next>> next;
+    for (std::size_t i = 0; i < inputs.size(); i++)
+    {
+        if (inputs[i]->Next())
+        {
+            next.emplace(inputs[i]->time, i);
+        }
+    }
+
+    uint64_t packets = 0;
+    uint64_t divisor = nanosecMode ? 1 : 1000;
+    uint64_t perSecond = 1000000000 / divisor;
+    while (!next.empty())
+    {
+        std::size_t i = std::get<1>(next.top());
+        MergeInput& input = *inputs[i];
+        next.pop();
+        uint64_t time = input.time / divisor;
+        merged.Write(time / perSecond,
+                     time % perSecond,
+                     input.data.data(),
+                     input.inclLen,
+                     input.origLen);
+        packets++;
+        if (input.Next())
+        {
+            next.emplace(input.time, i);
+        }
+    }
+    merged.Close();
+
+    std::cout << "Merged " << packets << " packets of " << inputs.size() << " files into "
+              << output << std::endl;
+    return 0;
+}